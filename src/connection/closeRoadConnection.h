@@ -328,4 +328,10 @@ int closeRoadConnection(vector<geometry> &geo, double x1, double y1, double phi1
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+// the short names would replace identifiers in all files included afterwards
+#undef p
+#undef n
+#undef o
+#undef i
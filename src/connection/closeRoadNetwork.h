@@ -17,49 +17,40 @@
 
 #include "closeRoadConnection.h"
 
-extern settings setting;
+extern thread_local settings setting;
 
 /**
  * @brief function closes roads by adding new road structures
  * 
- * @param doc 	tree structure which contains the input data
+ * @param input 	input model which contains the input data
  * @param data 	roadNetwork structure generated by this tool
  * @return int 	error code
  */
-int closeRoadNetwork(xmlTree &doc, roadNetwork &data)
+int closeRoadNetwork(const inputModel &input, roadNetwork &data)
 {
 	if(!setting.silentMode)
 		cout << "Processing closeRoadNetwork" << endl;
 
-	DOMElement* closeRoad; 
-	
-
-	if (doc.findNodeWithName("closeRoads",closeRoad))
+	if (!input.hasCloseRoads)
 	{
 		throwWarning("'closeRoadNetwork' is not specified in input file.\n\t -> skip closing", true);
 		return 0;
 	}
 
 	// assumption is that all segments are already linked
-
-	//for (pugi::xml_node segmentLink : closeRoad.children("segmentLink"))
-	for (DOMElement *segmentLink = closeRoad->getFirstElementChild();segmentLink != NULL; segmentLink = segmentLink->getNextElementSibling())
+	for (const segmentLinkInput &segmentLink : input.closeRoads)
 	{
-		if(readNameFromNode(segmentLink) != "segmentLink") continue;
-
 		road rConnection;
 		data.nSegment++;
 		rConnection.id = data.nSegment * 100 + 1;
 
 
-		int fromSegment = readIntAttrFromNode(segmentLink, "fromSegment");
-		int toSegment = readIntAttrFromNode(segmentLink, "toSegment");
-		int fromRoadId = readIntAttrFromNode(segmentLink, "fromRoad");
-		int toRoadId = readIntAttrFromNode(segmentLink, "toRoad");
-		string fromPos = readStrAttrFromNode(segmentLink, "fromPos");
-		string toPos = readStrAttrFromNode(segmentLink, "toPos");
-		road fromRoad;
-		road toRoad;
+		int fromSegment = segmentLink.fromSegment;
+		int toSegment = segmentLink.toSegment;
+		int fromRoadId = segmentLink.fromRoad;
+		int toRoadId = segmentLink.toRoad;
+		string fromPos = segmentLink.fromPos;
+		string toPos = segmentLink.toPos;
 
 
 
@@ -68,28 +59,20 @@ int closeRoadNetwork(xmlTree &doc, roadNetwork &data)
 		laneSection lS1, lS2;
 		bool found;
 
-		// check if fromSegment is junction
-		bool fromIsJunction = false;
-		for (auto &&j : data.junctions)
-			if (j.id == fromSegment)
-				fromIsJunction = true;
-
-		// check if toSegment is junction
-		bool toIsJunction = false;
-		for (auto &&j : data.junctions)
-			if (j.id == toSegment)
-				toIsJunction = true;
+		// check if the segments are junctions
+		bool fromIsJunction = isJunction(data, fromSegment);
+		bool toIsJunction = isJunction(data, toSegment);
 
 		// save from position
 		found = false;
-		for (auto &&r : data.roads)
+		for (int k : roadsOfSegment(data, fromSegment))
 		{
-			if (r.junction != fromSegment || r.inputId != fromRoadId)
+			road &r = data.roads[k];
+			if (r.inputId != fromRoadId)
 				continue;
 			if (fromIsJunction && r.inputPos != fromPos)
 				continue;
 
-			fromRoad = r;
 			fromRoadId = r.id;
 			found = true;
 
@@ -110,11 +93,11 @@ int closeRoadNetwork(xmlTree &doc, roadNetwork &data)
 			}
 			else if (fromPos == "end")
 			{
-				geometry g = r.geometries.back();
-				curve(g.length, g, g.x, g.y, g.hdg, 1);
+				const geometry &g = r.geometries.back();
 				fromX = g.x;
 				fromY = g.y;
 				fromHdg = g.hdg;
+				endOfRoad(r, fromX, fromY, fromHdg);
 				r.successor.id = rConnection.id;
 				r.successor.contactPoint = startType;
 				rConnection.predecessor.id = fromRoadId;
@@ -136,14 +119,14 @@ int closeRoadNetwork(xmlTree &doc, roadNetwork &data)
 
 		// save to position
 		found = false;
-		for (auto &&r : data.roads)
+		for (int k : roadsOfSegment(data, toSegment))
 		{
-			if (r.junction != toSegment || r.inputId != toRoadId)
+			road &r = data.roads[k];
+			if (r.inputId != toRoadId)
 				continue;
 			if (toIsJunction && r.inputPos != toPos)
 				continue;
 
-			toRoad = r;
 			toRoadId = r.id;
 			found = true;
 
@@ -164,11 +147,11 @@ int closeRoadNetwork(xmlTree &doc, roadNetwork &data)
 			}
 			else if (toPos == "end")
 			{
-				geometry g = r.geometries.back();
+				const geometry &g = r.geometries.back();
 				toX = g.x;
 				toY = g.y;
 				toHdg = g.hdg;
-				curve(g.length, g, toX, toY, toHdg, 1);
+				endOfRoad(r, toX, toY, toHdg);
 				r.successor.id = rConnection.id;
 				r.successor.contactPoint = endType;
 				rConnection.successor.id = r.id;
@@ -281,9 +264,8 @@ int closeRoadNetwork(xmlTree &doc, roadNetwork &data)
 			secs.back().lanes[j] = curLane;
 		}
 
-		road tmpRoad;
-		int fr = findRoad(data.roads, tmpRoad, fromRoadId);
-		int tr = findRoad(data.roads, tmpRoad, toRoadId);
+		int fr = findRoad(data, fromRoadId);
+		int tr = findRoad(data, toRoadId);
 
 		// --- add lane links --------------------------------------------------
 		for (int j = 0; j < secs.front().lanes.size(); j++)
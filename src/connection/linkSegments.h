@@ -15,8 +15,141 @@
  *
  */
 
-#include<map>
 #include<queue>
+#include<unordered_set>
+
+/**
+ * @brief edge of the segment link graph
+ * 
+ */
+struct segmentEdge
+{
+	int target;			// vertex of the linked segment
+	const segmentLinkInput *link;	// first segmentLink in the input which connects the two segments
+};
+
+/**
+ * @brief graph of all segment links. Every segment is a vertex, the outgoing and incoming edges of each vertex are
+ * stored in compressed rows: the edges of vertex v are [offset[v], offset[v+1]) in the order of the input file
+ * 
+ */
+struct segmentGraph
+{
+	vector<int> segments;				// vertex -> segment id
+	unordered_map<int, int> vertices;	// segment id -> vertex
+
+	vector<int> outOffset;
+	vector<segmentEdge> outEdges;
+	vector<int> inOffset;
+	vector<segmentEdge> inEdges;
+
+	int vertex(int segment)
+	{
+		auto res = vertices.emplace(segment, (int)segments.size());
+		if (res.second)
+			segments.push_back(segment);
+		return res.first->second;
+	}
+};
+
+/**
+ * @brief function parses all segment links once and builds the segment link graph. Duplicated links between two segments are ignored
+ * 
+ * @param links 	links of the input file, the reference segment is always vertex 0
+ * @param graph 	resulting graph
+ * @return int 		error code
+ */
+int buildSegmentGraph(const linksInput &links, segmentGraph &graph)
+{
+	graph.vertex(links.refId);
+
+	vector<int> from, to;
+	vector<const segmentLinkInput*> link;
+	unordered_map<long long, int> known;
+
+	for (const segmentLinkInput &segmentLink : links.segmentLinks)
+	{
+		int fromVertex = graph.vertex(segmentLink.fromSegment);
+		int toVertex = graph.vertex(segmentLink.toSegment);
+
+		long long key = ((long long)fromVertex << 32) | (unsigned int)toVertex;
+		if (!known.emplace(key, (int)link.size()).second)
+			continue;
+
+		from.push_back(fromVertex);
+		to.push_back(toVertex);
+		link.push_back(&segmentLink);
+	}
+
+	// counting sort of the edges by source (outgoing) and target (incoming), stable in input order
+	int nV = graph.segments.size();
+	graph.outOffset.assign(nV + 1, 0);
+	graph.inOffset.assign(nV + 1, 0);
+	for (size_t k = 0; k < link.size(); k++)
+	{
+		graph.outOffset[from[k] + 1]++;
+		graph.inOffset[to[k] + 1]++;
+	}
+	for (int v = 0; v < nV; v++)
+	{
+		graph.outOffset[v + 1] += graph.outOffset[v];
+		graph.inOffset[v + 1] += graph.inOffset[v];
+	}
+
+	graph.outEdges.resize(link.size());
+	graph.inEdges.resize(link.size());
+	vector<int> outPos(graph.outOffset.begin(), graph.outOffset.end() - 1);
+	vector<int> inPos(graph.inOffset.begin(), graph.inOffset.end() - 1);
+	for (size_t k = 0; k < link.size(); k++)
+	{
+		graph.outEdges[outPos[from[k]]++] = {to[k], link[k]};
+		graph.inEdges[inPos[to[k]]++] = {from[k], link[k]};
+	}
+
+	return 0;
+}
+
+/**
+ * @brief function labels the connected components of the segment link graph, the link direction is ignored
+ * 
+ * @param graph 		segment link graph
+ * @param component 	component of every vertex
+ * @return int 			number of components
+ */
+int segmentComponents(const segmentGraph &graph, vector<int> &component)
+{
+	int nV = graph.segments.size();
+	component.assign(nV, -1);
+
+	int nComponents = 0;
+	vector<int> stack;
+	for (int v = 0; v < nV; v++)
+	{
+		if (component[v] != -1) continue;
+
+		component[v] = nComponents;
+		stack.push_back(v);
+		while (!stack.empty())
+		{
+			int cur = stack.back();
+			stack.pop_back();
+			for (int k = graph.outOffset[cur]; k < graph.outOffset[cur + 1]; k++)
+			{
+				if (component[graph.outEdges[k].target] != -1) continue;
+				component[graph.outEdges[k].target] = nComponents;
+				stack.push_back(graph.outEdges[k].target);
+			}
+			for (int k = graph.inOffset[cur]; k < graph.inOffset[cur + 1]; k++)
+			{
+				if (component[graph.inEdges[k].target] != -1) continue;
+				component[graph.inEdges[k].target] = nComponents;
+				stack.push_back(graph.inEdges[k].target);
+			}
+		}
+		nComponents++;
+	}
+	return nComponents;
+}
 
 
 /**
@@ -27,28 +160,27 @@
  * @param swap if true the from and toSegment and road are swapped
  * @return int error code
  */
-int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
+int transformRoad(const segmentLinkInput &segmentLink, roadNetwork &data, bool swap = false)
 {
 
 	// get properties
 	
-	int fromSegment = readIntAttrFromNode(segmentLink, "fromSegment");
-	int toSegment = readIntAttrFromNode(segmentLink, "toSegment");
-	int fromRoadId = readIntAttrFromNode(segmentLink, "fromRoad");
-	int toRoadId = readIntAttrFromNode(segmentLink, "toRoad");
-	string fromPos = readStrAttrFromNode(segmentLink, "fromPos");
-	string toPos = readStrAttrFromNode(segmentLink, "toPos");
+	int fromSegment = segmentLink.fromSegment;
+	int toSegment = segmentLink.toSegment;
+	int fromRoadId = segmentLink.fromRoad;
+	int toRoadId = segmentLink.toRoad;
+	string fromPos = segmentLink.fromPos;
+	string toPos = segmentLink.toPos;
 	if(swap) 
 	{
-		fromSegment = readIntAttrFromNode(segmentLink, "toSegment");
-		toSegment = readIntAttrFromNode(segmentLink, "fromSegment");
-		fromRoadId = readIntAttrFromNode(segmentLink, "toRoad");
-		toRoadId = readIntAttrFromNode(segmentLink, "fromRoad");
-		fromPos = readStrAttrFromNode(segmentLink, "toPos");
-		toPos = readStrAttrFromNode(segmentLink, "fromPos");
+		fromSegment = segmentLink.toSegment;
+		toSegment = segmentLink.fromSegment;
+		fromRoadId = segmentLink.toRoad;
+		toRoadId = segmentLink.fromRoad;
+		fromPos = segmentLink.toPos;
+		toPos = segmentLink.fromPos;
 	}
-	road fromRoad;
-	road toRoad;
+	const road *toRoad = NULL;
 
 
 
@@ -61,49 +193,24 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 	bool fromIsJunction 	= false;
 	bool toIsJunction 		= false;
 
-	// check if fromSegment is junction
-	for (auto &&j : data.junctions)
-		if (j.id == fromSegment)
-			fromIsJunction = true;
-
-	// check if toSegment is junction
-	for (auto &&j : data.junctions)
-		if (j.id == toSegment)
-			toIsJunction = true;
-
-	
+	// check if the segments are junctions
+	fromIsJunction = isJunction(data, fromSegment);
+	toIsJunction = isJunction(data, toSegment);
 
 	/*check if either one of the segments is a roundabout*/
-
-	for(junctionGroup &jg: data.juncGroups)
-	{
-		if(jg.type != roundaboutType) continue;
-
-		if(toSegment == jg.id)
-		{
-			toIsRoundabout = true;
-
-		}
-		if(fromSegment == jg.id)
-		{
-			fromIsRoundabout= true;
-
-		}
-		
-	}
-	//-------------------END roundabout namespace fix---------------------------------
+	fromIsRoundabout = isRoundabout(data, fromSegment);
+	toIsRoundabout = isRoundabout(data, toSegment);
 
 	// save from position
-	for (auto &&r : data.roads)
+	for (int k : roadsOfInputSegment(data, fromSegment))
 	{
-			
-		if (r.inputSegmentId != fromSegment || r.inputId != fromRoadId)
+		road &r = data.roads[k];
+		if (r.inputId != fromRoadId)
 			continue;
 		if (fromIsJunction && r.inputPos != fromPos)
 			continue;
 
 
-		fromRoad = r;
 		fromRoadId = r.id;
 		// if junction, the contact point is always at "end" of a road
 		if (fromIsJunction || fromIsRoundabout)
@@ -124,24 +231,25 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 		}
 		else if (fromPos == "end")
 		{
-			geometry g = r.geometries.back();
-			curve(g.length, g, g.x, g.y, g.hdg, 1);
+			const geometry &g = r.geometries.back();
 			fromX = g.x;
 			fromY = g.y;
 			fromHdg = g.hdg;
+			endOfRoad(r, fromX, fromY, fromHdg);
 		}
 	}
 
 	// save to position
-	for (auto &&r : data.roads)
+	for (int k : roadsOfSegment(data, toSegment))
 	{
-		if (r.junction != toSegment || r.inputId != toRoadId) 
+		road &r = data.roads[k];
+		if (r.inputId != toRoadId) 
 			continue;
 		if (toIsJunction && r.inputPos != toPos)
 		{
 			continue;
 		}
-		toRoad = r;
+		toRoad = &r;
 		toRoadId = r.id;
 
 
@@ -163,11 +271,11 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 		}
 		else if (toPos == "end")
 		{
-			geometry g = r.geometries.back();
+			const geometry &g = r.geometries.back();
 			toX = g.x;
 			toY = g.y;
 			toHdg = g.hdg;
-			curve(g.length, g, toX, toY, toHdg, 1);
+			endOfRoad(r, toX, toY, toHdg);
 		}
 	}
 
@@ -185,16 +293,16 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 	// if toPos is end, the actual toPos has to be computed
 	if (toPos == "end")
 	{
-		if(toRoad.id == -1){
+		if(toRoad == NULL){
 			std::cerr << "ERR: 'Road linking is wrong!'" << std::endl;
 			std::cerr << "    couldn't find toSegment " << toSegment << " or toRoadID " << toRoadId << std::endl;
 			return -1;
 		}
-		geometry g = toRoad.geometries.back();
+		const geometry &g = toRoad->geometries.back();
 		toX = g.x * cos(dPhi) - g.y * sin(dPhi);
 		toY = g.x * sin(dPhi) + g.y * cos(dPhi);
 		toHdg = g.hdg + dPhi;
-		curve(g.length, g, toX, toY, toHdg, 1);
+		endOfRoad(*toRoad, toX, toY, toHdg);
 	}
 
 	// compute x / y offset between the two segments
@@ -202,13 +310,14 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 	dy = fromY - toY;
 
 	// shift all geometries which belong to the toSegment according two the offsets determined above
-	for (auto &&r : data.roads)
-	{
-		if (r.junction != toSegment && r.roundAboutInputSegment != toSegment)
-			continue;
-		
+	vector<int> shifted = roadsOfSegment(data, toSegment);
+	for (int k : roadsOfRoundAboutSegment(data, toSegment))
+		if (data.roads[k].junction != toSegment)
+			shifted.push_back(k);
 
-		for (auto &&g : r.geometries)
+	for (int k : shifted)
+	{
+		for (auto &&g : data.roads[k].geometries)
 		{
 			double x = g.x * cos(dPhi) - g.y * sin(dPhi);
 			double y = g.x * sin(dPhi) + g.y * cos(dPhi);
@@ -220,167 +329,262 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 		}
 	}
 
-	for (auto &&r : data.roads)
+	for (int k : roadsWithId(data, toRoadId))
+	{
+		data.roads[k].predecessor.id = fromRoadId;
+		data.roads[k].predecessor.contactPoint = (fromPos == "start") ? startType : endType;
+	}
+	for (int k : roadsWithId(data, fromRoadId))
 	{
-		if (r.id == toRoadId){
-			r.predecessor.id = fromRoadId;
-			r.predecessor.contactPoint = (fromPos == "start") ? startType : endType;
+		data.roads[k].successor.id = toRoadId;
+		data.roads[k].successor.contactPoint = (toPos == "start") ? startType : endType;
+	}
+
+	return 0;
+}
+
+extern thread_local settings setting;
+
+/**
+ * @brief single call of transformRoad during the linking
+ * 
+ */
+struct linkCall
+{
+	const segmentLinkInput *link;
+	bool swap;
+	int fromSegment;	// segment which is already linked
+	int toSegment;		// segment which is transformed
+};
+
+/**
+ * @brief function determines the order in which the segments are transformed by a breadth first search starting at the reference segment (vertex 0).
+ * The order only depends on the links, not on the generated roads
+ * 
+ * @param graph 	segment link graph
+ * @param calls 	resulting transformRoad calls in the order of execution
+ */
+void linkOrder(const segmentGraph &graph, vector<linkCall> &calls)
+{
+	queue<int> toDo = queue<int>();
+	vector<bool> transformed(graph.segments.size(), false);
+	toDo.push(0);
+
+	while(!toDo.empty())
+	{
+		int cur = toDo.front();
+		toDo.pop();
+		if(transformed[cur]) continue;
+
+		for(int k = graph.outOffset[cur]; k < graph.outOffset[cur + 1]; k++)
+		{
+			const segmentEdge &e = graph.outEdges[k];
+			if(transformed[e.target]) continue;
+
+			calls.push_back({e.link, false, e.link->fromSegment, e.link->toSegment});
+			toDo.push(e.target);
 		}
-		
-		if (r.id == fromRoadId){
-			r.successor.id = toRoadId;
-			r.successor.contactPoint = (toPos == "start") ? startType : endType;
+		transformed[cur] = true;
+
+		for(int k = graph.inOffset[cur]; k < graph.inOffset[cur + 1]; k++)
+		{
+			const segmentEdge &e = graph.inEdges[k];
+			if(transformed[e.target]) continue;
+
+			calls.push_back({e.link, true, e.link->toSegment, e.link->fromSegment});
+			toDo.push(e.target);
 		}
 	}
-	//mark every road that belongs to the from- or toSegment as linked
-	for(auto &r: data.roads)
+}
+
+/**
+ * @brief function transforms the geometries of the reference segment into the reference system
+ * 
+ * @param links 	links of the input file
+ * @param data 		roadNetwork structure generated by the tool
+ */
+void transformReference(const linksInput &links, roadNetwork &data)
+{
+	double hdgOffset = links.hdgOffset;
+	double xOffset = links.xOffset;
+	double yOffset = links.yOffset;
+
+	for (int k : roadsOfSegment(data, links.refId))
 	{
-		if(r.junction == toSegment || r.roundAboutInputSegment == toSegment || r.junction == fromSegment || r.roundAboutInputSegment == fromSegment)
+		for (auto &&g : data.roads[k].geometries)
 		{
-			r.isLinkedToNetwork = true;
+			double x = g.x * cos(hdgOffset) - g.y * sin(hdgOffset);
+			double y = g.x * sin(hdgOffset) + g.y * cos(hdgOffset);
+
+			g.x = x + xOffset;
+			g.y = y + yOffset;
+			g.hdg = g.hdg + hdgOffset;
 		}
-		if(r.inputId == toSegment || r.inputId == toSegment)
+	}
+}
+
+/**
+ * @brief function checks if all roads are connected to the network: a road is linked if its segment is in the component of the reference segment
+ * 
+ * @param graph 	segment link graph
+ * @param data 		roadNetwork structure generated by the tool
+ */
+void checkLinked(segmentGraph &graph, roadNetwork &data)
+{
+	vector<int> component;
+	int nComponents = segmentComponents(graph, component);
+
+	vector<int> unlinked;
+	for (auto &&r : data.roads)
+	{
+		int segment = (r.roundAboutInputSegment != -1) ? r.roundAboutInputSegment : r.junction;
+
+		// segments without any link form a component of their own
+		int v = graph.vertex(segment);
+		if (v == (int)component.size())
+			component.push_back(nComponents++);
+
+		r.isLinkedToNetwork = (component[v] == component[0]);
+		if (!r.isLinkedToNetwork && !isIn(unlinked, segment))
+			unlinked.push_back(segment);
+	}
+	if(unlinked.size() > 0)
+	{
+		throwWarning("'Not all roads are connected to the road network!'");
+		if(!setting.silentMode)
+			cout << "\tThe segments form " << nComponents << " separate components" << endl;
+		std::cerr << "\tThe segments form " << nComponents << " separate components" << endl;
+		for(int segment: unlinked)
 		{
-			r.isLinkedToNetwork = true;
+			int c = component[graph.vertices[segment]];
+			if(!setting.silentMode)
+				cout << "\tSegment " << segment << " is not linked (component " << c << ")" << endl;
+			std::cerr << "\tSegment " << segment << " is not linked (component " << c << ")" << endl;
 		}
 	}
-	return 0;
 }
 
-extern settings setting;
-
 /**
  * @brief function links all specified segments 
  *  	the reference frame has to be specified
  * 		two segments can be linked by determine two contactpoints of the roads 
  * 
- * @param doc 	tree structure which contains the input data
+ * @param input 	input model which contains the input data
  * @param data 	roadNetwork structure generated by the tool
  * @return int 	error code
  */
-int linkSegments(xmlTree &inputxml, roadNetwork &data)
+int linkSegments(const inputModel &input, roadNetwork &data)
 {
 	if(!setting.silentMode)
 		cout << "Processing linkSegments" << endl;
 
 
-	DOMElement *links;
-	if (inputxml.findNodeWithName("links", links))
+	if (!input.hasLinks)
 	{
 		throwWarning("'links' are not specified in input file.\n\t -> skip segment linking", true);
 		return 0;
 	}
 
 	// define reference system
-	int refId = readIntAttrFromNode(links, "refId");
-	double hdgOffset = readDoubleAttrFromNode(links, "hdgOffset");
-	double xOffset = readDoubleAttrFromNode(links, "xOffset");
-	double yOffset = readDoubleAttrFromNode(links, "yOffset");
+	transformReference(input.links, data);
 
+	// parse all links once
+	segmentGraph graph;
+	buildSegmentGraph(input.links, graph);
 
-	for (auto &&r : data.roads)
-	{
-		if (r.junction != refId)
-			continue;
+	vector<linkCall> calls;
+	linkOrder(graph, calls);
+	for (const linkCall &c : calls)
+		transformRoad(*c.link, data, c.swap);
 
-		for (auto &&g : r.geometries)
-		{
+	checkLinked(graph, data);
+	return 0;
+}
 
-			// transform geometries of reference segement into reference system
-			double x = g.x * cos(hdgOffset) - g.y * sin(hdgOffset);
-			double y = g.x * sin(hdgOffset) + g.y * cos(hdgOffset);
+/**
+ * @brief function links all specified segments and reuses the linked roads of the previous run for segments which are not affected by a change.
+ * 	A segment has to be transformed again if it was rebuilt, if it is linked to such a segment or if its road links are changed by such a link
+ * 
+ * @param input 	input model which contains the input data
+ * @param data 		roadNetwork structure generated by buildSegmentsIncremental
+ * @param previous 	results of the previous run
+ * @param segments 	per segment results of buildSegmentsIncremental, the linked roads are stored
+ * @return int 		error code
+ */
+int linkSegmentsIncremental(const inputModel &input, roadNetwork &data, const incrementalState &previous, vector<segmentState> &segments)
+{
+	if(!setting.silentMode)
+		cout << "Processing linkSegments" << endl;
 
-			g.x = x + xOffset;
-			g.y = y + yOffset;
-			g.hdg = g.hdg + hdgOffset;
-		}
+	if (!input.hasLinks)
+	{
+		throwWarning("'links' are not specified in input file.\n\t -> skip segment linking", true);
 	}
-
-	//generate a map to store all the outgoing links of each segment
-	std::map<int, vector<int>> outgoing_connections;
-	std::map<int, vector<int>> incoming_connections;
-
-	for (DOMElement *segmentLink = links->getFirstElementChild();segmentLink != NULL; segmentLink = segmentLink->getNextElementSibling())
+	else
 	{
-		int fromSegment = readIntAttrFromNode(segmentLink, "fromSegment");
-		int toSegment = readIntAttrFromNode(segmentLink, "toSegment");
+		segmentGraph graph;
+		buildSegmentGraph(input.links, graph);
 
-		if(!isIn(outgoing_connections[fromSegment], toSegment))
-			outgoing_connections[fromSegment].push_back(toSegment);
+		vector<linkCall> calls;
+		linkOrder(graph, calls);
 
-		if(!isIn(incoming_connections[toSegment], fromSegment))
-			incoming_connections[toSegment].push_back(fromSegment);
+		// --- determine the segments which have to be transformed again ------------
+		bool reuse = previous.valid && previous.linksKey == linksKey(input);
 
-	}
-
-	queue<int> toDo = queue<int>();
-	vector<int> transformedIds;
-	toDo.push(refId);
+		unordered_set<int> dirty;
+		for (const segmentState &s : segments)
+			if (!reuse || s.rebuilt || s.linkedRoads.size() != s.roads.size())
+				dirty.insert(s.id);
 
-	while(!toDo.empty())
-	{
-		int curId = toDo.front();
-		toDo.pop();
-		if(isIn(transformedIds, curId)) continue;
-
-		//first find the element in the list. skip if it is the ref element 
+		unordered_map<int, size_t> lastTouch;
+		for (size_t i = 0; i < calls.size(); i++)
+		{
+			lastTouch[calls[i].fromSegment] = i;
+			lastTouch[calls[i].toSegment] = i;
+		}
 
-		for(int e:  outgoing_connections[curId])
+		bool changed = true;
+		while (changed)
 		{
-			if(isIn(transformedIds, e)) continue;
-		
-			for (DOMElement *segmentLink = links->getFirstElementChild();segmentLink != NULL; segmentLink = segmentLink->getNextElementSibling())
+			changed = false;
+			for (size_t i = 0; i < calls.size(); i++)
 			{
-				if(curId != readIntAttrFromNode(segmentLink, "fromSegment") || e != readIntAttrFromNode(segmentLink, "toSegment")) continue;
-				//process the element------------------
-				transformRoad(segmentLink, data);
-				//end processessing the element--------
-				break; //prevents multiple processing steps if they are defined in the xml (they shoudlnt be)
-
+				const linkCall &c = calls[i];
+				bool fromDirty = dirty.count(c.fromSegment) > 0;
+				bool toDirty = dirty.count(c.toSegment) > 0;
+
+				// the position of the to segment depends on the from segment
+				if (fromDirty && !toDirty)
+				{
+					dirty.insert(c.toSegment);
+					changed = true;
+				}
+				// the road links of the from segment are overwritten by a later call
+				else if (toDirty && !fromDirty && lastTouch[c.fromSegment] > i)
+				{
+					dirty.insert(c.fromSegment);
+					changed = true;
+				}
 			}
-			toDo.push(e);
-
 		}
-		transformedIds.push_back(curId);
 
-		for(int incoming_id : incoming_connections[curId])
-		{
-			if(isIn(transformedIds, incoming_id)) continue;
+		// --- restore clean segments and transform the dirty ones -----------------
+		for (const segmentState &s : segments)
+			if (dirty.count(s.id) == 0)
+				copy(s.linkedRoads.begin(), s.linkedRoads.end(), data.roads.begin() + s.firstRoad);
 
-			for (DOMElement *segmentLink = links->getFirstElementChild(); segmentLink != NULL; segmentLink = segmentLink->getNextElementSibling())
-			{
-				if(curId != readIntAttrFromNode(segmentLink, "toSegment") || incoming_id != readIntAttrFromNode(segmentLink, "fromSegment")) continue;
-				//process the element------------------
-				transformRoad(segmentLink, data, true);
-				break; //prevents multiple processing steps if they are defined in the xml (they shoudlnt be)
+		if (dirty.count(input.links.refId) > 0)
+			transformReference(input.links, data);
 
-			}
-			toDo.push(incoming_id);
-		}
-	}
+		for (const linkCall &c : calls)
+			if (dirty.count(c.toSegment) > 0)
+				transformRoad(*c.link, data, c.swap);
 
-	//check if all roads are connected to the network
-	vector<road*> v;
-	for(road r: data.roads)
-	{
-		if(!r.isLinkedToNetwork)
-		{
-			v.push_back(&r);
-		}
+		checkLinked(graph, data);
 	}
-	if(v.size() > 0)
-	{
-		throwWarning("'Not all roads are connected to the road network!'");
-		for(road* p: v)
-		{
-			if(!setting.silentMode)
-				cout << "\tRoad " << p->inputSegmentId << " is not linked"<< endl;
-			std::cerr << "\tRoad " << p->inputSegmentId << " is not linked"<< endl;
-		}
 
+	for (segmentState &s : segments)
+		s.linkedRoads.assign(data.roads.begin() + s.firstRoad, data.roads.begin() + s.firstRoad + s.roads.size());
 
-	}
 	return 0;
 }
-
-
@@ -22,12 +22,26 @@ const char *HELP_MESSAGE =
   "\nRoad Generation \n\n"
   "Usage: \n"
   "    road-generation <fileName>       Generates a .xodr file from input file.\n"
+  "    road-generation -j <threads> <fileName|fileDir>...\n"
+  "                                     Generates all input files and directories in batch mode.\n"
+  "    road-generation -v <variants> <templateName>\n"
+  "                                     Generates seeded variants of a template with a vars node.\n"
   "\nOptions:\n"
   "    -h                               Display help message.\n"
   "    -s                               Disable console output.\n"
   "    -d <fileDir>                     Specify output file directory.\n"
   "    -o <fileName>                    Specify output file name.\n"
-  "    -k                               Keep logfile. Log will be overwritten if this is not set.\n\n";
+  "    -k                               Keep logfile. Log will be overwritten if this is not set.\n"
+  "    -n                               Skip the validation of the output file.\n"
+  "    -w                               Use the streaming writer for the output file.\n"
+  "    -b                               Write a binary snapshot of the network next to the output file.\n"
+  "    -t                               Write the times and metrics of the run next to the output file.\n"
+  "    -c <cacheDir>                    Reuse and store generated outputs in the cache directory.\n"
+  "    -j <threads>                     Number of worker threads in batch mode (0 uses all cores).\n"
+  "    -p <threads>                     Number of worker threads which build the segments of a file (0 uses all cores).\n"
+  "    -r <fileName>                    Specify the summary file of the batch mode (default: summary.csv).\n"
+  "    -v <variants>                    Number of variants generated from a template.\n"
+  "    -x <seed>                        Seed of the variation mode (default: 0).\n\n";
 
 
 /**
@@ -85,6 +99,76 @@ int parseArgs(int argc, char **argv, settingsExec &settings) {
                     settings.overwriteLog = false;
                 break;
 
+                case 'n':
+                    settings.outputValidation = false;
+                break;
+
+                case 'w':
+                    settings.streamingWriter = true;
+                break;
+
+                case 'b':
+                    settings.snapshot = true;
+                break;
+
+                case 't':
+                    settings.profiling = true;
+                break;
+
+                case 'c':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.cacheDirectory = argv[++i];
+                break;
+
+                case 'j':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.threads = atoi(argv[++i]);
+                    settings.batchMode = true;
+                break;
+
+                case 'p':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.segmentThreads = atoi(argv[++i]);
+                break;
+
+                case 'r':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.summaryFile = argv[++i];
+                    settings.batchMode = true;
+                break;
+
+                case 'v':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.variants = atoi(argv[++i]);
+                    if(settings.variants <= 0){
+                        std::cout <<"ERR: number of variants has to be positive!" << std::endl;
+                        return -1;
+                    }
+                break;
+
+                case 'x':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.seed = strtoul(argv[++i], NULL, 10);
+                break;
+
                 default:
                     std::cout << "ERR: invalid arguments!" << std::endl;
                     return -1;
@@ -93,6 +177,7 @@ int parseArgs(int argc, char **argv, settingsExec &settings) {
         else{
             foundFile = true;
             settings.fileName = argv[i];
+            settings.inputs.push_back(argv[i]);
         }
     }
 
@@ -101,6 +186,18 @@ int parseArgs(int argc, char **argv, settingsExec &settings) {
         return -1;
     }
 
+    if(settings.variants > 0 && settings.inputs.size() > 1){
+        std::cout << "ERR: only one template can be varied!" << std::endl;
+        return -1;
+    }
+
+    if(settings.inputs.size() > 1) settings.batchMode = true;
+
+    if(settings.batchMode && settings.variants == 0 && setOutputName){
+        std::cout << "ERR: output name can not be set in batch mode!" << std::endl;
+        return -1;
+    }
+
     if(!setOutputName) settings.outputName = settings.fileName;
     
 
@@ -11,12 +11,9 @@
 #define EXPORT_H
 
 #include<string>
+#include<stddef.h>
 
-
-char* _fileName;
-char* _outName;
-std::string _logfile = "log.txt";
-
+typedef struct generatorContext generatorContext;
 
 extern "C" void setFileName(char* file);
 extern "C" void setLogFile(char* file);
@@ -26,6 +23,44 @@ extern "C" void setOutputName(char* file);
 extern "C" void setSilentMode(bool sMode);
 extern "C" void setXMLSchemeLocation(char* file);
 extern "C" void setOverwriteLog(bool b);
+extern "C" void setOutputValidation(bool b);
+extern "C" void setStreamingWriter(bool b);
+extern "C" void setSnapshot(bool b);
+extern "C" void setProfiling(bool b);
+extern "C" void setCacheDirectory(char* dir);
+extern "C" void setIncremental(bool b);
+extern "C" void setSegmentThreads(int n);
+extern "C" long long getCacheHits();
+extern "C" long long getCacheMisses();
+extern "C" void resetCacheStatistics();
+
+extern "C" generatorContext* createContext();
+extern "C" void destroyContext(generatorContext* ctx);
+extern "C" void contextSetFileName(generatorContext* ctx, const char* file);
+extern "C" void contextSetOutputName(generatorContext* ctx, const char* file);
+extern "C" void contextSetXMLSchemeLocation(generatorContext* ctx, const char* file);
+extern "C" void contextSetLogFile(generatorContext* ctx, const char* file);
+extern "C" void contextSetSilentMode(generatorContext* ctx, bool sMode);
+extern "C" void contextSetOverwriteLog(generatorContext* ctx, bool b);
+extern "C" void contextSetOutputValidation(generatorContext* ctx, bool b);
+extern "C" void contextSetStreamingWriter(generatorContext* ctx, bool b);
+extern "C" void contextSetSnapshot(generatorContext* ctx, bool b);
+extern "C" void contextSetProfiling(generatorContext* ctx, bool b);
+extern "C" void contextSetCacheDirectory(generatorContext* ctx, const char* dir);
+extern "C" void contextSetIncremental(generatorContext* ctx, bool b);
+extern "C" void contextSetSegmentThreads(generatorContext* ctx, int n);
+extern "C" int contextExecPipeline(generatorContext* ctx);
+extern "C" int contextGetWarnings(generatorContext* ctx);
+extern "C" int contextExecPipelineToBuffer(generatorContext* ctx, char** buffer, size_t* size);
+extern "C" int execPipelineToBuffer(char** buffer, size_t* size);
+extern "C" void freeBuffer(char* buffer);
+extern "C" int convertSnapshot(const char* snapshotFile, const char* outName);
+extern "C" int contextExecBatch(generatorContext* ctx, const char** files, int nFiles, int nThreads, const char* summaryFile);
+extern "C" int contextExecBatchDir(generatorContext* ctx, const char* dir, int nThreads, const char* summaryFile);
+extern "C" int executeBatch(const char** files, int nFiles, int nThreads, const char* summaryFile);
+extern "C" int executeBatchDir(const char* dir, int nThreads, const char* summaryFile);
+extern "C" int contextExecVariation(generatorContext* ctx, const char* templateFile, int nVariants, unsigned int seed, int nThreads, const char* summaryFile);
+extern "C" int executeVariation(const char* templateFile, int nVariants, unsigned int seed, int nThreads, const char* summaryFile);
 
 
 #endif
@@ -19,6 +19,7 @@
 #include "helperExec.h"
 #include "settingsExec.h"
 #include <string>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -39,14 +40,50 @@ int main(int argc, char** argv){
         return -1;
     }
 
-    setFileName(settings.fileName);
-    setXMLSchemeLocation(&schemeLocation[0]);
-    setOverwriteLog(settings.overwriteLog);
-    setOutputName(settings.outputName);
-    setSilentMode(settings.silentMode);
-    execPipeline();
+    generatorContext* ctx = createContext();
+    contextSetXMLSchemeLocation(ctx, schemeLocation.c_str());
+    contextSetOverwriteLog(ctx, settings.overwriteLog);
+    contextSetSilentMode(ctx, settings.silentMode);
+    contextSetOutputValidation(ctx, settings.outputValidation);
+    contextSetStreamingWriter(ctx, settings.streamingWriter);
+    contextSetSnapshot(ctx, settings.snapshot);
+    contextSetProfiling(ctx, settings.profiling);
+    contextSetCacheDirectory(ctx, settings.cacheDirectory);
+    contextSetSegmentThreads(ctx, settings.segmentThreads);
 
-    return 0;
+    // variation mode: the variants are named after the output name
+    if (settings.variants > 0)
+    {
+        contextSetOutputName(ctx, settings.outputName);
+        int nFailed = contextExecVariation(ctx, settings.fileName, settings.variants, settings.seed, settings.threads, settings.summaryFile);
+        destroyContext(ctx);
+        return (nFailed == 0) ? 0 : -1;
+    }
+
+    if (!settings.batchMode)
+    {
+        contextSetFileName(ctx, settings.fileName);
+        contextSetOutputName(ctx, settings.outputName);
+        contextExecPipeline(ctx);
+        destroyContext(ctx);
+        return 0;
+    }
+
+    // batch mode: a single directory is generated completely, otherwise all inputs have to be files
+    struct stat info;
+    int nFailed;
+    if (settings.inputs.size() == 1 && stat(settings.inputs.front(), &info) == 0 && (info.st_mode & S_IFDIR))
+    {
+        nFailed = contextExecBatchDir(ctx, settings.inputs.front(), settings.threads, settings.summaryFile);
+    }
+    else
+    {
+        vector<const char*> files(settings.inputs.begin(), settings.inputs.end());
+        nFailed = contextExecBatch(ctx, files.data(), (int)files.size(), settings.threads, settings.summaryFile);
+    }
+    destroyContext(ctx);
+
+    return (nFailed == 0) ? 0 : -1;
 }
 
 
@@ -25,6 +25,22 @@ struct settingsExec{
     char* outputName;
     bool silentMode = false;
     bool overwriteLog = true;
+    bool outputValidation = true;
+    bool streamingWriter = false;
+    bool snapshot = false;
+    bool profiling = false;
+    const char* cacheDirectory = NULL; // NULL disables the output cache
+    int segmentThreads = 1; // worker threads which build the segments of a file
+
+    // batch mode
+    std::vector<char*> inputs; // all input files and directories
+    bool batchMode = false;
+    int threads = 0; // 0 uses all available cores
+    const char* summaryFile = "summary.csv";
+
+    // variation mode
+    int variants = 0; // 0 disables the variation mode
+    unsigned int seed = 0;
 
 };
 
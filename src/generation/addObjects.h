@@ -270,131 +270,93 @@ int addBusStop(object o, road &r)
     return 0;
 }
 
-/**
- * @brief function gets the object position
- * 
- * @param node      object input data
- * @param o         object data
- * @return int      error code
- */
-int getPosition(DOMElement* node, object &o)
-{
-    // read position of objects in st coordinates
-    if (getChildWithName(node, "relativePosition") != NULL)
-    {
-        DOMElement* position = getChildWithName(node, "relativePosition");
-        o.s = readDoubleAttrFromNode(position, "s");
-        o.t = readDoubleAttrFromNode(position, "t");
-        o.hdg = readDoubleAttrFromNode(position, "hdg");
-    }
-    if (getChildWithName(node, "repeatPosition") != NULL)
-    {
-       DOMElement* position = getChildWithName(node, "repeatPosition");
-        o.s = readDoubleAttrFromNode(position, "s");
-        o.t = readDoubleAttrFromNode(position, "t");
-        o.hdg = readDoubleAttrFromNode(position, "hdg");
-
-        o.repeat = true;
-        o.len = readDoubleAttrFromNode(position, "length");
-    }
-
-    return 0;
-}
-
 /**
  * @brief function creates objects
  * 
- * @param inRoad    road input data from input file
+ * @param objects   objects of the road from the input file
  * @param r         road data 
  * @param data      roadNetwork structure where the generated roads and junctions are stored
  * @return int      error code
  */
-int addObjects(DOMElement* inRoad, road &r, roadNetwork &data)
+int addObjects(const vector<objectInput> &objects, road &r, roadNetwork &data)
 {
-
-    DOMNodeList* objects = inRoad->getElementsByTagName(X("objects"));
-    for (int i = 0; i < objects->getLength(); i++)
+    for (const objectInput &in : objects)
     {
-        DOMElement* obj = (DOMElement*)objects->item(i);
-        if(obj->getNodeType() != 1) continue;
+        //--- Traffic Rule -----------------------------------------------------
+        if (in.type == "trafficRule")
+        {
+            control c;
+            c.id = in.id;
+
+            for (const signalInput &sig : in.signals)
+            {
+                sign s;
+                data.nSignal++;
+                s.id = data.nSignal;
+                s.id = sig.id;
+                s.type = sig.type;
+                s.value = sig.value;
+                s.dynamic = sig.dynamic;
+                s.s = sig.s;
+                s.t = sig.t;
+                s.z = sig.z;
+
+                r.signs.push_back(s);
+
+                if (s.dynamic)
+                    c.signs.push_back(s);
+            }
+            data.controller.push_back(c);
+            continue;
+        }
 
-        std::string type = readNameFromNode(obj);
         object o;
+        o.id = in.id;
 
-        o.id = readDoubleAttrFromNode(obj, "id");
-
-        // save position in object
-        getPosition(obj, o);
+        // position in st coordinates
+        o.s = in.s;
+        o.t = in.t;
+        o.hdg = in.hdg;
+        o.repeat = in.repeat;
+        o.len = in.len;
 
         // --- consider different object cases ---------------------------------
-        if (type == "parkingSpace")
+        if (in.type == "parkingSpace")
         {
-            o.type = type;
-            o.length = readDoubleAttrFromNode(obj, "length");
-            o.width = readDoubleAttrFromNode(obj, "width");
+            o.type = in.type;
+            o.length = in.length;
+            o.width = in.width;
             o.height = 4;
 
             addParking(o, r);
         }
 
-        if (type == "streetLamp")
+        if (in.type == "streetLamp")
         {
-            o.type = type;
+            o.type = in.type;
             o.distance = 20;
             r.objects.push_back(o);
         }
 
-        if (type == "roadWork")
+        if (in.type == "roadWork")
         {
-            o.s = readDoubleAttrFromNode(obj, "s");
-            o.len = readDoubleAttrFromNode(obj, "length");
-            int laneId = readIntAttrFromNode(obj, "laneId");
-
-            addRoadWork(o, r, laneId);
+            addRoadWork(o, r, in.laneId);
         }
 
-        if (type == "busStop")
+        if (in.type == "busStop")
         {
             addBusStop(o, r);
         }
 
-        if (type == "trafficIsland")
+        if (in.type == "trafficIsland")
         {
-            o.type = type;
-            o.s = readDoubleAttrFromNode(obj, "s");
+            o.type = in.type;
             o.t = 0;
-            o.length = readDoubleAttrFromNode(obj, "length");
-            o.width = readDoubleAttrFromNode(obj, "width");
+            o.length = in.length;
+            o.width = in.width;
 
             addTrafficIsland(o, r);
         }
-
-        //--- Traffic Rule -----------------------------------------------------
-        if (type != "trafficRule")
-            continue;
-
-        control c;
-        c.id = readIntAttrFromNode(obj, "id");
-
-        for (DOMElement* ob = obj->getFirstElementChild(); ob != NULL ;ob = ob->getNextElementSibling())
-        {
-            sign s;
-            data.nSignal++;
-            s.id = data.nSignal;
-            s.id = readIntAttrFromNode(ob, "id");
-            s.type = readStrAttrFromNode(ob, "type");
-            s.value = readDoubleAttrFromNode(ob, "value");
-            s.dynamic = readBoolAttrFromNode(ob, "dynamic");
-            s.s = readDoubleAttrFromNode(getChildWithName(ob, "relativePosition"), "s");
-            s.t = readDoubleAttrFromNode(getChildWithName(ob, "relativePosition"), "t");
-            s.z = readDoubleAttrFromNode(getChildWithName(ob, "relativePosition"), "z");
-
-            r.signs.push_back(s);
-
-            if (s.dynamic)
-                c.signs.push_back(s);
-        }
-        data.controller.push_back(c);
     }
     return 0;
 }
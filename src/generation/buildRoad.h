@@ -18,7 +18,7 @@
 #include "../utils/curve.h"
 #include "addLaneSections.h"
 
-extern settings setting;
+extern thread_local settings setting;
 
 /**
  * @brief function computes first and last considered geometry in s interval 
@@ -30,23 +30,15 @@ extern settings setting;
  * @param sEnd          end of the s interval
  * @return int          error code
  */
-int computeFirstLast(DOMElement* roadIn, int &foundfirst, int &foundlast, double &sStart, double &sEnd)
+int computeFirstLast(const roadInput* roadIn, int &foundfirst, int &foundlast, double &sStart, double &sEnd)
 {
     int cc = 0;
     double s = 0;
 
     if (roadIn != NULL) {
-        DOMNodeList* referenceLines = getChildWithName(roadIn, "referenceLine")->getChildNodes();
-
-        for (int i = 0; i < referenceLines->getLength(); i++)
+        for (const geometryInput &it : roadIn->referenceLine)
         {
-            DOMElement* it = (DOMElement*)referenceLines->item(i);
-            if(it->getNodeType() != 1) //1 is an Element Node https://xerces.apache.org/xerces-c/apiDocs-3/classDOMNode.html
-            {
-                continue;
-            }
-
-            double length = readDoubleAttrFromNode(it, "length");
+            double length = it.length;
 
             if (s + length > sStart && foundfirst == -1)
                 foundfirst = cc;
@@ -79,7 +71,7 @@ int computeFirstLast(DOMElement* roadIn, int &foundfirst, int &foundlast, double
  * @param sEnd      end of the s interval
  * @return int      error code
  */
-int generateGeometries(DOMElement* roadIn, road &r, double &sStart, double &sEnd)
+int generateGeometries(const roadInput* roadIn, road &r, double &sStart, double &sEnd)
 {
     // search first and last relevant geometry
     int foundfirst = -1;
@@ -97,33 +89,19 @@ int generateGeometries(DOMElement* roadIn, road &r, double &sStart, double &sEnd
 
     if(roadIn == NULL) return 0;
 
-    DOMNodeList* referenceLines =  getChildWithName(roadIn, "referenceLine")->getChildNodes();
-    for (int i = 0; i < referenceLines->getLength(); i++)
+    for (const geometryInput &it : roadIn->referenceLine)
     {
-        DOMElement* it = (DOMElement*)referenceLines->item(i);
-        if(it->getNodeType() != 1) continue;
-        
-        geometryType type;
+        geometryType type = it.type;
         double c = 0, c1 = 0, c2 = 0;
         double R = 0, R1 = 0, R2 = 0;
 
-        // define type
-        if (readNameFromNode(it) == "line")
-            type = line;
-        if (readNameFromNode(it) == "spiral")
-            type = spiral;
-        if (readNameFromNode(it) == "arc")
-            type = arc;
-        if (readNameFromNode(it) == "circle")
-            type = arc;
-
-        double length = readDoubleAttrFromNode(it, "length");
+        double length = it.length;
 
         // define radi and curvatures
         if (type == spiral)
         {
-            R1 = readDoubleAttrFromNode(it, "Rs");
-            R2 = readDoubleAttrFromNode(it, "Re");
+            R1 = it.Rs;
+            R2 = it.Re;
             if (R1 != 0)
                 c1 = 1 / R1;
             if (R2 != 0)
@@ -131,7 +109,7 @@ int generateGeometries(DOMElement* roadIn, road &r, double &sStart, double &sEnd
         }
         if (type == arc)
         {
-            R = readDoubleAttrFromNode(it, "R");
+            R = it.R;
             if (R != 0)
                 c = 1 / R;
         }
@@ -274,20 +252,16 @@ int shiftGeometries(road &r, double sStart, double sEnd, double s0, double x0, d
 
     if (Case == 0 || Case == 2)
     {
-        for (int i = r.geometries.size() - 1; i >= 0; i--)
+        int i = findGeometry(r.geometries, s0);
+        if (i >= 0)
         {
-            geometry g = r.geometries[i];
-
-            if (s0 >= g.s)
-            {
-                x = g.x;
-                y = g.y;
-                hdg = g.hdg;
-                curve(s0 - sStart - g.s, g, x, y, hdg, 1);
+            const geometry &g = r.geometries[i];
+            x = g.x;
+            y = g.y;
+            hdg = g.hdg;
+            curve(s0 - sStart - g.s, g, x, y, hdg, 1);
 
-                dphi = phi0 - hdg;
-                break;
-            }
+            dphi = phi0 - hdg;
         }
     }
     else if (Case == 1)
@@ -386,7 +360,7 @@ int flipGeometries(road &r)
  * @param mode      defines the mode (flipped or not)
  * @return int      error code
  */
-int addLanes(DOMElement* roadIn, road &r, int mode)
+int addLanes(const roadInput* roadIn, road &r, int mode)
 {
     double desWidth = setting.width.standard;
     double desSpeed = setting.speed.standard;
@@ -435,71 +409,55 @@ int addLanes(DOMElement* roadIn, road &r, int mode)
     // --- add user defined laneSection to road --------------------------------
     if (roadIn != NULL)
     {
-        DOMElement* lanes = getChildWithName(roadIn, "lanes");
-
-        if(lanes != NULL)
+        for (const laneInput &itt : roadIn->lanes)
         {
-            for (DOMElement *itt = lanes->getFirstElementChild();itt != NULL; itt = itt->getNextElementSibling())
+            lane l;
+            l.id = itt.id;
+            l.preId = l.id;
+            l.sucId = l.id;
+
+            // flip lanes for mode 1
+            if (mode == 2)
+                l.id *= -1;
+
+            if (!itt.type.empty())
+                l.type = itt.type;
+
+            l.w.a = desWidth;
+            if (itt.hasWidth)
+                l.w.a = itt.width;
+            if (l.id == 0)
+                l.w.a = 0.0;
+
+            l.speed = desSpeed;
+            if (itt.hasSpeed)
+                l.speed = itt.speed;
+
+            if (!itt.markType.empty())
+                l.rm.type = itt.markType;
+            if (!itt.markColor.empty())
+                l.rm.color = itt.markColor;
+            if (itt.hasMarkWidth)
+                l.rm.width = itt.markWidth;
+
+            if (!itt.surface.empty())
+                l.m.surface = itt.surface;
+            if (itt.hasFriction)
+                l.m.friction = itt.friction;
+            if (itt.hasRoughness)
+                l.m.roughness = itt.roughness;
+
+            lane tmp;
+            int id = findLane(laneSec, tmp, l.id);
+            if (id >= 0)
+                laneSec.lanes[id] = l;
+            else
+                laneSec.lanes.push_back(l);
+
+            if (l.type == "delete")
             {
-                if (readNameFromNode(itt) != "lane")
-                    continue;
-
-                lane l;
-                l.id = readIntAttrFromNode(itt, "id");
-                l.preId = l.id;
-                l.sucId = l.id;
-
-                // flip lanes for mode 1
-                if (mode == 2)
-                    l.id *= -1;
-
-                if (!readStrAttrFromNode(itt, "type").empty())
-                    l.type = readStrAttrFromNode(itt, "type");
-
-                l.w.a = desWidth;
-                if (!readStrAttrFromNode(itt, "width").empty())
-                    l.w.a = readDoubleAttrFromNode(itt, "width");
-                if (l.id == 0)
-                    l.w.a = 0.0;
-
-                l.speed = desSpeed;
-                if (!readStrAttrFromNode(itt, "speed").empty())
-                    l.speed = readDoubleAttrFromNode(itt, "speed");
-
-                DOMElement* rm = getChildWithName(itt, "roadMark");
-                if (rm)
-                {
-                    if (!readStrAttrFromNode(rm, "type").empty())
-                        l.rm.type = readStrAttrFromNode(rm, "type");
-                    if (!readStrAttrFromNode(rm, "color").empty())
-                        l.rm.color = readStrAttrFromNode(rm, "color");
-                    if (!readStrAttrFromNode(rm, "width").empty())
-                        l.rm.width = readDoubleAttrFromNode(rm, "width");
-                }
-
-                DOMElement* m = getChildWithName(itt,"material");
-                if (m)
-                {
-                    if (!readStrAttrFromNode(m, "surface").empty())
-                        l.m.surface = readStrAttrFromNode(m, "surface");
-                    if (!readStrAttrFromNode(m, "friction").empty())
-                        l.m.friction = readDoubleAttrFromNode(m, "friction");
-                    if (!readStrAttrFromNode(m, "roughness").empty())
-                        l.m.roughness = readDoubleAttrFromNode(m, "roughness");
-                }
-
-                lane tmp;
-                int id = findLane(laneSec, tmp, l.id);
-                if (id >= 0)
-                    laneSec.lanes[id] = l;
-                else
-                    laneSec.lanes.push_back(l);
-
-                if (l.type == "delete")
-                {
-                    int id = findLane(laneSec, l, l.id);
-                    laneSec.lanes.erase(laneSec.lanes.begin() + id);
-                }
+                int id = findLane(laneSec, l, l.id);
+                laneSec.lanes.erase(laneSec.lanes.begin() + id);
             }
         }
     }
@@ -516,103 +474,61 @@ int addLanes(DOMElement* roadIn, road &r, int mode)
  * @param automaticWidening     automatic widing input data
  * @return int                  error code
  */
-int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWidening)
+int addLaneSectionChanges(const roadInput* roadIn, road &r, const automaticWideningInput* automaticWidening)
 {
     // --- user defined lanedrops or lanewidenings -----------------------------
     //      -> have to be defined in increasing s order, because the lane changes are concatenated in s direction
 
     if(roadIn == NULL) return 0; //leave if the road is null. might cause errros 
 
-    DOMNodeList* referenceLines = roadIn->getElementsByTagName(X("lanes"));
-    for (int i = 0; i < referenceLines->getLength(); i++)
+    for (const laneChangeInput &itt : roadIn->laneChanges)
     {
-        
-        DOMElement* lane = (DOMElement*)referenceLines->item(i);  
-        if(lane->getNodeType() != 1) continue;
-        
-        for(DOMElement* itt = lane->getFirstElementChild(); itt != NULL; itt = itt->getNextElementSibling())//this contains either lanedrops or lanewidening 
+        if (itt.side == 0)
+        {
+            cerr << "ERR: laneWidening with side = 0" << endl;
+            return 1;
+        }
+
+        double ds = setting.laneChange.ds;
+        if (itt.hasLength)
+            ds = itt.length;
+
+        // only perform drop if on road length
+        if (itt.s > r.length)
+            continue;
+
+        double ds2 = setting.laneChange.ds;
+        if (itt.hasRestrictedLength)
+            ds2 = itt.restrictedLength;
+
+        if (itt.widening)
         {
-            if(itt->getNodeType() != 1) continue;
+            if (addLaneWidening(r.laneSections, itt.side, itt.s, ds, false))
+            {
+                cerr << "ERR: error in addLaneWidening";
+                return 1;
+            }
 
-            if (readNameFromNode(itt) == "laneWidening")
+            //restricted area
+            if (itt.restrictedArea && addRestrictedAreaWidening(r.laneSections, itt.side, itt.s, ds, ds2))
             {
-                int side = readIntAttrFromNode(itt, "side");
-
-                if (side == 0)
-                {
-                    cerr << "ERR: laneWidening with side = 0" << endl;
-                    return 1;
-                }
-
-                double s = readDoubleAttrFromNode(itt, "s");
-
-                double ds = setting.laneChange.ds;
-                if (attributeExits(itt,"length"))
-                    ds = readDoubleAttrFromNode(itt, "length");
-
-                // only perform drop if on road length
-                if (s > r.length)
-                    continue;
-
-                if (addLaneWidening(r.laneSections, side, s, ds, false))
-                {
-                    cerr << "ERR: error in addLaneWidening";
-                    return 1;
-                }
-
-                //restricted area
-                if (getChildWithName(itt, "restrictedArea") != NULL)
-                {
-                    double ds2 = setting.laneChange.ds;
-                    if (attributeExits(getChildWithName(itt, "restrictedArea"),"length"))
-                        ds2 = readIntAttrFromNode(getChildWithName(itt, "restrictedArea"),"length");
-
-                    if (addRestrictedAreaWidening(r.laneSections, side, s, ds, ds2))
-                    {
-                        cerr << "ERR: error in addRestrictedAreaWidening" << endl;
-                        return 1;
-                    }
-                }
+                cerr << "ERR: error in addRestrictedAreaWidening" << endl;
+                return 1;
             }
-            if (readNameFromNode(itt) == "laneDrop")
+        }
+        else
+        {
+            if (addLaneDrop(r.laneSections, itt.side, itt.s, ds))
             {
-                int side = readIntAttrFromNode(itt, "side");
-
-                if (side == 0)
-                {
-                    cerr << "ERR: laneWidening with side = 0" << endl;
-                    return 1;
-                }
-
-                double s =  readDoubleAttrFromNode(itt, "s");
-
-                double ds = setting.laneChange.ds;
-                if (attributeExits(itt, "length"))
-                    ds =  readDoubleAttrFromNode(itt, "length");
-
-                // only perform drop if on road length
-                if (s > r.length)
-                    continue;
-
-                if (addLaneDrop(r.laneSections, side, s, ds))
-                {
-                    cerr << "ERR: error in addLaneDrop";
-                    return 1;
-                }
-
-                //restricted area
-                if (getChildWithName(itt, "restrictedArea") != NULL)
-                {
-                    double ds2 = setting.laneChange.ds;
-                    if (attributeExits(getChildWithName(itt, "restrictedArea"),"length"))
-                        ds2 = readIntAttrFromNode(getChildWithName(itt, "restrictedArea"),"length");
-
-                    if (addRestrictedAreaDrop(r.laneSections, side, s, ds, ds2))
-                    {
-                        cerr << "ERR: error in addRestrictedAreaDrop";
-                        return 1;
-                    }
-                }
+                cerr << "ERR: error in addLaneDrop";
+                return 1;
+            }
+
+            //restricted area
+            if (itt.restrictedArea && addRestrictedAreaDrop(r.laneSections, itt.side, itt.s, ds, ds2))
+            {
+                cerr << "ERR: error in addRestrictedAreaDrop";
+                return 1;
             }
         }
     }
@@ -625,20 +541,18 @@ int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWide
 
     if (automaticWidening != NULL)
     {
-        if (attributeExits(automaticWidening,"active"))
+        if (automaticWidening->hasActive)
         {
-            active = readStrAttrFromNode(automaticWidening, "active");
+            active = automaticWidening->active;
 
-            if (attributeExits(automaticWidening,"length"))
-                widening_s = readDoubleAttrFromNode(automaticWidening, "length");
+            if (automaticWidening->hasLength)
+                widening_s = automaticWidening->length;
 
-            if (attributeExits(automaticWidening,"ds"))
-                widening_ds = readDoubleAttrFromNode(automaticWidening, "ds");
+            if (automaticWidening->hasDs)
+                widening_ds = automaticWidening->ds;
         }
 
-        bool restricted = false;
-        if (readBoolAttrFromNode(automaticWidening, "restricted"))
-            restricted = true;
+        bool restricted = automaticWidening->restricted;
 
         if (active == "all")
         {
@@ -683,12 +597,15 @@ int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWide
  * @param phi0              reference angle
  * @return int              error code
  */
-int buildRoad(DOMElement* roadIn, road &r, double sStart, double sEnd, DOMElement* automaticWidening, double s0, double x0, double y0, double phi0)
+int buildRoad(const roadInput* roadIn, road &r, double sStart, double sEnd, const automaticWideningInput* automaticWidening, double s0, double x0, double y0, double phi0)
 {
     
+    r.inputId = -1;
     if(roadIn != NULL)
-        r.classification = readStrAttrFromNode(roadIn,"classification");
-    r.inputId = readIntAttrFromNode(roadIn, "id", true);
+    {
+        r.classification = roadIn->classification;
+        r.inputId = roadIn->id;
+    }
 
     // save geometry data from sStart - sEnd
     // mode = 1 -> in s direction
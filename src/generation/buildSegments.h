@@ -27,64 +27,305 @@
 #include "junctionWrapper.h"
 #include "roundAbout.h"
 #include "connectingRoad.h"
+#include "junctionCache.h"
+
+#include <atomic>
+#include <thread>
+
+extern thread_local settings setting;
 
-extern settings setting;
 /**
- * @brief function creates all segments which can be either a junction, roundabout or connectingroad
+ * @brief function creates a single segment which can be either a junction, roundabout or connectingroad
  * 
- * @param inputxml 	tree structure which contains the input data
+ * @param em 	segment input data
  * @param data 	roadNetwork data where the openDrive structure should be generated
+ * @param cache 	if set, junctions and roundabouts with the same input are generated once and copied afterwards
+ * @param profile 	if set, the time of the segment is added to its segment type
  * @return int 	error code
  */
-int buildSegments(xmlTree &inputxml, roadNetwork &data)
+int buildSegment(const segmentInput &em, roadNetwork &data, junctionCache *cache = NULL, pipelineProfile *profile = NULL)
 {
+	profileMark mark = startProfile(profile);
 
-	DOMElement *roadNode;
-	if (inputxml.findNodeWithName("segments", roadNode))
+	string key;
+	if (cache != NULL)
+		key = junctionCacheKey(em);
+
+	if (!key.empty())
 	{
-		cerr << "ERR: 'segments' not found in input file." << endl;
-		cout << "ERR: 'segments' not found in input file." << endl;
-		return 1;
+		const segmentTemplate *t = cache->find(key);
+		if (t != NULL)
+		{
+			if(!setting.silentMode)
+				cout << "Processing " << ((em.kind == junctionSegment) ? "junction" : "roundabout") << " (copy of segment " << t->segment << ")" << endl;
+			instantiateTemplate(*t, em.id, data);
+			endSegment(profile, em, true, mark);
+			return 0;
+		}
 	}
 
-	DOMNodeList* segmentNodes = roadNode->getChildNodes();
+	size_t firstRoad = data.roads.size();
+	size_t firstJunction = data.junctions.size();
+	size_t firstJuncGroup = data.juncGroups.size();
+	size_t nControllers = data.controller.size();
+	int nSignal = data.nSignal;
+	int warnings = setting.warnings;
+
+	if (em.kind == junctionSegment)
+	{
+		if(!setting.silentMode)
+			cout << "Processing junction" << endl;
+		if (junctionWrapper(em, data))
+		{
+	    		cerr << "ERR: error in junction." << endl;
+				return 1;
+		}
+	}
 
+	if (em.kind == roundaboutSegment)
+	{	
+		if(!setting.silentMode)
+			cout << "Processing roundabout" << endl;
+		if (roundAbout(em, data))
+		{
+			cerr << "ERR: error in roundabout." << endl;
+			return 1;
+		}
+	}
 
-	for(DOMElement* em = roadNode->getFirstElementChild(); em != NULL ;em = em->getNextElementSibling())
+	if (em.kind == connectingRoadSegment)
 	{
-		if (readNameFromNode(em) == "junction")
+		if(!setting.silentMode)
+			cout << "Processing connectingRoad" << endl;
+		if (connectingRoad(em, data))
 		{
-			if(!setting.silentMode)
-				cout << "Processing junction" << endl;
-			if (junctionWrapper(em, data))
-			{
-		    		cerr << "ERR: error in junction." << endl;
-					return 1;
-			}
+			cerr << "ERR: error in connectingRoad." << endl;
+			return 1;
 		}
+	}
 
-		if (readNameFromNode(em) == "roundabout")
-		{	
-			if(!setting.silentMode)
-				cout << "Processing roundabout" << endl;
-			if (roundAbout(em, data))
-			{
-				cerr << "ERR: error in roundabout." << endl;
+	// segments with signals or warnings depend on the state of the network
+	if (!key.empty() && data.nSignal == nSignal && data.controller.size() == nControllers && setting.warnings == warnings)
+		storeTemplate(*cache, key, em, data, firstRoad, firstJunction, firstJuncGroup);
+
+	endSegment(profile, em, false, mark);
+	return 0;
+}
+
+/**
+ * @brief function checks if a segment depends on the segments before it. User-defined connecting lanes look up roads
+ * in the whole network and their ids depend on the number of roads
+ * 
+ * @param em 	segment input data
+ * @return true if the segment has to be built on the complete network
+ */
+bool dependsOnNetwork(const segmentInput &em)
+{
+	return em.kind == junctionSegment && em.coupler.hasConnection && em.coupler.connectionType == "single";
+}
+
+/**
+ * @brief function appends a partial network to the road network
+ * 
+ * @param data 	roadNetwork data
+ * @param part 	partial network of a single segment
+ */
+void mergeNetwork(roadNetwork &data, roadNetwork &part)
+{
+	data.roads.insert(data.roads.end(), make_move_iterator(part.roads.begin()), make_move_iterator(part.roads.end()));
+	data.junctions.insert(data.junctions.end(), make_move_iterator(part.junctions.begin()), make_move_iterator(part.junctions.end()));
+	data.juncGroups.insert(data.juncGroups.end(), part.juncGroups.begin(), part.juncGroups.end());
+	data.controller.insert(data.controller.end(), make_move_iterator(part.controller.begin()), make_move_iterator(part.controller.end()));
+	data.nSignal += part.nSignal;
+	data.nSegment += part.nSegment;
+}
+
+/**
+ * @brief function creates the segments [begin, end) concurrently. Every segment is built into its own partial network,
+ * the partial networks are appended in input order so that the result equals the serial run
+ * 
+ * @param input 	input model which contains the input data
+ * @param begin 	first segment
+ * @param end 		segment after the last segment
+ * @param data 		roadNetwork data where the openDrive structure should be generated
+ * @param cache 	junction cache shared by all workers
+ * @param nThreads 	number of worker threads
+ * @param profile 	if set, the times of the segments are added to their segment types and the cpu time of the workers to the run
+ * @return int 		error code
+ */
+int buildSegmentRange(const inputModel &input, size_t begin, size_t end, roadNetwork &data, junctionCache &cache, int nThreads, pipelineProfile *profile)
+{
+	size_t n = end - begin;
+	vector<roadNetwork> parts(n);
+	vector<int> status(n, 0);
+	std::atomic<size_t> next(0);
+	std::atomic<int> warnings(0);
+	const settings base = setting;
+
+	auto worker = [&]()
+	{
+		// every thread works on its own copy of the settings
+		setting = base;
+		setting.warnings = 0;
+		profileMark mark = startProfile(profile);
+
+		for (size_t k = next++; k < n; k = next++)
+			status[k] = buildSegment(input.segments[begin + k], parts[k], &cache, profile);
+
+		warnings += setting.warnings;
+		endWorker(profile, mark);
+	};
+
+	size_t nWorkers = min((size_t)nThreads, n);
+	vector<std::thread> pool;
+	for (size_t i = 0; i < nWorkers; i++)
+		pool.push_back(std::thread(worker));
+	for (std::thread &t : pool)
+		t.join();
+
+	setting.warnings += warnings;
+
+	for (size_t k = 0; k < n; k++)
+	{
+		if (status[k])
+			return 1;
+		mergeNetwork(data, parts[k]);
+	}
+	return 0;
+}
+
+/**
+ * @brief function creates all segments which can be either a junction, roundabout or connectingroad
+ * 
+ * @param input 	input model which contains the input data
+ * @param data 	roadNetwork data where the openDrive structure should be generated
+ * @param profile 	if set, the times of the segments are added to their segment types
+ * @return int 	error code
+ */
+int buildSegments(const inputModel &input, roadNetwork &data, pipelineProfile *profile = NULL)
+{
+	junctionCache cache;
+
+	int nThreads = setting.segmentThreads;
+	if (nThreads <= 0)
+		nThreads = max(1u, std::thread::hardware_concurrency());
+
+	size_t begin = 0;
+	while (begin < input.segments.size())
+	{
+		// runs of independent segments are built concurrently, the others on the complete network
+		size_t end = begin;
+		while (nThreads > 1 && end < input.segments.size() && !dependsOnNetwork(input.segments[end]))
+			end++;
+
+		if (end - begin > 1)
+		{
+			if (buildSegmentRange(input, begin, end, data, cache, nThreads, profile))
 				return 1;
-			}
+			begin = end;
+			continue;
+		}
+
+		if (buildSegment(input.segments[begin], data, &cache, profile))
+			return 1;
+		begin++;
+	}
+
+	if(!setting.silentMode && cache.hits > 0)
+		cout << "Copied " << cache.hits << " junction(s) and roundabout(s) with equal input" << endl;
+
+	return 0;
+}
+
+/**
+ * @brief function creates all segments and reuses the results of the previous run for unchanged segments.
+ * A segment is reused if its input model and the counters at its start are unchanged, so that the generated ids are equal
+ * 
+ * @param input 		input model which contains the input data
+ * @param data 			roadNetwork data where the openDrive structure should be generated
+ * @param previous 		results of the previous run
+ * @param segments 		resulting per segment results
+ * @param profile 		if set, the times of the rebuilt segments are added to their segment types
+ * @return int 			error code
+ */
+int buildSegmentsIncremental(const inputModel &input, roadNetwork &data, const incrementalState &previous, vector<segmentState> &segments,
+							 pipelineProfile *profile = NULL)
+{
+	unordered_map<int, const segmentState*> known;
+	if (previous.valid)
+		for (const segmentState &s : previous.segments)
+			known[s.id] = &s;
+
+	junctionCache cache;
+	segments.assign(input.segments.size(), segmentState());
+	int nRebuilt = 0;
+	bool changedBefore = false;	// an earlier segment has a new input
+
+	for (size_t i = 0; i < input.segments.size(); i++)
+	{
+		const segmentInput &em = input.segments[i];
+		segmentState &s = segments[i];
+
+		string key = segmentKey(em, true);
+
+		// --- reuse ---------------------------------------------------------------
+		unordered_map<int, const segmentState*>::iterator it = known.find(em.id);
+		const segmentState *old = (it != known.end()) ? it->second : NULL;
+
+		// user-defined connecting lanes of a junction can refer to roads of earlier segments
+		bool external = em.kind == junctionSegment && em.coupler.hasConnection && em.coupler.connectionType == "single";
+
+		if (old != NULL && !(external && changedBefore) && old->key == key && old->firstRoad == data.roads.size() && old->firstJunction == data.junctions.size()
+			&& old->firstJuncGroup == data.juncGroups.size() && old->nControllers == data.controller.size()
+			&& old->nSignal == data.nSignal && old->nSegment == data.nSegment
+			&& (old->addedSignals == 0 || equalControllers(old->controllersBefore, data.controller)))
+		{
+			s = *old;
+			s.rebuilt = false;
+
+			data.roads.insert(data.roads.end(), s.roads.begin(), s.roads.end());
+			data.junctions.insert(data.junctions.end(), s.junctions.begin(), s.junctions.end());
+			data.juncGroups.insert(data.juncGroups.end(), s.juncGroups.begin(), s.juncGroups.end());
+			data.nSignal += s.addedSignals;
+			data.nSegment += s.addedSegments;
+			if (s.addedSignals > 0)
+				data.controller = s.controllersAfter;
+			continue;
 		}
 
-		if (readNameFromNode(em) == "connectingRoad" )
+		// --- rebuild -------------------------------------------------------------
+		if (old == NULL || old->key != key)
+			changedBefore = true;
+
+		s.id = em.id;
+		s.key = key;
+		s.rebuilt = true;
+		s.firstRoad = data.roads.size();
+		s.firstJunction = data.junctions.size();
+		s.firstJuncGroup = data.juncGroups.size();
+		s.nControllers = data.controller.size();
+		s.nSignal = data.nSignal;
+		s.nSegment = data.nSegment;
+		vector<control> controllersBefore = data.controller;
+
+		if (buildSegment(em, data, &cache, profile))
+			return 1;
+
+		s.roads.assign(data.roads.begin() + s.firstRoad, data.roads.end());
+		s.junctions.assign(data.junctions.begin() + s.firstJunction, data.junctions.end());
+		s.juncGroups.assign(data.juncGroups.begin() + s.firstJuncGroup, data.juncGroups.end());
+		s.addedSignals = data.nSignal - s.nSignal;
+		s.addedSegments = data.nSegment - s.nSegment;
+		if (s.addedSignals > 0)
 		{
-			if(!setting.silentMode)
-				cout << "Processing connectingRoad" << endl;
-			if (connectingRoad(em, data))
-			{
-				cerr << "ERR: error in connectingRoad." << endl;
-				return 1;
-			}
+			s.controllersBefore.swap(controllersBefore);
+			s.controllersAfter = data.controller;
 		}
+		nRebuilt++;
 	}
 
+	if(!setting.silentMode)
+		cout << "Rebuilt " << nRebuilt << " of " << segments.size() << " segment(s)" << endl;
+
 	return 0;
-}
\ No newline at end of file
+}
@@ -15,7 +15,7 @@
  *
  */
 
-extern settings setting;
+extern thread_local settings setting;
 
 /**
  * @brief function generates the road for a connecting road which is specified in the input file
@@ -24,13 +24,13 @@ extern settings setting;
  * @param data  roadNetwork structure where the generated roads and junctions are stored
  * @return int  error code
  */
-int connectingRoad(DOMElement *node, roadNetwork &data)
+int connectingRoad(const segmentInput &node, roadNetwork &data)
 {
     // define segment
     data.nSegment++;
-    DOMElement* mainRoad = getChildWithName(node, "road");
+    const roadInput* mainRoad = node.roads.empty() ? NULL : &node.roads.front();
 
-    DOMElement* dummy = NULL;
+    automaticWideningInput* dummy = NULL;
 
     if (!mainRoad)
     {
@@ -43,22 +43,19 @@ int connectingRoad(DOMElement *node, roadNetwork &data)
         cout << "\t Generating Roads" << endl;
 
     road r;
-    int id = readIntAttrFromNode(mainRoad, "id");
-    r.id = 100 * readIntAttrFromNode(node, "id") + id;
-    r.inputSegmentId = readIntAttrFromNode(node, "id");
-    r.junction = readIntAttrFromNode(node, "id"); 
+    int id = mainRoad->id;
+    r.id = 100 * node.id + id;
+    r.inputSegmentId = node.id;
+    r.junction = node.id; 
     r.isConnectingRoad = true; // <- is needed to fix the bug that is caused by using junction attribute to store segment id in linking segments
     //r.junction = -1;
 
-
-    DOMElement* tmp = getChildWithName(node, "road");
-
     if (buildRoad(mainRoad, r, 0, INFINITY, dummy, 0, 0, 0, 0))
     {
         cerr << "ERR: error in buildRoad" << endl;
         return 1;
     }
-    if (addObjects(mainRoad, r, data))
+    if (addObjects(mainRoad->objects, r, data))
     {
         cerr << "ERR: error in addObjects" << endl;
         return 1;
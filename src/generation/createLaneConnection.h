@@ -15,7 +15,7 @@
  *
  */
 
-extern settings setting;
+extern thread_local settings setting;
 
 /**
  * @brief function creates a new lane for a connecting road
@@ -14,7 +14,7 @@
  * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
  *
  */
-extern settings setting;
+extern thread_local settings setting;
 /**
  * @brief function creates a new road connection 
  * 
@@ -28,7 +28,7 @@ extern settings setting;
  * @param laneMarkRight     right roadmarking
  * @return int              error code
  */
-int createRoadConnection(road r1, road r2, road &r, junction &junc, int fromId, int toId, string laneMarkLeft, string laneMarkRight)
+int createRoadConnection(const road &r1, const road &r2, road &r, junction &junc, int fromId, int toId, string laneMarkLeft, string laneMarkRight)
 {
     laneSection lS;
     if (r.laneSections.size() == 0)
@@ -70,7 +70,7 @@ int createRoadConnection(road r1, road r2, road &r, junction &junc, int fromId,
         y1 = g1.y;
         s1 = r1.length - lS1.s;
         hdg1 = g1.hdg;
-        curve(g1.length, g1, x1, y1, hdg1, 1);
+        endOfRoad(r1, x1, y1, hdg1);
 
         fixAngle(hdg1);
         g1.hdg = hdg1;
@@ -108,7 +108,7 @@ int createRoadConnection(road r1, road r2, road &r, junction &junc, int fromId,
         y2 = g2.y;
         s2 = r2.length - lS2.s;
         hdg2 = g2.hdg;
-        curve(g2.length, g2, x2, y2, hdg2, 1);
+        endOfRoad(r2, x2, y2, hdg2);
 
         g2.hdg = hdg2;
         fixAngle(g2.hdg);
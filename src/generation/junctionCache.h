@@ -0,0 +1,169 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file junctionCache.h
+ *
+ * @brief file contains the cache of generated junctions and roundabouts which are reused for segments with the same input
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include <unordered_set>
+#include <mutex>
+
+/**
+ * @brief generated roads, junctions and junction groups of a segment. The geometry of a segment is always generated
+ * in its local frame and placed by linkSegments, so only the ids depend on the segment
+ *
+ */
+struct segmentTemplate
+{
+    int segment = -1;       // segment id the template was generated for
+    int scale = 100;        // generated ids are scale * segment + local id
+    unordered_set<int> ids; // generated road and junction ids
+
+    vector<road> roads;
+    vector<junction> junctions;
+    vector<junctionGroup> juncGroups;
+};
+
+/**
+ * @brief cache of the segment templates of a single run, keyed on the input of the segment without its id.
+ * Templates are never removed, so a found template can be used after the lock is released
+ *
+ */
+struct junctionCache
+{
+    std::mutex mtx;
+    unordered_map<string, segmentTemplate> templates;
+    int hits = 0;
+
+    const segmentTemplate *find(const string &key)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        unordered_map<string, segmentTemplate>::const_iterator it = templates.find(key);
+        if (it == templates.end())
+            return NULL;
+        hits++;
+        return &it->second;
+    }
+};
+
+/**
+ * @brief function computes the key of a segment. Segments which refer to roads outside of the segment can not be cached
+ *
+ * @param em        segment input data
+ * @return string   key of the segment, empty if the segment can not be cached
+ */
+string junctionCacheKey(const segmentInput &em)
+{
+    if (em.kind == connectingRoadSegment)
+        return "";
+
+    // user-defined connecting lanes look up roads in the whole network and their ids depend on the number of roads
+    if (em.coupler.hasConnection && em.coupler.connectionType == "single")
+        return "";
+
+    return segmentKey(em, false);
+}
+
+/**
+ * @brief function maps an id of a template to the corresponding id of another segment
+ *
+ * @param t         segment template
+ * @param segment   id of the new segment
+ * @param id        id in the template
+ * @return int      id in the new segment
+ */
+int mapTemplateId(const segmentTemplate &t, int segment, int id)
+{
+    if (id == t.segment)
+        return segment;
+    if (t.ids.count(id) > 0)
+        return id + t.scale * (segment - t.segment);
+    return id;
+}
+
+/**
+ * @brief function stores the roads, junctions and junction groups which were generated for a segment as template
+ *
+ * @param cache         junction cache
+ * @param key           key of the segment
+ * @param em            segment input data
+ * @param data          roadNetwork data which contains the generated segment
+ * @param firstRoad     first road of the segment
+ * @param firstJunction first junction of the segment
+ * @param firstJuncGroup first junction group of the segment
+ */
+void storeTemplate(junctionCache &cache, const string &key, const segmentInput &em, const roadNetwork &data,
+                   size_t firstRoad, size_t firstJunction, size_t firstJuncGroup)
+{
+    segmentTemplate t;
+    t.segment = em.id;
+    t.scale = (em.kind == roundaboutSegment) ? 10000 : 100;
+    t.roads.assign(data.roads.begin() + firstRoad, data.roads.end());
+    t.junctions.assign(data.junctions.begin() + firstJunction, data.junctions.end());
+    t.juncGroups.assign(data.juncGroups.begin() + firstJuncGroup, data.juncGroups.end());
+
+    for (const road &r : t.roads)
+        t.ids.insert(r.id);
+    for (const junction &j : t.junctions)
+        t.ids.insert(j.id);
+
+    // the segment id has to be distinguishable from the generated ids
+    if (t.ids.count(em.id) > 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(cache.mtx);
+    cache.templates.emplace(key, std::move(t));
+}
+
+/**
+ * @brief function adds a template to the road network and assigns the ids of the segment
+ *
+ * @param t         segment template
+ * @param segment   id of the new segment
+ * @param data      roadNetwork data where the segment is added
+ */
+void instantiateTemplate(const segmentTemplate &t, int segment, roadNetwork &data)
+{
+    data.nSegment++;
+
+    for (road r : t.roads)
+    {
+        r.id = mapTemplateId(t, segment, r.id);
+        r.junction = mapTemplateId(t, segment, r.junction);
+        r.inputSegmentId = mapTemplateId(t, segment, r.inputSegmentId);
+        r.roundAboutInputSegment = mapTemplateId(t, segment, r.roundAboutInputSegment);
+        r.predecessor.id = mapTemplateId(t, segment, r.predecessor.id);
+        r.successor.id = mapTemplateId(t, segment, r.successor.id);
+        data.roads.push_back(r);
+    }
+
+    for (junction j : t.junctions)
+    {
+        j.id = mapTemplateId(t, segment, j.id);
+        for (connection &c : j.connections)
+        {
+            c.from = mapTemplateId(t, segment, c.from);
+            c.to = mapTemplateId(t, segment, c.to);
+        }
+        data.junctions.push_back(j);
+    }
+
+    for (junctionGroup jg : t.juncGroups)
+    {
+        jg.id = mapTemplateId(t, segment, jg.id);
+        jg.name = "jg" + to_string(jg.id);
+        for (int &id : jg.juncIds)
+            id = mapTemplateId(t, segment, id);
+        data.juncGroups.push_back(jg);
+    }
+}
@@ -25,10 +25,10 @@
  * @param data  roadNetwork structure where the generated roads and junctions are stored
  * @return int  error code
  */
-int junctionWrapper(const DOMElement* node, roadNetwork &data)
+int junctionWrapper(const segmentInput &node, roadNetwork &data)
 {   
 
-    std::string type = X(node->getAttributeNode(X("type"))->getValue());
+    std::string type = node.type;
 
     // check type of the junction (M = mainroad, A = accessroad)
     int mode = 0;
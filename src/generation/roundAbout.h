@@ -15,7 +15,7 @@
  *
  */
 
-extern settings setting;
+extern thread_local settings setting;
 
 
 /**
@@ -37,32 +37,44 @@ int juncGroupIdToJuncId(int juncGroupId, int juncIdx)
  * @param data  roadNetwork structure where the generated roads and junctions are stored
  * @return int  error code
  */
-int roundAbout(const DOMElement* node, roadNetwork &data)
+int roundAbout(const segmentInput &node, roadNetwork &data)
 {
     // create segment
     data.nSegment++;
     vector<junction> junctions;
     junctionGroup juncGroup;
 
-    juncGroup.id = readIntAttrFromNode(node, "id"); 
+    juncGroup.id = node.id; 
     juncGroup.name = "jg" + to_string(juncGroup.id);
 
-    int inputSegmentId = readIntAttrFromNode(node, "id");
+    int inputSegmentId = node.id;
 
-    DOMElement* dummy = NULL;
-    DOMElement* circleRoad = getChildWithName(node, "circle");
-    int refId = readIntAttrFromNode(circleRoad, "id");
+    automaticWideningInput* dummy = NULL;
 
-    if (!circleRoad)
+    if (!node.hasCircle)
     {
         cerr << "ERR: circleRoad is not found.";
         return 1;
     }
+    roadInput circle = node.circle;
+    roadInput* circleRoad = &circle;
+    int refId = circleRoad->id;
 
-    // store properties of circleRoad
-    double length = readDoubleAttrFromNode(getChildWithName(getChildWithName(circleRoad, "referenceLine"), "circle"),"length") ;
+    geometryInput* circleGeometry = NULL;
+    for (geometryInput &g : circleRoad->referenceLine)
+        if (g.circle && circleGeometry == NULL)
+            circleGeometry = &g;
+
+    if (!circleGeometry)
+    {
+        cerr << "ERR: circle of circleRoad is not found.";
+        return 1;
+    }
+
+    // store properties of circleRoad, the radius is rounded like a written xml attribute
+    double length = circleGeometry->length;
     double R = length / (2 * M_PI);
-    getChildWithName(getChildWithName(circleRoad, "referenceLine"), "circle")->setAttribute(X("R"), X(to_string(R).c_str()));
+    circleGeometry->R = stod(to_string(R));
     
 
     double sOld;
@@ -80,27 +92,16 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
     }
 
     // get coupler
-    DOMElement* cA = getChildWithName(getChildWithName(node, "coupler"), "junctionArea");
+    const couplerInput &cA = node.coupler;
 
     // count intersectionPoints
-    int nIp = 0;
-    for (DOMElement* child = node->getFirstElementChild(); child != NULL; child = child->getNextElementSibling())
-    {
-        if(readNameFromNode(child) == "intersectionPoint")
-        {
-            nIp++;
-        }
-    }
+    int nIp = node.intersectionPoints.size();
 
     //generate all junctions first for easier linking
     int cc = 0;
-    for (DOMElement* iP = node->getFirstElementChild(); iP != NULL; iP = iP->getNextElementSibling())
+    for (const intersectionPointInput &iP : node.intersectionPoints)
     {
-        if(readNameFromNode(iP) != "intersectionPoint")
-        {
-            continue;
-        }
-        int adId = stoi(readAttributeFromChildren(iP, "adRoad", "id"));
+        int adId = iP.adRoads.empty() ? -1 : iP.adRoads.front().id;
         junction junc;
         junc.id = juncGroupIdToJuncId(juncGroup.id, adId);
         cc++;
@@ -112,28 +113,26 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
     cc = 0;
     // iterate over all additonalRoads defined by separate intersectionPoints
     // sMain of intersection points have to increase
-    for (DOMElement* iP = node->getFirstElementChild(); iP != NULL; iP = iP->getNextElementSibling())
+    for (const intersectionPointInput &iP : node.intersectionPoints)
     {
+        junction &junc = junctions[cc];
+        cc++;
 
-        if(readNameFromNode(iP) != "intersectionPoint")
+        if (iP.adRoads.empty())
         {
-            continue;
+            cerr << "ERR: 'adRoad' in intersection " << cc << " is missing.";
+            return 1;
         }
-        junction &junc = junctions[cc];
-        cc++;
 
         // find additionalRoad
-        int adId = stoi(readAttributeFromChildren(iP, "adRoad", "id"));
+        const adRoadInput &adRoad = iP.adRoads.front();
+        int adId = adRoad.id;
         
-        DOMElement* additionalRoad;
-        for (DOMElement* road = node->getFirstElementChild(); road != NULL; road = road->getNextElementSibling())
+        const roadInput* additionalRoad = NULL;
+        for (const roadInput &road : node.roads)
         {
-            if(readNameFromNode(road) != "road")
-            {
-                continue;
-            }
-            if (readIntAttrFromNode(road, "id") == adId)
-                additionalRoad = road;
+            if (road.id == adId)
+                additionalRoad = &road;
         }
 
         if (additionalRoad == NULL)
@@ -144,27 +143,19 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
 
         // calculate offsets
         double sOffset = 0;
-        if (cA)
-            sOffset = readDoubleAttrFromNode(cA, "gap");
+        if (cA.hasJunctionArea)
+            sOffset = cA.gap;
 
         double sOffMain = sOffset;
         double sOffAdd = sOffset;
 
-        if(cA != NULL)
+        for (const roadGapInput &sB : cA.roadGaps)
         {
-            for (DOMElement* sB = cA->getFirstElementChild(); sB != NULL; sB = sB->getNextElementSibling())
-            {
-                if(readNameFromNode(sB) != "roadGap")
-                {
-                    continue;
-                }
+            if (sB.id == refId)
+                sOffMain = sB.gap;
 
-                if (readIntAttrFromNode(sB, "id") == refId)
-                    sOffMain = readDoubleAttrFromNode(sB, "gap");
-
-                if (readIntAttrFromNode(sB, "id") == adId)
-                    sOffAdd = readDoubleAttrFromNode(sB, "gap");
-            }
+            if (sB.id == adId)
+                sOffAdd = sB.gap;
         }
 
         // calculate width of circleRoad and addtionalRoad
@@ -212,9 +203,9 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         }
 
         // calculate s and phi at intersection
-        double sMain = readDoubleAttrFromNode(iP, "s");
-        double sAdd = readDoubleAttrFromNode(getChildWithName(iP, "adRoad"), "s");
-        double phi = readDoubleAttrFromNode(getChildWithName(iP, "adRoad"), "angle");
+        double sMain = iP.s;
+        double sAdd = adRoad.s;
+        double phi = adRoad.angle;
 
         //sanity checks
         if(sMain > length)
@@ -225,11 +216,11 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         }
         //fint the length of the add road
         double adLength = 0;
-        for (DOMElement* child = node->getFirstElementChild(); child != NULL; child = child->getNextElementSibling())
+        for (const roadInput &road : node.roads)
         {
-                if(readNameFromNode(child) == "road" && readIntAttrFromNode(child, "id") == adId)
+                if(road.id == adId && !road.referenceLine.empty())
                 {
-                    adLength = readDoubleAttrFromNode(getFirstChildFromNode(getFirstChildFromNode(child)), "length");
+                    adLength = road.referenceLine.front().length;
                 }
         }
 
@@ -303,7 +294,7 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad, r2, data))
+        if (addObjects(additionalRoad->objects, r2, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
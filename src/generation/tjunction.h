@@ -15,7 +15,7 @@
  *
  */
 
-extern settings setting;
+extern thread_local settings setting;
 
 /**
  * @brief function generates the roads and junctions for a t junction which is specified in the input file
@@ -24,13 +24,13 @@ extern settings setting;
  * @param data  roadNetwork structure where the generated roads and junctions are stored
  * @return int  error code
  */
-int tjunction(const DOMElement* node, roadNetwork &data)
+int tjunction(const segmentInput &node, roadNetwork &data)
 {
     // check type of the junction (here: M = mainroad, A = accessroad)
     int mode = 0;
-    if (readStrAttrFromNode(node, "type") == "MA")
+    if (node.type == "MA")
         mode = 1;
-    if (readStrAttrFromNode(node, "type")  == "3A")
+    if (node.type == "3A")
         mode = 2;
     if (mode == 0)
     {
@@ -41,53 +41,49 @@ int tjunction(const DOMElement* node, roadNetwork &data)
     // create segment
     data.nSegment++;
     junction junc;
-    junc.id = readIntAttrFromNode(node, "id");
-    int inputSegmentId = readIntAttrFromNode(node, "id");
+    junc.id = node.id;
+    int inputSegmentId = node.id;
 
     // automatic widening
-    DOMElement* dummy = NULL;
-    DOMElement* automaticWidening = getChildWithName(node ,"automaticWidening");
+    automaticWideningInput* dummy = NULL;
+    automaticWideningInput widening = node.automaticWidening;
+    automaticWideningInput* automaticWidening = node.hasAutomaticWidening ? &widening : NULL;
 
     // create automatic restricted node based on defined automatic widening node
-    DOMElement* automaticRestricted = getChildWithName(node ,"automaticWidening");
+    // (both refer to the same node, so the automatic widening is restricted as well)
+    automaticWideningInput* automaticRestricted = automaticWidening;
     if(automaticRestricted != NULL)
-        automaticRestricted->setAttribute(X("restricted"), X("true"));
-    //automaticRestricted.append_attribute("restricted") = true;
+        automaticRestricted->restricted = true;
 
     // define intersection properties
-    DOMElement* iP = getChildWithName(node, "intersectionPoint");
-    if (iP == NULL)
+    if (node.intersectionPoints.empty())
     {
         cerr << "ERR: intersection point is not defined correct." << endl;
         return 1;
     }
-    DOMElement* cA = getChildWithName(getChildWithName(node, "coupler"), "junctionArea");
-    DOMElement* con = getChildWithName(getChildWithName(node, "coupler"), "connection");
-    DOMElement* addLanes = getChildWithName(getChildWithName(node, "coupler"), "additionalLanes");
+    const intersectionPointInput &iP = node.intersectionPoints.front();
+    const couplerInput &cA = node.coupler;
 
     // define junction roads
-    DOMElement* mainRoad = NULL;
-    DOMElement* additionalRoad1 = NULL;
-    DOMElement* additionalRoad2 = NULL;
+    const roadInput* mainRoad = NULL;
+    const roadInput* additionalRoad1 = NULL;
+    const roadInput* additionalRoad2 = NULL;
 
-    DOMElement* tmpNode = getChildWithName(iP, "adRoad");
+    int adId1 = (iP.adRoads.size() > 0) ? iP.adRoads[0].id : -1;
+    int adId2 = (iP.adRoads.size() > 1) ? iP.adRoads[1].id : -1;
 
-    DOMNodeList *roadList = node->getElementsByTagName(X("road"));
-    for (int i = 0; i < roadList->getLength(); i ++)
+    for (const roadInput &road : node.roads)
     {
-        DOMElement* road = (DOMElement*)roadList->item(i);
-        if(road->getNodeType() != 1) continue; //check the node type. Type 1 is an element. The reason for the check is that line breaks are handled as
-        // text nodes by xercesC.
-        int currentRoadId = readIntAttrFromNode(road, "id");
+        int currentRoadId = road.id;
 
-        if (currentRoadId == readIntAttrFromNode(iP, "refRoad"))
-            mainRoad = road;
+        if (currentRoadId == iP.refRoad)
+            mainRoad = &road;
 
-        if (mode >= 1 && currentRoadId == readIntAttrFromNode(tmpNode, "id"))
-            additionalRoad1 = road;
+        if (mode >= 1 && currentRoadId == adId1)
+            additionalRoad1 = &road;
 
-        if (mode >= 2 && currentRoadId == readIntAttrFromNode(getNextSiblingWithTagName(tmpNode, "adRoad"), "id"))
-            additionalRoad2 = road;
+        if (mode >= 2 && currentRoadId == adId2)
+            additionalRoad2 = &road;
     }
 
     if (mainRoad == NULL || additionalRoad1 == NULL || (mode == 2 && additionalRoad2 == NULL))
@@ -100,26 +96,23 @@ int tjunction(const DOMElement* node, roadNetwork &data)
 
     // calculate offsets
     double sOffset = 0;
-    if (cA)
-        sOffset = readDoubleAttrFromNode(cA, "gap");
+    if (cA.hasJunctionArea)
+        sOffset = cA.gap;
     sOffMain = sOffset;
     sOffAdd1 = sOffset;
     sOffAdd2 = sOffset;
     
-
-    if(cA != NULL) // there might be no coupler provided
+    // there might be no coupler provided
+    for (const roadGapInput &sB : cA.roadGaps)
     {
-        for (DOMElement *sB = cA->getFirstElementChild();sB != NULL; sB = sB->getNextElementSibling())
-        {
-            if (readIntAttrFromNode(sB, "id") == readIntAttrFromNode(mainRoad, "id"))
-                sOffMain = readDoubleAttrFromNode(sB, "gap");
+        if (sB.id == mainRoad->id)
+            sOffMain = sB.gap;
 
-            if (additionalRoad1 != NULL && readIntAttrFromNode(sB, "id") == readIntAttrFromNode(additionalRoad1, "id"))
-                sOffAdd1 = readDoubleAttrFromNode(sB, "gap");
+        if (additionalRoad1 != NULL && sB.id == additionalRoad1->id)
+            sOffAdd1 = sB.gap;
 
-            if (additionalRoad2 != NULL && readIntAttrFromNode(sB, "id") == readIntAttrFromNode(additionalRoad2, "id"))
-                sOffAdd2 = readDoubleAttrFromNode(sB, "gap");
-        }
+        if (additionalRoad2 != NULL && sB.id == additionalRoad2->id)
+            sOffAdd2 = sB.gap;
     }
     // calculate helper roads
     road help1;
@@ -181,32 +174,28 @@ int tjunction(const DOMElement* node, roadNetwork &data)
     }
 
     // calculate s and phi at intersection
-    sMain = readDoubleAttrFromNode(iP, "s");
+    sMain = iP.s;
 
     if (mode >= 1)
     {
-        tmpNode = getChildWithName(iP, "adRoad");
-        if (tmpNode == NULL)
+        if (iP.adRoads.size() < 1)
         {
             cerr << "ERR: first 'adRoad' is missing." << endl;
             return 1;
         }
-        sAdd1 = readDoubleAttrFromNode(tmpNode, "s");
-        phi1 = readDoubleAttrFromNode(tmpNode, "angle");
+        sAdd1 = iP.adRoads[0].s;
+        phi1 = iP.adRoads[0].angle;
     }
 
     if (mode >= 2)
     {
-        for(tmpNode = tmpNode->getNextElementSibling(); tmpNode != NULL 
-            && readNameFromNode(tmpNode) != "adRoad";tmpNode = tmpNode->getNextElementSibling());
-
-        if (tmpNode == NULL)
+        if (iP.adRoads.size() < 2)
         {
             cerr << "ERR: second 'adRoad' is missing." << endl;
             return 1;
         }
-        sAdd2 = readDoubleAttrFromNode(tmpNode, "s");
-        phi2 = readDoubleAttrFromNode(tmpNode, "angle");
+        sAdd2 = iP.adRoads[1].s;
+        phi2 = iP.adRoads[1].angle;
     }
 
     // set coordinates of intersectionPoint
@@ -262,7 +251,7 @@ int tjunction(const DOMElement* node, roadNetwork &data)
             }
     }
     
-    if (addObjects(mainRoad, r1, data))
+    if (addObjects(mainRoad->objects, r1, data))
     {
         cerr << "ERR: error in addObjects" << endl;
         return 1;
@@ -294,7 +283,7 @@ int tjunction(const DOMElement* node, roadNetwork &data)
                 cerr << "ERR: error in buildRoad" << endl;
                 return 1;
             }
-        if (addObjects(mainRoad, r2, data))
+        if (addObjects(mainRoad->objects, r2, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -307,7 +296,7 @@ int tjunction(const DOMElement* node, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad1, r2, data))
+        if (addObjects(additionalRoad1->objects, r2, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -328,7 +317,7 @@ int tjunction(const DOMElement* node, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad1, r3, data))
+        if (addObjects(additionalRoad1->objects, r3, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -341,7 +330,7 @@ int tjunction(const DOMElement* node, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad2, r3, data))
+        if (addObjects(additionalRoad2->objects, r3, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -349,67 +338,54 @@ int tjunction(const DOMElement* node, roadNetwork &data)
     }    
 
     // add addtional lanes
-    if(addLanes != NULL)
+    for (const additionalLaneInput &addLane : cA.additionalLanes)
     {
-        for (DOMElement *addLane = addLanes->getFirstElementChild();addLane != NULL; addLane = addLane->getNextElementSibling())
+        int n = addLane.amount;
+        bool verschwenkung = addLane.verschwenkung;
+            
+        double length = setting.laneChange.s;
+        if (addLane.hasLength)
+            length = addLane.length;
+
+        double ds = setting.laneChange.ds;
+        if (addLane.hasDs)
+            length = addLane.ds;
+
+        int type;
+        string tmpType = addLane.type;
+        if (tmpType == "left")
+            type = 1;
+        if (tmpType == "right")
+            type = -1;
+
+        if (tmpType == "leftRestricted")
+            type = 1;
+        if (tmpType == "rightRestricted")
+            type = -1;
+
+        bool restricted = false;
+        if (tmpType == "leftRestricted" || tmpType == "rightRestricted")
+            restricted = true;
+
+        int inputId = addLane.roadId;
+        string inputPos = addLane.roadPos;
+
+        if (inputId == r1.inputId && inputPos == r1.inputPos)
         {
-            if(readNameFromNode(addLane) != "additionalLane") continue;
-            int n = 1;
-
-            if (attributeExits(addLane, "amount"))
-                n = readIntAttrFromNode(addLane, "amount");
-
-            bool verschwenkung = true;
-            if (attributeExits(addLane, "verschwenkung"))
-                verschwenkung = readBoolAttrFromNode(addLane, "verschwenkung");
-                
-            double length = setting.laneChange.s;
-            if (attributeExits(addLane, "length"))
-                length = readDoubleAttrFromNode(addLane, "length");
-
-            double ds = setting.laneChange.ds;
-            if (attributeExits(addLane, "ds"))
-                length = readDoubleAttrFromNode(addLane, "ds");
-
-            int type;
-            string tmpType = readStrAttrFromNode(addLane, "type");
-            if (tmpType == "left")
-                type = 1;
-            if (tmpType == "right")
-                type = -1;
-
-            if (tmpType == "leftRestricted")
-                type = 1;
-            if (tmpType == "rightRestricted")
-                type = -1;
-
-            bool restricted = false;
-            if (tmpType == "leftRestricted" || tmpType == "rightRestricted")
-                restricted = true;
-
-            int inputId = readIntAttrFromNode(addLane, "roadId");
-
-            string inputPos = "end";
-            if (attributeExits(addLane, "roadPos"))
-                inputPos = readStrAttrFromNode(addLane, "roadPos");
-
-            if (inputId == r1.inputId && inputPos == r1.inputPos)
-            {
-                for (int i = 0; i < n; i++)
-                    laneWideningJunction(r1, length, ds, type, verschwenkung, restricted);
-            }
+            for (int i = 0; i < n; i++)
+                laneWideningJunction(r1, length, ds, type, verschwenkung, restricted);
+        }
 
-            if (inputId == r2.inputId && inputPos == r2.inputPos)
-            {
-                for (int i = 0; i < n; i++)
-                    laneWideningJunction(r2, length, ds, type, verschwenkung, restricted);
-            }
+        if (inputId == r2.inputId && inputPos == r2.inputPos)
+        {
+            for (int i = 0; i < n; i++)
+                laneWideningJunction(r2, length, ds, type, verschwenkung, restricted);
+        }
 
-            if (inputId == r3.inputId && inputPos == r3.inputPos)
-            {
-                for (int i = 0; i < n; i++)
-                    laneWideningJunction(r3, length, ds, type, verschwenkung, restricted);
-            }
+        if (inputId == r3.inputId && inputPos == r3.inputPos)
+        {
+            for (int i = 0; i < n; i++)
+                laneWideningJunction(r3, length, ds, type, verschwenkung, restricted);
         }
     }
 
@@ -449,32 +425,22 @@ int tjunction(const DOMElement* node, roadNetwork &data)
         cout << "\t Generate Connecting Lanes" << endl;
 
     // --- generate user-defined connecting lanes
-    if (con != NULL && readStrAttrFromNode(con, "type") == "single")
+    if (cA.hasConnection && cA.connectionType == "single")
     {
-        for (DOMElement* roadLink = con->getFirstElementChild(); roadLink != NULL; roadLink = roadLink->getNextElementSibling())
+        for (const roadLinkInput &roadLink : cA.roadLinks)
         {
-            if (readNameFromNode(roadLink) != "roadLink") continue;
-
-            int fromId = readIntAttrFromNode(roadLink, "fromId");
-            int toId = readIntAttrFromNode(roadLink, "toId");
-
-            string fromPos = "end";
-            if (attributeExits(roadLink, "fromPos"))
-                fromPos = readStrAttrFromNode(roadLink, "fromPos");
-
-            string toPos = "end";
-            if (attributeExits(roadLink,"toPos"))
-                toPos = readStrAttrFromNode(roadLink, "toPos");
+            int fromId = roadLink.fromId;
+            int toId = roadLink.toId;
+            string fromPos = roadLink.fromPos;
+            string toPos = roadLink.toPos;
 
             road r1, r2;
-            for (int i = 0; i < data.roads.size(); i++)
-            {
-                road tmp = data.roads[i];
-                if (tmp.inputId == fromId && tmp.inputPos == fromPos)
-                    r1 = tmp;
-                if (tmp.inputId == toId && tmp.inputPos == toPos)
-                    r2 = tmp;
-            }
+            for (int k : roadsWithInputId(data, fromId))
+                if (data.roads[k].inputPos == fromPos)
+                    r1 = data.roads[k];
+            for (int k : roadsWithInputId(data, toId))
+                if (data.roads[k].inputPos == toPos)
+                    r2 = data.roads[k];
             if (r1.id == -1 || r2.id == -1)
             {
                 cerr << "ERR: error in user-defined lane connecting:" << endl;
@@ -482,11 +448,10 @@ int tjunction(const DOMElement* node, roadNetwork &data)
                 return 1;
             }
 
-            for (DOMElement* laneLink = roadLink->getFirstElementChild(); laneLink != NULL; laneLink = laneLink->getNextElementSibling())
+            for (const laneLinkInput &laneLink : roadLink.laneLinks)
             {
-                if(readNameFromNode(laneLink) != "laneLink") continue;
-                int from = readIntAttrFromNode(laneLink, "fromId");
-                int to = readIntAttrFromNode(laneLink, "toId");
+                int from = laneLink.fromId;
+                int to = laneLink.toId;
 
                 // flip ids
                 if (fromPos == "start")
@@ -497,12 +462,11 @@ int tjunction(const DOMElement* node, roadNetwork &data)
                 string left = sol;
                 string right = sol;
 
-                if (attributeExits(laneLink, "left"))
-                    left = readStrAttrFromNode(laneLink, "left");
+                if (!laneLink.left.empty())
+                    left = laneLink.left;
 
-                if (attributeExits(laneLink, "right"))
-                    right = readStrAttrFromNode(laneLink, "right");
-                    //left = readStrAttrFromNode(laneLink, "right");  The line above was like this. i changed it to this since i think it was a bug.
+                if (!laneLink.right.empty())
+                    right = laneLink.right;
 
                 road r;
                 r.inputSegmentId = inputSegmentId;
@@ -15,7 +15,7 @@
  *
  */
 
-extern settings setting;
+extern thread_local settings setting;
 
 /**
  * @brief function generates the roads and junctions for a x junction which is specified in the input file
@@ -24,11 +24,11 @@ extern settings setting;
  * @param data  roadNetwork structure where the generated roads and junctions are stored
  * @return int  error code
  */
-int xjunction(const DOMElement* domNode, roadNetwork &data)
+int xjunction(const segmentInput &node, roadNetwork &data)
 {
     // check type of the junction (here: M = mainroad, A = accessroad)
     int mode = 0;
-    string type = readStrAttrFromNode(domNode, "type");
+    string type = node.type;
     if (type == "2M")
         mode = 1;
     if (type == "M2A")
@@ -44,52 +44,48 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
     // create segment
     data.nSegment++;
     junction junc;
-    junc.id = readIntAttrFromNode(domNode, "id");
-    int inputSegmentId = readIntAttrFromNode(domNode, "id");
+    junc.id = node.id;
+    int inputSegmentId = node.id;
 
     // automatic widening
-    DOMElement* dummy = NULL; 
-    DOMElement* automaticWidening = getChildWithName(domNode, "automaticWidening");
+    automaticWideningInput* dummy = NULL; 
+    const automaticWideningInput* automaticWidening = node.hasAutomaticWidening ? &node.automaticWidening : NULL;
 
 
     // define intersection properties
-    DOMElement* iP =  getChildWithName(domNode, "intersectionPoint");
-    if (iP == NULL)
+    if (node.intersectionPoints.empty())
     {
         cerr << "ERR: intersection point is not defined correct.";
         return 1;
     }
-    DOMElement* cA = getChildWithName(getChildWithName(domNode, "coupler"), "junctionArea");
-    DOMElement* con = getChildWithName(getChildWithName(domNode, "coupler"), "connection");
-    DOMElement* addLanes = getChildWithName(getChildWithName(domNode, "coupler"), "additionalLanes");
+    const intersectionPointInput &iP = node.intersectionPoints.front();
+    const couplerInput &cA = node.coupler;
 
 
     // define junction roads
-    DOMElement* refRoad = NULL;
-    DOMElement* additionalRoad1 = NULL;
-    DOMElement* additionalRoad2 = NULL;
-    DOMElement* additionalRoad3 = NULL;
+    const roadInput* refRoad = NULL;
+    const roadInput* additionalRoad1 = NULL;
+    const roadInput* additionalRoad2 = NULL;
+    const roadInput* additionalRoad3 = NULL;
 
-    DOMElement* tmpNode = getChildWithName(iP, "adRoad");
-    DOMNodeList *roads = domNode->getElementsByTagName(X("road"));
-    for (int i = 0; i < roads->getLength(); i ++)
-    {
-        DOMElement* road = (DOMElement*)roads->item(i);
-        if(road->getNodeType() != 1) continue; //we have to check the node type. Type 1 is an element. The reason for the check is that line breaks are handled as
-        // text nodes by xercesC.
+    int adId1 = (iP.adRoads.size() > 0) ? iP.adRoads[0].id : -1;
+    int adId2 = (iP.adRoads.size() > 1) ? iP.adRoads[1].id : -1;
+    int adId3 = (iP.adRoads.size() > 2) ? iP.adRoads[2].id : -1;
 
-        int roadID = readIntAttrFromNode(road, "id");
-        if (roadID == readIntAttrFromNode(iP,"refRoad"))
-            refRoad = road;
+    for (const roadInput &road : node.roads)
+    {
+        int roadID = road.id;
+        if (roadID == iP.refRoad)
+            refRoad = &road;
 
-        if (mode >= 1 && roadID == readIntAttrFromNode(tmpNode,"id"))
-            additionalRoad1 = road;
+        if (mode >= 1 && roadID == adId1)
+            additionalRoad1 = &road;
 
-        if (mode >= 2 && roadID == readIntAttrFromNode(getNextSiblingWithTagName(tmpNode, "adRoad"), "id"))
-            additionalRoad2 = road;
+        if (mode >= 2 && roadID == adId2)
+            additionalRoad2 = &road;
 
-        if (mode >= 3 && roadID == readIntAttrFromNode(getNextSiblingWithTagName(getNextSiblingWithTagName(tmpNode, "adRoad"), "adRoad"), "id"))
-            additionalRoad3 = road;
+        if (mode >= 3 && roadID == adId3)
+            additionalRoad3 = &road;
     }
 
     if (!refRoad || (mode >= 1 && !additionalRoad1) || (mode >= 2 && !additionalRoad2) || (mode >= 3 && !additionalRoad3))
@@ -102,8 +98,8 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
 
     // calculate offsets
     double sOffset = 0;
-    if (cA)
-        sOffset = stod(readStrAttrFromNode(cA, "gap"), &st);
+    if (cA.hasJunctionArea)
+        sOffset = cA.gap;
 
     sOffMain = sOffset;
     sOffAdd1 = sOffset;
@@ -111,22 +107,20 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
     sOffAdd3 = sOffset;
 
 
-    if(cA != NULL) //ca might be not provided
+    //cA might be not provided
+    for (const roadGapInput &it : cA.roadGaps)
     {
-        for (DOMElement* it = cA->getFirstElementChild(); it != NULL ;it = it->getNextElementSibling())
-        {
-            if (readIntAttrFromNode(it, "id") == readIntAttrFromNode(refRoad, "id") )
-                sOffMain = readDoubleAttrFromNode(it, "gap");
+        if (it.id == refRoad->id)
+            sOffMain = it.gap;
 
-            if (readIntAttrFromNode(it, "id") == readIntAttrFromNode(additionalRoad1, "id"))
-                sOffAdd1 = readDoubleAttrFromNode(it, "gap");
+        if (it.id == additionalRoad1->id)
+            sOffAdd1 = it.gap;
 
-            if (readIntAttrFromNode(it, "id") == readIntAttrFromNode(additionalRoad2, "id", true))
-                sOffAdd2 = readDoubleAttrFromNode(it, "gap");
+        if (it.id == ((additionalRoad2 != NULL) ? additionalRoad2->id : -1))
+            sOffAdd2 = it.gap;
 
-            if (readIntAttrFromNode(it, "id", true) == readIntAttrFromNode(additionalRoad3, "id", true))
-                sOffAdd3 = readDoubleAttrFromNode(it, "gap");
-        }
+        if (it.id == ((additionalRoad3 != NULL) ? additionalRoad3->id : -1))
+            sOffAdd3 = it.gap;
     }
 
     // calculate helper roads
@@ -206,23 +200,20 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
     }
 
     // calculate s and phi at intersection
-    sMain = readDoubleAttrFromNode(iP, "s");
+    sMain = iP.s;
 
     if (mode >= 1)
     {
-        tmpNode = getChildWithName(iP, "adRoad");
-        if (tmpNode == NULL)
+        if (iP.adRoads.size() < 1)
         {
             cerr << "ERR: first 'adRoad' is missing." << endl;
             return 1;
         }
-        sAdd1 = readDoubleAttrFromNode(tmpNode, "s");
-        phi1 = readDoubleAttrFromNode(tmpNode, "angle");
-        //tmpNode = tmpNode.next_sibling("adRoad");
-        for(tmpNode = tmpNode->getNextElementSibling(); tmpNode != NULL && readNameFromNode(tmpNode) != "adRoad";tmpNode = tmpNode->getNextElementSibling());
-        
+        sAdd1 = iP.adRoads[0].s;
+        phi1 = iP.adRoads[0].angle;
+
         //some sanity checks---
-        if (tmpNode == NULL && mode != 1) //2M (=mode1) does not contain adRoads
+        if (iP.adRoads.size() < 2 && mode != 1) //2M (=mode1) does not contain adRoads
         {
             cerr << "ERR: error in generating junction road (mode 1). AdRoad is missing in intersection point" << endl;
             return 1;
@@ -255,30 +246,24 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
     }
     if (mode >= 2)
     {
-        if (tmpNode == NULL)
+        if (iP.adRoads.size() < 2)
         {
             cerr << "ERR: second 'adRoad' is missing." << endl;
             return 1;
         }
 
-        sAdd2 = readDoubleAttrFromNode(tmpNode, "s");
-        phi2 = readDoubleAttrFromNode(tmpNode, "angle");
-        for(tmpNode = tmpNode->getNextElementSibling(); tmpNode != NULL && readNameFromNode(tmpNode) != "adRoad";tmpNode = tmpNode->getNextElementSibling());
-
-
+        sAdd2 = iP.adRoads[1].s;
+        phi2 = iP.adRoads[1].angle;
     }
     if (mode >= 3)
     {
-        if (!tmpNode)
+        if (iP.adRoads.size() < 3)
         {
             cerr << "ERR: third 'adRoad' is missing." << endl;
             return 1;
         }
-        sAdd3 = readDoubleAttrFromNode(tmpNode, "s");
-        phi3 = readDoubleAttrFromNode(tmpNode, "angle");
-        for(tmpNode = tmpNode->getNextElementSibling(); tmpNode != NULL 
-            && readNameFromNode(tmpNode) != "adRoad";tmpNode = tmpNode->getNextElementSibling());
-
+        sAdd3 = iP.adRoads[2].s;
+        phi3 = iP.adRoads[2].angle;
     }
 
     // calculate coordinates of intersectionPoint
@@ -324,7 +309,7 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
         }
     }
     
-    if (addObjects(refRoad, r1, data))
+    if (addObjects(refRoad->objects, r1, data))
     {
         cerr << "ERR: error in addObjects" << endl;
         return 1;
@@ -355,7 +340,7 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
         }
     }
 
-    if (addObjects(additionalRoad1, r2, data))
+    if (addObjects(additionalRoad1->objects, r2, data))
     {
         cerr << "ERR: error in addObjects" << endl;
         return 1;
@@ -376,7 +361,7 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(refRoad, r3, data))
+        if (addObjects(refRoad->objects, r3, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -389,7 +374,7 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad2, r3, data))
+        if (addObjects(additionalRoad2->objects, r3, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -417,7 +402,7 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad1, r4, data))
+        if (addObjects(additionalRoad1->objects, r4, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -430,7 +415,7 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad2, r4, data))
+        if (addObjects(additionalRoad2->objects, r4, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -443,7 +428,7 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad3, r4, data))
+        if (addObjects(additionalRoad3->objects, r4, data))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -451,75 +436,60 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
     }
 
     // add addtional lanes
-    if(addLanes != NULL)
+    for (const additionalLaneInput &addLane : cA.additionalLanes)
     {
-        DOMNodeList *addLaneList = addLanes->getElementsByTagName(X("additionalLane"));
-        for (int i = 0; i < addLaneList->getLength(); i ++)
-        {
-            DOMElement* addLane = (DOMElement*)addLaneList->item(i);
-            if(addLane->getNodeType() != 1) continue; //we have to check the node type. Type 1 is an element. The reason for the check is that line breaks are handled as
-            // text nodes by xercesC.
-            int n = 1;
-            if (attributeExits(addLane, "amount"))
-                n = readIntAttrFromNode(addLane, "amount");
-
-            bool verschwenkung = true;
-            if (attributeExits(addLane, "verschwenkung"))
-                verschwenkung = readBoolAttrFromNode(addLane, "verschwenkung");
+        int n = addLane.amount;
+        bool verschwenkung = addLane.verschwenkung;
 
-            double length = setting.laneChange.s;
-            if (attributeExits(addLane, "length"))
-                length = readDoubleAttrFromNode(addLane, "length");
+        double length = setting.laneChange.s;
+        if (addLane.hasLength)
+            length = addLane.length;
 
-            double ds = setting.laneChange.ds;
-            if (attributeExits(addLane, "ds"))
-                length = readDoubleAttrFromNode(addLane, "ds");
+        double ds = setting.laneChange.ds;
+        if (addLane.hasDs)
+            length = addLane.ds;
 
-            int type;
-            string tmpType = readStrAttrFromNode(addLane, "type");
-            if (tmpType == "left")
-                type = 1;
-            if (tmpType == "right")
-                type = -1;
+        int type;
+        string tmpType = addLane.type;
+        if (tmpType == "left")
+            type = 1;
+        if (tmpType == "right")
+            type = -1;
 
-            if (tmpType == "leftRestricted")
-                type = 1;
-            if (tmpType == "rightRestricted")
-                type = -1;
+        if (tmpType == "leftRestricted")
+            type = 1;
+        if (tmpType == "rightRestricted")
+            type = -1;
 
-            bool restricted = false;
-            if (tmpType == "leftRestricted" || tmpType == "rightRestricted")
-                restricted = true;
+        bool restricted = false;
+        if (tmpType == "leftRestricted" || tmpType == "rightRestricted")
+            restricted = true;
 
-            int inputId = readIntAttrFromNode(addLane, "roadId");
+        int inputId = addLane.roadId;
+        string inputPos = addLane.roadPos;
 
-            string inputPos = "end";
-            if (attributeExits(addLane, "roadPos"))
-                inputPos = readStrAttrFromNode(addLane, "roadPos");
-
-            if (inputId == r1.inputId && inputPos == r1.inputPos)
-            {
-                for (int i = 0; i < n; i++)
-                    laneWideningJunction(r1, length, ds, type, verschwenkung, restricted);
-            }
+        if (inputId == r1.inputId && inputPos == r1.inputPos)
+        {
+            for (int i = 0; i < n; i++)
+                laneWideningJunction(r1, length, ds, type, verschwenkung, restricted);
+        }
 
-            if (inputId == r2.inputId && inputPos == r2.inputPos)
-            {
-                for (int i = 0; i < n; i++)
-                    laneWideningJunction(r2, length, ds, type, verschwenkung, restricted);
-            }
+        if (inputId == r2.inputId && inputPos == r2.inputPos)
+        {
+            for (int i = 0; i < n; i++)
+                laneWideningJunction(r2, length, ds, type, verschwenkung, restricted);
+        }
 
-            if (inputId == r3.inputId && inputPos == r3.inputPos)
-            {
-                for (int i = 0; i < n; i++)
-                    laneWideningJunction(r3, length, ds, type, verschwenkung, restricted);
-            }
+        if (inputId == r3.inputId && inputPos == r3.inputPos)
+        {
+            for (int i = 0; i < n; i++)
+                laneWideningJunction(r3, length, ds, type, verschwenkung, restricted);
+        }
 
-            if (inputId == r4.inputId && inputPos == r4.inputPos)
-            {
-                for (int i = 0; i < n; i++)
-                    laneWideningJunction(r4, length, ds, type, verschwenkung, restricted);
-            }
+        if (inputId == r4.inputId && inputPos == r4.inputPos)
+        {
+            for (int i = 0; i < n; i++)
+                laneWideningJunction(r4, length, ds, type, verschwenkung, restricted);
         }
     }
 
@@ -567,35 +537,22 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
         cout << "\t Generate Connecting Lanes" << endl;
 
     // generate user-defined connecting lanes
-    if (con != NULL && readStrAttrFromNode(con, "type") == "single")
+    if (cA.hasConnection && cA.connectionType == "single")
     {
-        DOMNodeList *roadLinkList = con->getElementsByTagName(X("roadLink"));
-        for (int i = 0; i < roadLinkList->getLength(); i ++)
+        for (const roadLinkInput &roadLink : cA.roadLinks)
         {
-            DOMElement* roadLink = (DOMElement*)roadLinkList->item(i);
-            if(roadLink->getNodeType() != 1) continue; //we have to check the node type. Type 1 is an element. The reason for the check is that line breaks are handled as
-            // text nodes by xercesC.
-
-            int fromId = readIntAttrFromNode(roadLink, "fromId");
-            int toId = readIntAttrFromNode(roadLink, "toId");
-
-            string fromPos = "end";
-            if (attributeExits(roadLink, "fromPos"))
-                fromPos = readIntAttrFromNode(roadLink, "fromPos");
-
-            string toPos = "end";
-            if (attributeExits(roadLink, "toPos"))
-                toPos = readIntAttrFromNode(roadLink, "toPos");
+            int fromId = roadLink.fromId;
+            int toId = roadLink.toId;
+            string fromPos = roadLink.fromPos;
+            string toPos = roadLink.toPos;
 
             road r1, r2;
-            for (int i = 0; i < data.roads.size(); i++)
-            {
-                road tmp = data.roads[i];
-                if (tmp.inputId == fromId && tmp.inputPos == fromPos)
-                    r1 = tmp;
-                if (tmp.inputId == toId && tmp.inputPos == toPos)
-                    r2 = tmp;
-            }
+            for (int k : roadsWithInputId(data, fromId))
+                if (data.roads[k].inputPos == fromPos)
+                    r1 = data.roads[k];
+            for (int k : roadsWithInputId(data, toId))
+                if (data.roads[k].inputPos == toPos)
+                    r2 = data.roads[k];
             if (r1.id == -1 || r2.id == -1)
             {
                 cerr << "ERR: error in user-defined lane connecting:" << endl;
@@ -603,15 +560,10 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
                 return 1;
             }
 
-            DOMNodeList *laneLinkList = roadLink->getElementsByTagName(X("laneLink"));
-            for (int i = 0; i < laneLinkList->getLength(); i ++)
+            for (const laneLinkInput &laneLink : roadLink.laneLinks)
             {
-                DOMElement* laneLink = (DOMElement*)laneLinkList->item(i);
-                if(laneLink->getNodeType() != 1) continue; //we have to check the node type. Type 1 is an element. The reason for the check is that line breaks are handled as
-                // text nodes by xercesC.
-
-                int from = readIntAttrFromNode(laneLink, "fromId");
-                int to = readIntAttrFromNode(laneLink, "toId");
+                int from = laneLink.fromId;
+                int to = laneLink.toId;
 
                 // flip ids
                 if (fromPos == "start")
@@ -622,11 +574,11 @@ int xjunction(const DOMElement* domNode, roadNetwork &data)
                 string left = non;
                 string right = non;
 
-                if (attributeExits(laneLink, "left"))
-                    left = readStrAttrFromNode(laneLink, "left");
+                if (!laneLink.left.empty())
+                    left = laneLink.left;
 
-                if (attributeExits(laneLink, "right"))
-                    right = readStrAttrFromNode(laneLink, "right");;
+                if (!laneLink.right.empty())
+                    right = laneLink.right;
 
                 road r;
                 r.id = 100 * junc.id + data.roads.size() + 1;
@@ -0,0 +1,178 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file batch.h
+ *
+ * @brief This file contains the batch mode which generates multiple input files on a pool of worker threads
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#ifndef _WIN32
+#include <dirent.h>
+#endif
+
+/**
+ * @brief result of a single file of a batch run
+ *
+ */
+struct batchResult
+{
+    std::string file;
+    int status = -1;
+    int warnings = 0;
+    double seconds = 0;
+};
+
+/**
+ * @brief function collects all xml files of a directory, sorted by name
+ *
+ * @param dir       input directory
+ * @param files     list of found files
+ * @return int      error code
+ */
+int listInputFiles(const string &dir, vector<string> &files)
+{
+    string prefix = dir;
+    if (!prefix.empty() && prefix.back() != '/' && prefix.back() != '\\')
+        prefix += "/";
+
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA((dir + "\\*.xml").c_str(), &fd);
+    if (h == INVALID_HANDLE_VALUE)
+    {
+        cerr << "ERR: input directory " << dir << " can not be read" << endl;
+        return 1;
+    }
+    do
+    {
+        files.push_back(prefix + fd.cFileName);
+    } while (FindNextFileA(h, &fd));
+    FindClose(h);
+#else
+    DIR *d = opendir(dir.c_str());
+    if (d == NULL)
+    {
+        cerr << "ERR: input directory " << dir << " can not be read" << endl;
+        return 1;
+    }
+    for (dirent *entry = readdir(d); entry != NULL; entry = readdir(d))
+    {
+        string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".xml") == 0)
+            files.push_back(prefix + name);
+    }
+    closedir(d);
+#endif
+
+    sort(files.begin(), files.end());
+    return 0;
+}
+
+/**
+ * @brief function writes the per file status of a batch run as csv file
+ *
+ * @param file      summary file
+ * @param results   results of all files
+ * @return int      error code
+ */
+int writeBatchSummary(const string &file, const vector<batchResult> &results)
+{
+    ofstream out(file.c_str());
+    if (!out.is_open())
+    {
+        cerr << "ERR: summary file " << file << " can not be written" << endl;
+        return 1;
+    }
+
+    out << "file,status,warnings,seconds" << endl;
+    for (const batchResult &r : results)
+        out << r.file << "," << ((r.status == 0) ? "ok" : "failed") << "," << r.warnings << "," << r.seconds << endl;
+
+    return 0;
+}
+
+/**
+ * @brief function runs the pipeline for all files on a pool of worker threads.
+ * Every file is generated with its own copy of the template context, the output is stored next to the input file
+ *
+ * @param base      template context which holds the settings for all runs
+ * @param files     input files
+ * @param nThreads  number of worker threads, 0 uses all available cores
+ * @param results   per file results in the order of the input files
+ * @return int      number of failed files
+ */
+int runBatch(const generatorContext &base, const vector<string> &files, int nThreads, vector<batchResult> &results)
+{
+    results.assign(files.size(), batchResult());
+
+    if (nThreads <= 0)
+        nThreads = max(1u, std::thread::hardware_concurrency());
+    nThreads = min(nThreads, (int)files.size());
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t k = next++; k < files.size(); k = next++)
+        {
+            generatorContext ctx = base;
+            ctx.fileName = files[k];
+            ctx.outName = "";
+            ctx.setOutput = false;
+            ctx.incremental = nullptr; // the files of a batch are unrelated
+            ctx.index = nullptr;        // the index and lane graph of a single file can not be queried
+            ctx.buildIndex = false;
+            ctx.graph = nullptr;
+            ctx.report = nullptr;
+            ctx.profile = nullptr;     // every file writes its own profile next to its output
+
+            batchResult &r = results[k];
+            r.file = files[k];
+
+            auto start = std::chrono::steady_clock::now();
+            try
+            {
+                r.status = contextExecPipeline(&ctx);
+            }
+            catch (...)
+            {
+                cerr << "ERR: unexpected exception during generation of " << files[k] << endl;
+                r.status = -1;
+            }
+            r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            r.warnings = ctx.warnings;
+        }
+    };
+
+    // the log is opened once for the whole batch, so that single runs do not truncate it
+    acquireLog(base.logfile, base.setting.overwriteLog);
+
+    vector<std::thread> pool;
+    for (int t = 1; t < nThreads; t++)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread &t : pool)
+        t.join();
+
+    releaseLog();
+
+    int nFailed = 0;
+    for (const batchResult &r : results)
+        if (r.status != 0)
+            nFailed++;
+
+    return nFailed;
+}
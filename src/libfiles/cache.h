@@ -0,0 +1,198 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file cache.h
+ *
+ * @brief This file contains the on-disk output cache which stores generated networks keyed on their normalized input
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <random>
+#include <thread>
+#include <cstdio>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+// version of the generator, has to be increased whenever the generated output changes
+#ifndef ROAD_GENERATION_VERSION
+#define ROAD_GENERATION_VERSION "1.3"
+#endif
+
+/**
+ * @brief process wide hit and miss counters of the output cache
+ *
+ */
+struct cacheStatistics
+{
+    std::atomic<long long> hits;
+    std::atomic<long long> misses;
+
+    cacheStatistics() : hits(0), misses(0) {}
+};
+
+cacheStatistics outputCache;
+
+/**
+ * @brief function computes the part of a key which does not depend on the input: library version and the settings which influence the output
+ *
+ * @return string   settings key
+ */
+string settingsKey()
+{
+    ostringstream s;
+    s << setprecision(numeric_limits<double>::max_digits10);
+    s << "road-generation " << ROAD_GENERATION_VERSION << "\n";
+    s << "width " << setting.width.standard << " " << setting.width.main << " " << setting.width.access << "\n";
+    s << "speed " << setting.speed.standard << " " << setting.speed.main << " " << setting.speed.access << "\n";
+    s << "laneChange " << setting.laneChange.s << " " << setting.laneChange.ds << "\n";
+    s << "busStop " << setting.busStop.length << " " << setting.busStop.widening << "\n";
+    s << "opendrive " << setting.versionMajor << "." << setting.versionMinor << "\n";
+    s << "minConnectingRoadLength " << setting.minConnectingRoadLength << "\n";
+    s << "writer " << setting.streamingWriter << " validation " << setting.outputValidation << "\n";
+    return s.str();
+}
+
+/**
+ * @brief function computes the key of a run: library version, the settings which influence the output and the normalized input tree
+ *
+ * @param root      root of the validated input tree
+ * @return string   key of the run
+ */
+string cacheKey(const DOMElement *root)
+{
+    string key = settingsKey();
+    appendNormalizedTree(root, key);
+    return key;
+}
+
+/**
+ * @brief function computes the file name of a cache entry from its key (64 bit FNV-1a)
+ *
+ * @param key       key of the run
+ * @return string   path of the cache entry without extension
+ */
+string cacheEntry(const string &key)
+{
+    unsigned long long h = 14695981039346656037ULL;
+    for (unsigned char c : key)
+    {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", h);
+
+    string dir = setting.cacheDirectory;
+    if (!dir.empty() && dir.back() != '/' && dir.back() != '\\')
+        dir += "/";
+    return dir + hex;
+}
+
+/**
+ * @brief function reads a whole file
+ *
+ * @param file      file to read
+ * @param content   content of the file
+ * @return int      error code
+ */
+int readFile(const string &file, string &content)
+{
+    ifstream in(file.c_str(), ios::in | ios::binary);
+    if (!in.is_open()) return 1;
+
+    ostringstream s;
+    s << in.rdbuf();
+    content = s.str();
+    return in.bad() ? 1 : 0;
+}
+
+/**
+ * @brief function looks up the output of a run in the cache. The stored key is compared, so that hash collisions can not return a wrong network
+ *
+ * @param key       key of the run
+ * @param xodr      cached output
+ * @return int      0 on a hit, 1 on a miss
+ */
+int readCacheEntry(const string &key, string &xodr)
+{
+    string entry = cacheEntry(key);
+
+    string storedKey;
+    if (readFile(entry + ".key", storedKey) || storedKey != key || readFile(entry + ".xodr", xodr))
+    {
+        outputCache.misses++;
+        return 1;
+    }
+
+    outputCache.hits++;
+    return 0;
+}
+
+/**
+ * @brief function stores the output of a run in the cache. The files are written under temporary names and renamed afterwards,
+ * the key is renamed last so that concurrent runs never read a partial entry
+ *
+ * @param key       key of the run
+ * @param xodr      generated output
+ * @return int      error code
+ */
+int writeCacheEntry(const string &key, const string &xodr)
+{
+#ifdef _WIN32
+    _mkdir(setting.cacheDirectory.c_str());
+#else
+    mkdir(setting.cacheDirectory.c_str(), 0755);
+#endif
+
+    // thread ids repeat across processes sharing the cache directory, the random token of the process separates them.
+    // unistd.h is not included for getpid, its link function would hide the link struct
+    static const unsigned int processToken = std::random_device()();
+
+    string entry = cacheEntry(key);
+    ostringstream tmp;
+    tmp << entry << "." << hex << processToken << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+
+    const string *content[2] = {&xodr, &key};
+    const char *extension[2] = {".xodr", ".key"};
+    for (int i = 0; i < 2; i++)
+    {
+        {
+            ofstream out(tmp.str().c_str(), ios::out | ios::binary);
+            out.write(content[i]->data(), content[i]->size());
+            if (!out.good())
+            {
+                remove(tmp.str().c_str());
+                return 1;
+            }
+        }
+
+        string file = entry + extension[i];
+#ifdef _WIN32
+        remove(file.c_str()); // rename does not replace existing files on windows
+#endif
+        if (rename(tmp.str().c_str(), file.c_str()))
+        {
+            remove(tmp.str().c_str());
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file context.h
+ *
+ * @brief This file contains the generator context which holds the complete state of one pipeline run
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <mutex>
+#include <memory>
+
+/**
+ * @brief state of a single generator. Every context owns its settings, warning counter and file names,
+ * so that multiple contexts can execute the pipeline concurrently in one process
+ *
+ */
+struct generatorContext
+{
+    settings setting;
+
+    std::string fileName;
+    std::string outName;
+    bool setOutput = false;
+    std::string logfile = "log.txt";
+
+    int warnings = 0; // number of warnings of the last run
+
+    std::shared_ptr<incrementalState> incremental; // results of the last run, only set in incremental mode, use std::atomic_load
+
+    bool buildIndex = false;                    // build the spatial index after every run
+    std::shared_ptr<const spatialIndex> index;  // spatial index of the last successful run, use std::atomic_load
+
+    bool buildGraph = false;                    // build the lane graph after every run
+    std::shared_ptr<const laneGraph> graph;     // lane graph of the last successful run, use std::atomic_load
+
+    bool buildReport = false;                       // analyze the connectivity after every run
+    std::shared_ptr<const networkReport> report;    // report of the last successful run, use std::atomic_load
+
+    bool buildProfile = false;                          // record the times and metrics of every run
+    std::shared_ptr<const pipelineProfile> profile;     // profile of the last successful run, use std::atomic_load
+};
+
+/**
+ * @brief the error log is written to stderr which is shared by the whole process.
+ * The log file is (re)opened only if no other run is active, concurrent runs append to the currently opened log.
+ *
+ */
+struct logState
+{
+    std::mutex mtx;
+    int activeRuns = 0;
+};
+
+logState errorLog;
+
+/**
+ * @brief opens the error log for a run
+ *
+ * @param file      path of the log file
+ * @param overwrite true if the log file should be truncated
+ */
+void acquireLog(const std::string &file, bool overwrite)
+{
+    std::lock_guard<std::mutex> lock(errorLog.mtx);
+    if (errorLog.activeRuns == 0)
+        (void)! freopen(file.c_str(), (overwrite)? "w":"a", stderr); //(void)! suppresses the unused return warning..
+    errorLog.activeRuns++;
+}
+
+/**
+ * @brief marks a run as finished and flushes the error log
+ *
+ */
+void releaseLog()
+{
+    std::lock_guard<std::mutex> lock(errorLog.mtx);
+    errorLog.activeRuns--;
+    cerr.flush();
+}
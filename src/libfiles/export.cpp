@@ -24,6 +24,8 @@
 #include <vector>
 #include <cmath>
 #include <ctime>
+#include <cstdlib>
+#include <cstring>
 
 #ifdef _WIN32
 #define NOMINMAX
@@ -34,63 +36,654 @@
 #endif
 #endif
 
-std::string::size_type st;
+thread_local std::string::size_type st;
 using namespace std;
 
 #include "utils/settings.h"
 #include "utils/interface.h"
 #include "utils/helper.h"
 #include "utils/xml.h"
+#include "utils/inputModel.h"
+#include "utils/incremental.h"
+#include "utils/profiling.h"
 #include "generation/buildSegments.h"
 #include "connection/linkSegments.h"
 #include "connection/closeRoadNetwork.h"
+#include "utils/spatialIndex.h"
+#include "utils/laneGraph.h"
+#include "utils/networkAnalysis.h"
+#include "utils/snapshot.h"
+#include "libfiles/context.h"
+#include "libfiles/batch.h"
+#include "libfiles/cache.h"
+#include "libfiles/variation.h"
 
-settings setting;
+// settings of the pipeline run executed by the current thread
+thread_local settings setting;
+
+// context used by the legacy functions without context handle
+generatorContext defaultContext;
 
 EXPORTED void setFileName(char* file){
-	_fileName = file;
+	contextSetFileName(&defaultContext, file);
 }
 
 EXPORTED void setOverwriteLog(bool b){
-	setting.overwriteLog = b;
+	contextSetOverwriteLog(&defaultContext, b);
 }
 
 EXPORTED void setLogFile(char* file){
-	_logfile = file;
+	contextSetLogFile(&defaultContext, file);
 }
 
 EXPORTED void setOutputName(char* outName){
-	_outName = outName;
-	_setOutput = true;
+	contextSetOutputName(&defaultContext, outName);
 }
 
 EXPORTED int execPipeline(){
-	return executePipeline(_fileName);
+	return contextExecPipeline(&defaultContext);
 }
 
 EXPORTED void setSilentMode(bool sMode){
-	setting.silentMode = sMode;
+	contextSetSilentMode(&defaultContext, sMode);
 }
 
 
 EXPORTED void setXMLSchemeLocation(char* file){
-	setting.xmlSchemeLocation = file;
+	contextSetXMLSchemeLocation(&defaultContext, file);
+}
+
+EXPORTED void setOutputValidation(bool b){
+	contextSetOutputValidation(&defaultContext, b);
+}
+
+EXPORTED void setStreamingWriter(bool b){
+	contextSetStreamingWriter(&defaultContext, b);
+}
+
+EXPORTED void setSnapshot(bool b){
+	contextSetSnapshot(&defaultContext, b);
+}
+
+EXPORTED void setCacheDirectory(char* dir){
+	contextSetCacheDirectory(&defaultContext, dir);
+}
+
+EXPORTED void setIncremental(bool b){
+	contextSetIncremental(&defaultContext, b);
+}
+
+EXPORTED void setSegmentThreads(int n){
+	contextSetSegmentThreads(&defaultContext, n);
+}
+
+EXPORTED void setSpatialIndex(bool b){
+	contextSetSpatialIndex(&defaultContext, b);
+}
+
+EXPORTED void setLaneGraph(bool b){
+	contextSetLaneGraph(&defaultContext, b);
+}
+
+EXPORTED int shortestLanePath(int fromRoad, int fromLane, int toRoad, int toLane, int* roadIds, int* sectionIds, int* laneIds, int capacity, double* cost){
+	return contextShortestLanePath(&defaultContext, fromRoad, fromLane, toRoad, toLane, roadIds, sectionIds, laneIds, capacity, cost);
+}
+
+EXPORTED void setNetworkAnalysis(bool b){
+	contextSetNetworkAnalysis(&defaultContext, b);
+}
+
+EXPORTED int getNetworkReport(char** buffer, size_t* size){
+	return contextGetNetworkReport(&defaultContext, buffer, size);
+}
+
+EXPORTED void setProfiling(bool b){
+	contextSetProfiling(&defaultContext, b);
+}
+
+EXPORTED int getProfile(char** buffer, size_t* size){
+	return contextGetProfile(&defaultContext, buffer, size);
+}
+
+EXPORTED int nearestRoad(double x, double y, int* roadId, double* s, double* t){
+	return contextNearestRoad(&defaultContext, x, y, roadId, s, t);
+}
+
+EXPORTED int nearestLane(double x, double y, int* roadId, int* laneId, double* s, double* distance){
+	return contextNearestLane(&defaultContext, x, y, roadId, laneId, s, distance);
+}
+
+EXPORTED int queryBox(double xMin, double yMin, double xMax, double yMax, int* roadIds, int* laneIds, int capacity){
+	return contextQueryBox(&defaultContext, xMin, yMin, xMax, yMax, roadIds, laneIds, capacity);
+}
+
+EXPORTED int intersectSegment(double x1, double y1, double x2, double y2, int* roadId, int* laneId, double* s, double* fraction){
+	return contextIntersectSegment(&defaultContext, x1, y1, x2, y2, roadId, laneId, s, fraction);
+}
+
+EXPORTED long long getCacheHits(){
+	return outputCache.hits;
+}
+
+EXPORTED long long getCacheMisses(){
+	return outputCache.misses;
+}
+
+EXPORTED void resetCacheStatistics(){
+	outputCache.hits = 0;
+	outputCache.misses = 0;
 }
 
 
 EXPORTED int executePipeline(char* file)
 {
-
 	if (file == NULL){
 		cout << "ERR: no file has been provided!" << endl;
 		return -1;
 	}
 
-	if(!_setOutput){
-		_outName = file;
+	defaultContext.fileName = file;
+	return contextExecPipeline(&defaultContext);
+}
+
+EXPORTED generatorContext* createContext(){
+	return new generatorContext;
+}
+
+EXPORTED void destroyContext(generatorContext* ctx){
+	delete ctx;
+}
+
+EXPORTED void contextSetFileName(generatorContext* ctx, const char* file){
+	ctx->fileName = (file == NULL) ? "" : file;
+}
+
+EXPORTED void contextSetOutputName(generatorContext* ctx, const char* file){
+	ctx->outName = (file == NULL) ? "" : file;
+	ctx->setOutput = true;
+}
+
+EXPORTED void contextSetXMLSchemeLocation(generatorContext* ctx, const char* file){
+	ctx->setting.xmlSchemeLocation = (file == NULL) ? "" : file;
+}
+
+EXPORTED void contextSetLogFile(generatorContext* ctx, const char* file){
+	ctx->logfile = (file == NULL) ? "" : file;
+}
+
+EXPORTED void contextSetSilentMode(generatorContext* ctx, bool sMode){
+	ctx->setting.silentMode = sMode;
+}
+
+EXPORTED void contextSetOverwriteLog(generatorContext* ctx, bool b){
+	ctx->setting.overwriteLog = b;
+}
+
+EXPORTED void contextSetOutputValidation(generatorContext* ctx, bool b){
+	ctx->setting.outputValidation = b;
+}
+
+EXPORTED void contextSetStreamingWriter(generatorContext* ctx, bool b){
+	ctx->setting.streamingWriter = b;
+}
+
+EXPORTED void contextSetSnapshot(generatorContext* ctx, bool b){
+	ctx->setting.snapshot = b;
+}
+
+EXPORTED void contextSetCacheDirectory(generatorContext* ctx, const char* dir){
+	ctx->setting.cacheDirectory = (dir == NULL) ? "" : dir;
+}
+
+EXPORTED void contextSetIncremental(generatorContext* ctx, bool b){
+	// a running pipeline keeps its own reference, so the state is released after the run
+	if (!b)
+	{
+		std::atomic_store(&ctx->incremental, std::shared_ptr<incrementalState>());
+		return;
+	}
+	std::shared_ptr<incrementalState> expected;
+	std::atomic_compare_exchange_strong(&ctx->incremental, &expected, std::make_shared<incrementalState>());
+}
+
+EXPORTED void contextSetSegmentThreads(generatorContext* ctx, int n){
+	ctx->setting.segmentThreads = n;
+}
+
+EXPORTED int contextGetWarnings(generatorContext* ctx){
+	return ctx->warnings;
+}
+
+EXPORTED void contextSetSpatialIndex(generatorContext* ctx, bool b){
+	ctx->buildIndex = b;
+	if (!b)
+		std::atomic_store(&ctx->index, std::shared_ptr<const spatialIndex>());
+}
+
+EXPORTED void contextSetLaneGraph(generatorContext* ctx, bool b){
+	ctx->buildGraph = b;
+	if (!b)
+		std::atomic_store(&ctx->graph, std::shared_ptr<const laneGraph>());
+}
+
+EXPORTED int contextShortestLanePath(generatorContext* ctx, int fromRoad, int fromLane, int toRoad, int toLane, int* roadIds, int* sectionIds, int* laneIds, int capacity, double* cost){
+	if (ctx == NULL || cost == NULL || (capacity > 0 && (roadIds == NULL || sectionIds == NULL || laneIds == NULL))) return -1;
+	std::shared_ptr<const laneGraph> graph = std::atomic_load(&ctx->graph);
+	if (!graph) return -1;
+
+	vector<int> path;
+	if (findLanePath(*graph, fromRoad, fromLane, toRoad, toLane, path, *cost)) return 0;
+	for (int k = 0; k < capacity && k < (int)path.size(); k++)
+	{
+		const laneNode &n = graph->nodes[path[k]];
+		roadIds[k] = n.road;
+		sectionIds[k] = n.section;
+		laneIds[k] = n.lane;
+	}
+	return (int)path.size();
+}
+
+EXPORTED void contextSetNetworkAnalysis(generatorContext* ctx, bool b){
+	ctx->buildReport = b;
+	if (!b)
+		std::atomic_store(&ctx->report, std::shared_ptr<const networkReport>());
+}
+
+EXPORTED int contextGetNetworkReport(generatorContext* ctx, char** buffer, size_t* size){
+	if (ctx == NULL || buffer == NULL || size == NULL) return -1;
+	*buffer = NULL;
+	*size = 0;
+
+	std::shared_ptr<const networkReport> report = std::atomic_load(&ctx->report);
+	if (!report) return -1;
+
+	*buffer = (char*)malloc(report->json.size() + 1);
+	if (*buffer == NULL) return -1;
+	memcpy(*buffer, report->json.c_str(), report->json.size() + 1);
+	*size = report->json.size();
+
+	return report->problems;
+}
+
+EXPORTED void contextSetProfiling(generatorContext* ctx, bool b){
+	ctx->buildProfile = b;
+	if (!b)
+		std::atomic_store(&ctx->profile, std::shared_ptr<const pipelineProfile>());
+}
+
+EXPORTED int contextGetProfile(generatorContext* ctx, char** buffer, size_t* size){
+	if (ctx == NULL || buffer == NULL || size == NULL) return -1;
+	*buffer = NULL;
+	*size = 0;
+
+	std::shared_ptr<const pipelineProfile> profile = std::atomic_load(&ctx->profile);
+	if (!profile) return -1;
+
+	*buffer = (char*)malloc(profile->json.size() + 1);
+	if (*buffer == NULL) return -1;
+	memcpy(*buffer, profile->json.c_str(), profile->json.size() + 1);
+	*size = profile->json.size();
+
+	return 0;
+}
+
+EXPORTED int contextNearestRoad(generatorContext* ctx, double x, double y, int* roadId, double* s, double* t){
+	if (ctx == NULL || roadId == NULL || s == NULL || t == NULL) return -1;
+	std::shared_ptr<const spatialIndex> index = std::atomic_load(&ctx->index);
+	if (!index) return -1;
+
+	spatialHit hit;
+	if (nearestElement(*index, x, y, true, hit)) return 1;
+	*roadId = hit.road;
+	*s = hit.s;
+	*t = hit.t;
+	return 0;
+}
+
+EXPORTED int contextNearestLane(generatorContext* ctx, double x, double y, int* roadId, int* laneId, double* s, double* distance){
+	if (ctx == NULL || roadId == NULL || laneId == NULL || s == NULL || distance == NULL) return -1;
+	std::shared_ptr<const spatialIndex> index = std::atomic_load(&ctx->index);
+	if (!index) return -1;
+
+	spatialHit hit;
+	if (nearestElement(*index, x, y, false, hit)) return 1;
+	*roadId = hit.road;
+	*laneId = hit.lane;
+	*s = hit.s;
+	*distance = hit.distance;
+	return 0;
+}
+
+EXPORTED int contextQueryBox(generatorContext* ctx, double xMin, double yMin, double xMax, double yMax, int* roadIds, int* laneIds, int capacity){
+	if (ctx == NULL || (capacity > 0 && (roadIds == NULL || laneIds == NULL))) return -1;
+	std::shared_ptr<const spatialIndex> index = std::atomic_load(&ctx->index);
+	if (!index) return -1;
+
+	vector<pair<int, int>> hits;
+	findInBox(*index, xMin, yMin, xMax, yMax, hits);
+	for (int k = 0; k < capacity && k < (int)hits.size(); k++)
+	{
+		roadIds[k] = hits[k].first;
+		laneIds[k] = hits[k].second;
+	}
+	return (int)hits.size();
+}
+
+EXPORTED int contextIntersectSegment(generatorContext* ctx, double x1, double y1, double x2, double y2, int* roadId, int* laneId, double* s, double* fraction){
+	if (ctx == NULL || roadId == NULL || laneId == NULL || s == NULL || fraction == NULL) return -1;
+	std::shared_ptr<const spatialIndex> index = std::atomic_load(&ctx->index);
+	if (!index) return -1;
+
+	spatialHit hit;
+	if (firstIntersection(*index, x1, y1, x2, y2, hit)) return 1;
+	*roadId = hit.road;
+	*laneId = hit.lane;
+	*s = hit.s;
+	*fraction = hit.distance;
+	return 0;
+}
+
+/**
+ * @brief runs the generation steps on a parsed input and creates the output. The thread local settings have to be set up already
+ * 
+ * @param input 		input model of the run
+ * @param outputFile 	output file without extension
+ * @param buffer 		if set, the output is stored in the buffer instead of the output file
+ * @param writeFiles 	if set, the requested results like the lane graph are written next to the output file.
+ * 						Independent of the buffer, because the caller can write a buffered output to the output file
+ * @param incremental 	if set, unchanged segments are taken from the previous run and the results are stored for the next run
+ * @param index 		if set, the spatial index of the generated network is built
+ * @param graph 		if set, the lane graph of the generated network is built and written next to the output file
+ * @param report 		if set, the connectivity of the generated network is analyzed and the report is written next to the output file
+ * @param profile 		if set, the times of the stages and segments and the size of the network are recorded
+ * @return int 			error code
+ */
+int generateNetwork(const inputModel &input, const string &outputFile, string *buffer, bool writeFiles, incrementalState *incremental, spatialIndex *index, laneGraph *graph,
+					networkReport *report, pipelineProfile *profile)
+{
+	roadNetwork data;
+	data.outputFile = outputFile;
+
+	if (incremental != NULL)
+	{
+		// results of other settings can not be reused
+		string settings = settingsKey();
+		if (incremental->settingsKey != settings)
+			incremental->valid = false;
+
+		vector<segmentState> segments;
+		profileMark mark = startProfile(profile);
+		if (buildSegmentsIncremental(input, data, *incremental, segments, profile))
+		{
+			cerr << "ERR: error in buildSegments" << endl;
+			return -1;
+		}
+		endStage(profile, "buildSegments", mark);
+
+		mark = startProfile(profile);
+		if (linkSegmentsIncremental(input, data, *incremental, segments))
+		{
+			cerr << "ERR: error in linkSegments" << endl;
+			return -1;
+		}
+		endStage(profile, "linkSegments", mark);
+
+		incremental->segments.swap(segments);
+		incremental->settingsKey = settings;
+		incremental->linksKey = linksKey(input);
+		incremental->valid = true;
+	}
+	else
+	{
+		profileMark mark = startProfile(profile);
+		if (buildSegments(input, data, profile))
+		{
+			cerr << "ERR: error in buildSegments" << endl;
+			return -1;
+		}
+		endStage(profile, "buildSegments", mark);
+
+		mark = startProfile(profile);
+		if (linkSegments(input, data))
+		{
+			cerr << "ERR: error in linkSegments" << endl;
+			return -1;
+		}
+		endStage(profile, "linkSegments", mark);
+	}
+
+	profileMark mark = startProfile(profile);
+	if (closeRoadNetwork(input, data))
+	{
+		cerr << "ERR: error in closeRoadNetwork" << endl;
+		return -1;
+	}
+	endStage(profile, "closeRoadNetwork", mark);
+
+	mark = startProfile(profile);
+	if (setting.snapshot && writeFiles && writeSnapshot(outputFile + ".rgsnap", data))
+	{
+		cerr << "ERR: error in writeSnapshot" << endl;
+		return -1;
+	}
+	if (setting.snapshot && writeFiles)
+		endStage(profile, "writeSnapshot", mark);
+
+	mark = startProfile(profile);
+	if (index != NULL && buildSpatialIndex(data, *index))
+	{
+		cerr << "ERR: error in buildSpatialIndex" << endl;
+		return -1;
+	}
+	if (index != NULL)
+		endStage(profile, "buildSpatialIndex", mark);
+
+	mark = startProfile(profile);
+	if (graph != NULL && buildLaneGraph(data, *graph))
+	{
+		cerr << "ERR: error in buildLaneGraph" << endl;
+		return -1;
+	}
+	if (graph != NULL && writeFiles && writeLaneGraph(outputFile + ".lanegraph", *graph))
+	{
+		cerr << "ERR: error in writeLaneGraph" << endl;
+		return -1;
+	}
+	if (graph != NULL)
+		endStage(profile, "buildLaneGraph", mark);
+
+	mark = startProfile(profile);
+	if (report != NULL)
+	{
+		laneGraph localGraph;
+		if (graph == NULL && buildLaneGraph(data, localGraph))
+		{
+			cerr << "ERR: error in buildLaneGraph" << endl;
+			return -1;
+		}
+		spatialIndex localIndex;
+		if (index == NULL && buildSpatialIndex(data, localIndex))
+		{
+			cerr << "ERR: error in buildSpatialIndex" << endl;
+			return -1;
+		}
+
+		report->problems = analyzeNetwork(data, (graph != NULL) ? *graph : localGraph, (index != NULL) ? *index : localIndex, report->json);
+		if (report->problems > 0)
+			throwWarning("network analysis found " + to_string(report->problems) + " problem(s)", "analyzeNetwork");
+
+		if (writeFiles && writeNetworkReport(outputFile + ".analysis.json", *report))
+		{
+			cerr << "ERR: error in writeNetworkReport" << endl;
+			return -1;
+		}
+		endStage(profile, "analyzeNetwork", mark);
+	}
+	string localBuffer;
+	string &xodr = (buffer != NULL) ? *buffer : localBuffer;
+	if (buffer == NULL && setting.streamingWriter && !setting.outputValidation)
+	{
+		// nothing has to be kept in memory, the output is streamed directly to the file
+		mark = startProfile(profile);
+		if (createXMLStreamToFile(data))
+		{
+			cerr << "ERR: error during createXML" << endl;
+			return -1;
+		}
+		endStage(profile, "createXML", mark);
+
+		if (profile != NULL)
+		{
+			ifstream out((outputFile + ".xodr").c_str(), ios::in | ios::binary | ios::ate);
+			profile->outputBytes = out.is_open() ? (long long)out.tellg() : 0;
+		}
+	}
+	else
+	{
+		mark = startProfile(profile);
+		xodrWriter writer(xodr);
+		int err = (setting.streamingWriter) ? createXMLStream(data, writer) : createXMLXercesC(data, xodr);
+		if (err)
+		{
+			cerr << "ERR: error during createXML" << endl;
+			return -1;
+		}
+		endStage(profile, "createXML", mark);
+
+		mark = startProfile(profile);
+		if (buffer == NULL && writeOutput(data, xodr))
+		{
+			cerr << "ERR: error in writeOutput" << endl;
+			return -1;
+		}
+		if (buffer == NULL)
+			endStage(profile, "writeOutput", mark);
+
+		if (profile != NULL)
+			profile->outputBytes = xodr.size();
+	}
+
+	mark = startProfile(profile);
+	if (setting.outputValidation && validateOutput(xodr))
+	{
+		cerr << "ERR: error in validateOutput" << endl;
+		return -1;
+	}
+	if (setting.outputValidation)
+		endStage(profile, "validateOutput", mark);
+
+	if (profile != NULL)
+		countNetwork(data, *profile);
+
+	//warning handling
+	if(setting.warnings > 0)
+	{
+		cout << "\nFinished with " << setting.warnings << " warning(s), check out the error log for more information." << endl;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief converts a validated input tree and generates the network. If the output cache is enabled, a cached output of the same input
+ * and settings is returned without running the generation
+ * 
+ * @param root 			root of the validated input tree
+ * @param outputFile 	output file without extension
+ * @param buffer 		if set, the output is stored in the buffer instead of the output file
+ * @param incremental 	results of the previous run of the context, NULL if the incremental mode is disabled
+ * @param index 		if set, the spatial index of the generated network is built, NULL if no index is requested
+ * @param graph 		if set, the lane graph of the generated network is built, NULL if no graph is requested
+ * @param report 		if set, the connectivity of the generated network is analyzed, NULL if no report is requested
+ * @param profile 		if set, the times of the stages and segments are recorded, NULL if no profile is requested
+ * @return int 			error code
+ */
+int generateFromTree(DOMElement *root, const string &outputFile, string *buffer, incrementalState *incremental, spatialIndex *index, laneGraph *graph,
+					 networkReport *report, pipelineProfile *profile)
+{
+	string key;
+	string xodr;
+	if (!setting.cacheDirectory.empty())
+	{
+		profileMark mark = startProfile(profile);
+		key = cacheKey(root);
+
+		// the index, the lane graph, the report and the snapshot need the network, so a cached output can not be used
+		if (index == NULL && graph == NULL && report == NULL && !setting.snapshot && !readCacheEntry(key, xodr))
+		{
+			endStage(profile, "readCache", mark);
+			if(!setting.silentMode)
+				cout << "Output taken from cache" << endl;
+
+			if (profile != NULL)
+			{
+				profile->cached = true;
+				profile->outputBytes = xodr.size();
+			}
+
+			mark = startProfile(profile);
+			if (buffer != NULL)
+				buffer->swap(xodr);
+			else if (writeOutput(outputFile, xodr))
+			{
+				cerr << "ERR: error in writeOutput" << endl;
+				return -1;
+			}
+			if (buffer == NULL)
+				endStage(profile, "writeOutput", mark);
+			return 0;
+		}
+		endStage(profile, "readCache", mark);
+	}
+
+	profileMark mark = startProfile(profile);
+	inputModel input;
+	if (parseInput(root, input))
+	{
+		cerr << "ERR: error in parseInput" << endl;
+		return -1;
+	}
+	endStage(profile, "parseInput", mark);
+
+	std::unique_lock<std::mutex> lock;
+	if (incremental != NULL)
+		lock = std::unique_lock<std::mutex>(incremental->mtx);
+
+	if (key.empty())
+		return generateNetwork(input, outputFile, buffer, buffer == NULL, incremental, index, graph, report, profile);
+
+	// the output is kept in memory to store it in the cache
+	if (generateNetwork(input, outputFile, &xodr, buffer == NULL, incremental, index, graph, report, profile))
+		return -1;
+
+	mark = startProfile(profile);
+	if (writeCacheEntry(key, xodr))
+		cerr << "ERR: output can not be stored in cache " << setting.cacheDirectory << endl;
+	endStage(profile, "writeCache", mark);
+
+	mark = startProfile(profile);
+	if (buffer != NULL)
+		buffer->swap(xodr);
+	else if (writeOutput(outputFile, xodr))
+	{
+		cerr << "ERR: error in writeOutput" << endl;
+		return -1;
 	}
+	if (buffer == NULL)
+		endStage(profile, "writeOutput", mark);
+	return 0;
+}
 
-	(void)! freopen(_logfile.c_str(), (setting.overwriteLog)? "w":"a", stderr); //(void)! suppresses the unused return warning..
+/**
+ * @brief runs all pipeline steps for the input file of a context. The thread local settings have to be set up already
+ * 
+ * @param ctx 		context of the run
+ * @param buffer 	if set, the output is stored in the buffer instead of the output file
+ * @return int 		error code
+ */
+int runPipeline(generatorContext &ctx, string *buffer)
+{
+	const char *file = ctx.fileName.c_str();
 
 	char dt[100];
 	getTimeStamp(dt);
@@ -110,52 +703,244 @@ EXPORTED int executePipeline(char* file)
 
 	xmlTree inputxml;
 
-	roadNetwork data;
-	string outputFile = _outName;
-	data.outputFile = outputFile.substr(0, outputFile.find(".xml"));
-    data.outputFile = data.outputFile.substr(0, outputFile.find(".xodr"));
+	string outputFile = (ctx.setOutput) ? ctx.outName : ctx.fileName;
+	outputFile = outputFile.substr(0, outputFile.find(".xml"));
+	outputFile = outputFile.substr(0, outputFile.find(".xodr"));
 
 	setting.warnings = 0;
+
+	std::shared_ptr<pipelineProfile> profile = (ctx.buildProfile) ? std::make_shared<pipelineProfile>() : nullptr;
+	profileMark start = startProfile(profile.get());
 	
 	// --- pipeline ------------------------------------------------------------
-	if (validateInput(file, inputxml))
+	if (validateInput(&ctx.fileName[0], inputxml))
 	{
 		cerr << "ERR: error in validateInput" << endl;
 		return -1;
 	}
+	endStage(profile.get(), "validateInput", start);
 
-	if (buildSegments(inputxml, data))
-	{
-		cerr << "ERR: error in buildSegments" << endl;
+	std::shared_ptr<spatialIndex> index = (ctx.buildIndex) ? std::make_shared<spatialIndex>() : nullptr;
+	std::shared_ptr<laneGraph> graph = (ctx.buildGraph) ? std::make_shared<laneGraph>() : nullptr;
+	std::shared_ptr<networkReport> report = (ctx.buildReport) ? std::make_shared<networkReport>() : nullptr;
+	std::shared_ptr<incrementalState> incremental = std::atomic_load(&ctx.incremental);
+	if (generateFromTree(inputxml.getRootElement(), outputFile, buffer, incremental.get(), index.get(), graph.get(), report.get(), profile.get()))
 		return -1;
-	}
-	if (linkSegments(inputxml, data))
+
+	if (profile)
 	{
-		cerr << "ERR: error in linkSegments" << endl;
+		finishProfile(*profile, start);
+		if (buffer == NULL && writeProfile(outputFile + ".profile.json", *profile))
+		{
+			cerr << "ERR: error in writeProfile" << endl;
+			return -1;
+		}
+	}
+
+	// the results are replaced after the run, so concurrent queries keep using the previous ones
+	if (index)
+		std::atomic_store(&ctx.index, std::shared_ptr<const spatialIndex>(index));
+	if (graph)
+		std::atomic_store(&ctx.graph, std::shared_ptr<const laneGraph>(graph));
+	if (report)
+		std::atomic_store(&ctx.report, std::shared_ptr<const networkReport>(report));
+	if (profile)
+		std::atomic_store(&ctx.profile, std::shared_ptr<const pipelineProfile>(profile));
+	return 0;
+}
+
+/**
+ * @brief sets up the thread local state and the error log for a context and runs the pipeline
+ * 
+ * @param ctx 		context of the run
+ * @param buffer 	if set, the output is stored in the buffer instead of the output file
+ * @return int 		error code
+ */
+int execContext(generatorContext* ctx, string *buffer)
+{
+	if (ctx == NULL || ctx->fileName.empty()){
+		cout << "ERR: no file has been provided!" << endl;
 		return -1;
 	}
-	if (closeRoadNetwork(inputxml, data))
+
+	// every thread works on its own copy of the settings
+	setting = ctx->setting;
+
+	acquireLog(ctx->logfile, setting.overwriteLog);
+	int res = runPipeline(*ctx, buffer);
+	releaseLog();
+
+	ctx->warnings = setting.warnings;
+	return res;
+}
+
+EXPORTED int contextExecPipeline(generatorContext* ctx)
+{
+	return execContext(ctx, NULL);
+}
+
+EXPORTED int contextExecPipelineToBuffer(generatorContext* ctx, char** buffer, size_t* size)
+{
+	if (buffer == NULL || size == NULL) return -1;
+	*buffer = NULL;
+	*size = 0;
+
+	string xodr;
+	int res = execContext(ctx, &xodr);
+	if (res != 0) return res;
+
+	// the buffer is null terminated for convenience, size holds the length of the document
+	*buffer = (char*)malloc(xodr.size() + 1);
+	if (*buffer == NULL) return -1;
+	memcpy(*buffer, xodr.c_str(), xodr.size() + 1);
+	*size = xodr.size();
+
+	return 0;
+}
+
+EXPORTED int execPipelineToBuffer(char** buffer, size_t* size)
+{
+	return contextExecPipelineToBuffer(&defaultContext, buffer, size);
+}
+
+EXPORTED void freeBuffer(char* buffer)
+{
+	free(buffer);
+}
+
+EXPORTED int convertSnapshot(const char* snapshotFile, const char* outName)
+{
+	if (snapshotFile == NULL || outName == NULL) return -1;
+
+	roadNetwork data;
+	if (readSnapshot(snapshotFile, data))
 	{
-		cerr << "ERR: error in closeRoadNetwork" << endl;
+		cerr << "ERR: error in readSnapshot" << endl;
 		return -1;
 	}
-	if (createXMLXercesC(data))
+
+	// the snapshot holds the final network, so only the writer is run with the default settings
+	setting = settings();
+	data.outputFile = outName;
+	data.outputFile = data.outputFile.substr(0, data.outputFile.find(".xodr"));
+	if (createXMLStreamToFile(data))
 	{
 		cerr << "ERR: error during createXML" << endl;
 		return -1;
 	}
+	return 0;
+}
 
-	if (validateOutput(data))
-	{
-		cerr << "ERR: error in validateOutput" << endl;
+/**
+ * @brief runs a batch and writes the summary
+ * 
+ * @param ctx 			template context
+ * @param files 		input files
+ * @param nThreads 		number of worker threads
+ * @param summaryFile 	csv summary file, can be NULL
+ * @return int 			number of failed files, -1 on error
+ */
+int execBatch(generatorContext* ctx, const vector<string> &files, int nThreads, const char* summaryFile)
+{
+	if (ctx == NULL) return -1;
+
+	vector<batchResult> results;
+	int nFailed = runBatch(*ctx, files, nThreads, results);
+
+	if (summaryFile != NULL && writeBatchSummary(summaryFile, results))
+		return -1;
+
+	if(!ctx->setting.silentMode)
+		cout << "\nBatch finished: " << files.size() - nFailed << " of " << files.size() << " file(s) generated successfully." << endl;
+
+	return nFailed;
+}
+
+EXPORTED int contextExecBatch(generatorContext* ctx, const char** files, int nFiles, int nThreads, const char* summaryFile)
+{
+	if (files == NULL && nFiles > 0) return -1;
+
+	vector<string> fileList;
+	for (int k = 0; k < nFiles; k++)
+		fileList.push_back(files[k]);
+
+	return execBatch(ctx, fileList, nThreads, summaryFile);
+}
+
+EXPORTED int contextExecBatchDir(generatorContext* ctx, const char* dir, int nThreads, const char* summaryFile)
+{
+	if (dir == NULL){
+		cout << "ERR: no directory has been provided!" << endl;
 		return -1;
 	}
 
-	//warning handling
-	if(setting.warnings > 0)
+	vector<string> fileList;
+	if (listInputFiles(dir, fileList))
+		return -1;
+
+	return execBatch(ctx, fileList, nThreads, summaryFile);
+}
+
+EXPORTED int executeBatch(const char** files, int nFiles, int nThreads, const char* summaryFile)
+{
+	return contextExecBatch(&defaultContext, files, nFiles, nThreads, summaryFile);
+}
+
+EXPORTED int executeBatchDir(const char* dir, int nThreads, const char* summaryFile)
+{
+	return contextExecBatchDir(&defaultContext, dir, nThreads, summaryFile);
+}
+
+/**
+ * @brief prepares a template and generates all of its variants
+ * 
+ * @param ctx 			context holding the settings
+ * @param templateFile 	template file
+ * @param nVariants 	number of variants
+ * @param seed 			seed of the random generator
+ * @param nThreads 		number of worker threads
+ * @param summaryFile 	csv summary file, can be NULL
+ * @return int 			number of failed variants, -1 on error
+ */
+int execVariation(generatorContext* ctx, const char* templateFile, int nVariants, unsigned int seed, int nThreads, const char* summaryFile)
+{
+	if (ctx == NULL) return -1;
+	if (templateFile == NULL){
+		cout << "ERR: no file has been provided!" << endl;
+		return -1;
+	}
+
+	variationTemplate t;
+	if (prepareVariation(templateFile, nVariants, seed, t))
 	{
-		cout << "\nFinished with " << setting.warnings << " warning(s), check out the error log for more information." << endl;
+		cerr << "ERR: error in prepareVariation" << endl;
+		return -1;
 	}
 
-	return 0;
+	// the variants are named after the output name or the template
+	string prefix = (ctx->setOutput && !ctx->outName.empty()) ? ctx->outName : templateFile;
+	size_t ext = prefix.find_last_of('.');
+	if (ext != string::npos && ext > prefix.find_last_of("/\\") + 1)
+		prefix = prefix.substr(0, ext);
+
+	vector<batchResult> results;
+	int nFailed = runVariation(*ctx, t, prefix, nThreads, results);
+
+	if (summaryFile != NULL && writeBatchSummary(summaryFile, results))
+		return -1;
+
+	if(!ctx->setting.silentMode)
+		cout << "\nVariation finished: " << results.size() - nFailed << " of " << results.size() << " variant(s) generated successfully." << endl;
+
+	return nFailed;
+}
+
+EXPORTED int contextExecVariation(generatorContext* ctx, const char* templateFile, int nVariants, unsigned int seed, int nThreads, const char* summaryFile)
+{
+	return execVariation(ctx, templateFile, nVariants, seed, nThreads, summaryFile);
+}
+
+EXPORTED int executeVariation(const char* templateFile, int nVariants, unsigned int seed, int nThreads, const char* summaryFile)
+{
+	return contextExecVariation(&defaultContext, templateFile, nVariants, seed, nThreads, summaryFile);
 }
@@ -24,11 +24,13 @@
 #endif
 
 #include<string>
+#include<stddef.h>
 
-bool _setOutput = false;
-char* _fileName;
-std::string _outName = "";
-std::string _logfile = "log.txt";
+/**
+ * @brief opaque handle of a generator. A context owns all state of a pipeline run,
+ * different contexts can be executed concurrently from different threads
+ */
+typedef struct generatorContext generatorContext;
 
 /**
  * @brief Sets the filename of the input file
@@ -78,7 +80,503 @@ extern "C" EXPORTED void setSilentMode(bool sMode);
  */
 extern "C" EXPORTED void setOverwriteLog(bool b);
 
+/**
+ * @brief enables or disables the validation of the generated output against the output schema
+ *  @param b false skips the output validation, e.g. for trusted templates
+ */
+extern "C" EXPORTED void setOutputValidation(bool b);
+
+/**
+ * @brief selects the streaming writer for the output instead of the xerces DOM
+ *  @param b true enables the streaming writer
+ */
+extern "C" EXPORTED void setStreamingWriter(bool b);
 
+/**
+ * @brief enables the binary snapshot of the generated network. After every run the network is written to <output name>.rgsnap,
+ * which can be loaded much faster than the OpenDRIVE output. A cached output is not used while the snapshot is enabled
+ *  @param b true enables the snapshot
+ */
+extern "C" EXPORTED void setSnapshot(bool b);
 
-#endif
+/**
+ * @brief enables the output cache. Generated networks are stored in the directory keyed on the normalized input and the settings,
+ * a run with the same input returns the stored network without generating it again
+ *  @param dir cache directory, NULL or an empty string disables the cache
+ */
+extern "C" EXPORTED void setCacheDirectory(char* dir);
+
+/**
+ * @brief enables the incremental mode. Every run keeps the generated segments, the next run only regenerates
+ * the segments whose input changed and relinks the segments which are affected by them
+ *  @param b true to enable, false disables the mode and drops the stored results
+ */
+extern "C" EXPORTED void setIncremental(bool b);
+
+/**
+ * @brief set the number of worker threads which build the segments of a file. The output does not depend on the number of threads
+ *  @param n number of threads, 1 builds the segments serially (default), 0 uses all available cores
+ */
+extern "C" EXPORTED void setSegmentThreads(int n);
+
+/**
+ * @brief enables the spatial index. After every run the sampled reference lines and lane outlines of the network are stored in a grid,
+ * which can be queried with the functions below. A cached output is not used while the index is enabled
+ *  @param b true to enable, false disables the index and drops the stored one
+ */
+extern "C" EXPORTED void setSpatialIndex(bool b);
+
+/**
+ * @brief enables the lane graph. After every run the lanes of the network and their links are stored as routing graph,
+ * which is written to <output name>.lanegraph and can be queried with shortestLanePath. A cached output is not used while the graph is enabled
+ *  @param b true to enable, false disables the graph and drops the stored one
+ */
+extern "C" EXPORTED void setLaneGraph(bool b);
+
+/**
+ * @brief finds the fastest path between two lanes of the last generated network. The path starts at the first section
+ * of the start lane in driving direction and ends at the first reached section of the target lane
+ * @param fromRoad road id of the start lane
+ * @param fromLane lane id of the start lane
+ * @param toRoad road id of the target lane
+ * @param toLane lane id of the target lane
+ * @param roadIds road ids of the lanes of the path
+ * @param sectionIds lane section indices of the lanes of the path
+ * @param laneIds lane ids of the lanes of the path
+ * @param capacity length of the result arrays, further lanes are dropped
+ * @param cost travel time from the start of the first to the start of the last lane in seconds
+ * @return int number of lanes of the path, which can exceed the capacity, 0 if there is no path, -1 if no graph is available
+ */
+extern "C" EXPORTED int shortestLanePath(int fromRoad, int fromLane, int toRoad, int toLane, int* roadIds, int* sectionIds, int* laneIds, int capacity, double* cost);
+
+/**
+ * @brief enables the network analysis. After every run the driving lanes of the network are checked for disconnected components,
+ * missing successors or predecessors and unreachable junction connections, the lane outlines are checked for overlapping roads
+ * and self-intersections outside of junctions. The json report is written to <output name>.analysis.json
+ * and can be read with getNetworkReport. A cached output is not used while the analysis is enabled
+ *  @param b true to enable, false disables the analysis and drops the stored report
+ */
+extern "C" EXPORTED void setNetworkAnalysis(bool b);
+
+/**
+ * @brief returns the json report of the connectivity analysis of the last generated network
+ * @param buffer set to the null terminated report, has to be released with freeBuffer
+ * @param size set to the length of the report in bytes
+ * @return int number of problems, -1 if no report is available
+ */
+extern "C" EXPORTED int getNetworkReport(char** buffer, size_t* size);
+
+/**
+ * @brief enables the profiling of the pipeline. Every run records the wall and cpu time of its stages and segment types,
+ * the peak memory usage of the process, the size of the network and of the output. The json report is written to
+ * <output name>.profile.json and can be read with getProfile. Cpu times are measured on the thread of the run and its
+ * segment workers, the memory usage is measured for the whole process, so it includes concurrent runs of other contexts
+ *  @param b true to enable, false disables the profiling and drops the stored profile
+ */
+extern "C" EXPORTED void setProfiling(bool b);
+
+/**
+ * @brief returns the json profile of the last run
+ * @param buffer set to the null terminated profile, has to be released with freeBuffer
+ * @param size set to the length of the profile in bytes
+ * @return int error code, -1 if no profile is available
+ */
+extern "C" EXPORTED int getProfile(char** buffer, size_t* size);
+
+/**
+ * @brief finds the closest reference line of the last generated network
+ * @param x x coordinate of the point
+ * @param y y coordinate of the point
+ * @param roadId id of the closest road
+ * @param s s position of the closest point on the reference line
+ * @param t signed lateral offset of the point, positive on the left side
+ * @return int 0 on success, 1 if the network has no roads, -1 if no index is available
+ */
+extern "C" EXPORTED int nearestRoad(double x, double y, int* roadId, double* s, double* t);
+
+/**
+ * @brief finds the closest lane of the last generated network
+ * @param x x coordinate of the point
+ * @param y y coordinate of the point
+ * @param roadId id of the road of the closest lane
+ * @param laneId id of the closest lane
+ * @param s s position of the closest point
+ * @param distance distance to the lane outline, 0 if the point is inside of the lane
+ * @return int 0 on success, 1 if the network has no lanes, -1 if no index is available
+ */
+extern "C" EXPORTED int nearestLane(double x, double y, int* roadId, int* laneId, double* s, double* distance);
+
+/**
+ * @brief finds all lanes and reference lines of the last generated network which overlap a box
+ * @param xMin minimal x coordinate of the box
+ * @param yMin minimal y coordinate of the box
+ * @param xMax maximal x coordinate of the box
+ * @param yMax maximal y coordinate of the box
+ * @param roadIds road ids of the results
+ * @param laneIds lane ids of the results, 0 for the reference line
+ * @param capacity length of the result arrays, further results are dropped
+ * @return int total number of results, which can exceed the capacity, -1 if no index is available
+ */
+extern "C" EXPORTED int queryBox(double xMin, double yMin, double xMax, double yMax, int* roadIds, int* laneIds, int capacity);
+
+/**
+ * @brief finds the first lane or reference line of the last generated network which is crossed by a segment
+ * @param x1 x coordinate of the start of the segment
+ * @param y1 y coordinate of the start of the segment
+ * @param x2 x coordinate of the end of the segment
+ * @param y2 y coordinate of the end of the segment
+ * @param roadId id of the road
+ * @param laneId id of the lane, 0 for the reference line
+ * @param s s position of the intersection
+ * @param fraction position of the intersection on the segment, 0 at the start and 1 at the end
+ * @return int 0 on success, 1 if the segment does not intersect the network, -1 if no index is available
+ */
+extern "C" EXPORTED int intersectSegment(double x1, double y1, double x2, double y2, int* roadId, int* laneId, double* s, double* fraction);
+
+/**
+ * @brief get the number of cache hits of all runs of the process
+ * @return long long number of hits
+ */
+extern "C" EXPORTED long long getCacheHits();
+
+/**
+ * @brief get the number of cache misses of all runs of the process
+ * @return long long number of misses
+ */
+extern "C" EXPORTED long long getCacheMisses();
+
+/**
+ * @brief resets the cache hit and miss counters
+ */
+extern "C" EXPORTED void resetCacheStatistics();
+
+/**
+ * @brief creates a new generator context with default settings
+ * @return generatorContext* handle which has to be released with destroyContext
+ */
+extern "C" EXPORTED generatorContext* createContext();
+
+/**
+ * @brief releases a generator context
+ * @param ctx context to release
+ */
+extern "C" EXPORTED void destroyContext(generatorContext* ctx);
+
+/**
+ * @brief sets the filename of the input file of a context
+ * @param ctx context
+ * @param file file name
+ */
+extern "C" EXPORTED void contextSetFileName(generatorContext* ctx, const char* file);
+
+/**
+ * @brief sets the output file name of a context
+ * @param ctx context
+ * @param file output file
+ */
+extern "C" EXPORTED void contextSetOutputName(generatorContext* ctx, const char* file);
+
+/**
+ * @brief set path to xml schema files of a context
+ * @param ctx context
+ * @param file set path
+ */
+extern "C" EXPORTED void contextSetXMLSchemeLocation(generatorContext* ctx, const char* file);
+
+/**
+ * @brief set log file location of a context
+ * @param ctx context
+ * @param file set file location
+ */
+extern "C" EXPORTED void contextSetLogFile(generatorContext* ctx, const char* file);
+
+/**
+ * @brief sets the silent mode of a context
+ * @param ctx context
+ * @param sMode sets silent mode to True or False
+ */
+extern "C" EXPORTED void contextSetSilentMode(generatorContext* ctx, bool sMode);
+
+/**
+ * @brief set overwriting the error log of a context
+ * @param ctx context
+ * @param b true if errorlog should be overwritten
+ */
+extern "C" EXPORTED void contextSetOverwriteLog(generatorContext* ctx, bool b);
+
+/**
+ * @brief enables or disables the validation of the generated output of a context
+ * @param ctx context
+ * @param b false skips the output validation, e.g. for trusted templates
+ */
+extern "C" EXPORTED void contextSetOutputValidation(generatorContext* ctx, bool b);
+
+/**
+ * @brief selects the streaming writer for the output of a context instead of the xerces DOM
+ * @param ctx context
+ * @param b true enables the streaming writer
+ */
+extern "C" EXPORTED void contextSetStreamingWriter(generatorContext* ctx, bool b);
+
+/**
+ * @brief enables the binary snapshot of the generated network of a context
+ * @param ctx context
+ * @param b true enables the snapshot
+ */
+extern "C" EXPORTED void contextSetSnapshot(generatorContext* ctx, bool b);
+
+/**
+ * @brief enables the output cache of a context
+ * @param ctx context
+ * @param dir cache directory, NULL or an empty string disables the cache
+ */
+extern "C" EXPORTED void contextSetCacheDirectory(generatorContext* ctx, const char* dir);
+
+/**
+ * @brief enables the incremental mode of a context. Runs of the context are serialized while the mode is enabled
+ * @param ctx context
+ * @param b true to enable, false disables the mode and drops the stored results
+ */
+extern "C" EXPORTED void contextSetIncremental(generatorContext* ctx, bool b);
+
+/**
+ * @brief set the number of worker threads which build the segments of a context
+ * @param ctx context
+ * @param n number of threads, 1 builds the segments serially (default), 0 uses all available cores
+ */
+extern "C" EXPORTED void contextSetSegmentThreads(generatorContext* ctx, int n);
+
+/**
+ * @brief enables the spatial index of a context. The index of the last successful run is kept,
+ * queries can run concurrently to the next run of the context
+ * @param ctx context
+ * @param b true to enable, false disables the index and drops the stored one
+ */
+extern "C" EXPORTED void contextSetSpatialIndex(generatorContext* ctx, bool b);
+
+/**
+ * @brief enables the lane graph of a context. The graph of the last successful run is kept,
+ * queries can run concurrently to the next run of the context
+ * @param ctx context
+ * @param b true to enable, false disables the graph and drops the stored one
+ */
+extern "C" EXPORTED void contextSetLaneGraph(generatorContext* ctx, bool b);
 
+/**
+ * @brief finds the fastest path between two lanes of the network of a context, see shortestLanePath
+ * @param ctx context
+ * @param fromRoad road id of the start lane
+ * @param fromLane lane id of the start lane
+ * @param toRoad road id of the target lane
+ * @param toLane lane id of the target lane
+ * @param roadIds road ids of the lanes of the path
+ * @param sectionIds lane section indices of the lanes of the path
+ * @param laneIds lane ids of the lanes of the path
+ * @param capacity length of the result arrays, further lanes are dropped
+ * @param cost travel time from the start of the first to the start of the last lane in seconds
+ * @return int number of lanes of the path, which can exceed the capacity, 0 if there is no path, -1 if no graph is available
+ */
+extern "C" EXPORTED int contextShortestLanePath(generatorContext* ctx, int fromRoad, int fromLane, int toRoad, int toLane, int* roadIds, int* sectionIds, int* laneIds, int capacity, double* cost);
+
+/**
+ * @brief enables the connectivity analysis of a context, see setNetworkAnalysis
+ * @param ctx context
+ * @param b true to enable, false disables the analysis and drops the stored report
+ */
+extern "C" EXPORTED void contextSetNetworkAnalysis(generatorContext* ctx, bool b);
+
+/**
+ * @brief returns the json report of the connectivity analysis of the last successful run of a context
+ * @param ctx context
+ * @param buffer set to the null terminated report, has to be released with freeBuffer
+ * @param size set to the length of the report in bytes
+ * @return int number of problems, -1 if no report is available
+ */
+extern "C" EXPORTED int contextGetNetworkReport(generatorContext* ctx, char** buffer, size_t* size);
+
+/**
+ * @brief enables the profiling of the runs of a context
+ * @param ctx context
+ * @param b true to enable, false disables the profiling and drops the stored profile
+ */
+extern "C" EXPORTED void contextSetProfiling(generatorContext* ctx, bool b);
+
+/**
+ * @brief returns the json profile of the last successful run of a context
+ * @param ctx context
+ * @param buffer set to the null terminated profile, has to be released with freeBuffer
+ * @param size set to the length of the profile in bytes
+ * @return int error code, -1 if no profile is available
+ */
+extern "C" EXPORTED int contextGetProfile(generatorContext* ctx, char** buffer, size_t* size);
+
+/**
+ * @brief finds the closest reference line of the network of a context, see nearestRoad
+ * @param ctx context
+ * @param x x coordinate of the point
+ * @param y y coordinate of the point
+ * @param roadId id of the closest road
+ * @param s s position of the closest point on the reference line
+ * @param t signed lateral offset of the point, positive on the left side
+ * @return int 0 on success, 1 if the network has no roads, -1 if no index is available
+ */
+extern "C" EXPORTED int contextNearestRoad(generatorContext* ctx, double x, double y, int* roadId, double* s, double* t);
+
+/**
+ * @brief finds the closest lane of the network of a context, see nearestLane
+ * @param ctx context
+ * @param x x coordinate of the point
+ * @param y y coordinate of the point
+ * @param roadId id of the road of the closest lane
+ * @param laneId id of the closest lane
+ * @param s s position of the closest point
+ * @param distance distance to the lane outline, 0 if the point is inside of the lane
+ * @return int 0 on success, 1 if the network has no lanes, -1 if no index is available
+ */
+extern "C" EXPORTED int contextNearestLane(generatorContext* ctx, double x, double y, int* roadId, int* laneId, double* s, double* distance);
+
+/**
+ * @brief finds all lanes and reference lines of the network of a context which overlap a box, see queryBox
+ * @param ctx context
+ * @param xMin minimal x coordinate of the box
+ * @param yMin minimal y coordinate of the box
+ * @param xMax maximal x coordinate of the box
+ * @param yMax maximal y coordinate of the box
+ * @param roadIds road ids of the results
+ * @param laneIds lane ids of the results, 0 for the reference line
+ * @param capacity length of the result arrays, further results are dropped
+ * @return int total number of results, which can exceed the capacity, -1 if no index is available
+ */
+extern "C" EXPORTED int contextQueryBox(generatorContext* ctx, double xMin, double yMin, double xMax, double yMax, int* roadIds, int* laneIds, int capacity);
+
+/**
+ * @brief finds the first lane or reference line of the network of a context which is crossed by a segment, see intersectSegment
+ * @param ctx context
+ * @param x1 x coordinate of the start of the segment
+ * @param y1 y coordinate of the start of the segment
+ * @param x2 x coordinate of the end of the segment
+ * @param y2 y coordinate of the end of the segment
+ * @param roadId id of the road
+ * @param laneId id of the lane, 0 for the reference line
+ * @param s s position of the intersection
+ * @param fraction position of the intersection on the segment, 0 at the start and 1 at the end
+ * @return int 0 on success, 1 if the segment does not intersect the network, -1 if no index is available
+ */
+extern "C" EXPORTED int contextIntersectSegment(generatorContext* ctx, double x1, double y1, double x2, double y2, int* roadId, int* laneId, double* s, double* fraction);
+
+/**
+ * @brief execute the pipeline on the input file of a context
+ * @param ctx context
+ * @return int error code
+ */
+extern "C" EXPORTED int contextExecPipeline(generatorContext* ctx);
+
+/**
+ * @brief execute the pipeline on the input file of a context and return the generated OpenDRIVE document in a buffer.
+ * No output file is written
+ * @param ctx context
+ * @param buffer set to the null terminated document, has to be released with freeBuffer. NULL if the pipeline failed
+ * @param size set to the length of the document in bytes
+ * @return int error code
+ */
+extern "C" EXPORTED int contextExecPipelineToBuffer(generatorContext* ctx, char** buffer, size_t* size);
+
+/**
+ * @brief execute the pipeline on fileName that is stored in settings and return the generated OpenDRIVE document in a buffer.
+ * No output file is written
+ * @param buffer set to the null terminated document, has to be released with freeBuffer. NULL if the pipeline failed
+ * @param size set to the length of the document in bytes
+ * @return int error code
+ */
+extern "C" EXPORTED int execPipelineToBuffer(char** buffer, size_t* size);
+
+/**
+ * @brief releases a buffer returned by the library
+ * @param buffer buffer to release
+ */
+extern "C" EXPORTED void freeBuffer(char* buffer);
+
+/**
+ * @brief converts a binary snapshot of a network to an OpenDRIVE file without running the generation
+ * @param snapshotFile snapshot file written by a run with enabled snapshot
+ * @param outName output file, the extension .xodr is added
+ * @return int error code
+ */
+extern "C" EXPORTED int convertSnapshot(const char* snapshotFile, const char* outName);
+
+/**
+ * @brief get the number of warnings of the last run of a context
+ * @param ctx context
+ * @return int number of warnings
+ */
+extern "C" EXPORTED int contextGetWarnings(generatorContext* ctx);
+
+
+
+/**
+ * @brief execute the pipeline for multiple input files on a pool of worker threads. The settings of the context are used for all files,
+ * every output is written next to its input file
+ * @param ctx context holding the settings
+ * @param files input files
+ * @param nFiles number of input files
+ * @param nThreads number of worker threads, 0 uses all available cores
+ * @param summaryFile csv file for the per file status, NULL disables the summary
+ * @return int number of failed files, -1 if the batch could not be started
+ */
+extern "C" EXPORTED int contextExecBatch(generatorContext* ctx, const char** files, int nFiles, int nThreads, const char* summaryFile);
+
+/**
+ * @brief execute the pipeline for all xml files of a directory on a pool of worker threads
+ * @param ctx context holding the settings
+ * @param dir input directory
+ * @param nThreads number of worker threads, 0 uses all available cores
+ * @param summaryFile csv file for the per file status, NULL disables the summary
+ * @return int number of failed files, -1 if the batch could not be started
+ */
+extern "C" EXPORTED int contextExecBatchDir(generatorContext* ctx, const char* dir, int nThreads, const char* summaryFile);
+
+/**
+ * @brief execute the pipeline for multiple input files with the settings set by the functions above
+ * @param files input files
+ * @param nFiles number of input files
+ * @param nThreads number of worker threads, 0 uses all available cores
+ * @param summaryFile csv file for the per file status, NULL disables the summary
+ * @return int number of failed files, -1 if the batch could not be started
+ */
+extern "C" EXPORTED int executeBatch(const char** files, int nFiles, int nThreads, const char* summaryFile);
+
+/**
+ * @brief execute the pipeline for all xml files of a directory with the settings set by the functions above
+ * @param dir input directory
+ * @param nThreads number of worker threads, 0 uses all available cores
+ * @param summaryFile csv file for the per file status, NULL disables the summary
+ * @return int number of failed files, -1 if the batch could not be started
+ */
+extern "C" EXPORTED int executeBatchDir(const char* dir, int nThreads, const char* summaryFile);
+
+/**
+ * @brief generate seeded variants of a template on a pool of worker threads. The variables of the vars node are drawn once for all variants
+ * and replaced in the parsed template, no intermediate files are written. The variants are stored as <output name>_rev<i>.xodr,
+ * the template name is used if no output name is set
+ * @param ctx context holding the settings
+ * @param templateFile template file containing a vars node
+ * @param nVariants number of variants, a template without variables results in one variant
+ * @param seed seed of the random generator, the same seed results in the same variants
+ * @param nThreads number of worker threads, 0 uses all available cores
+ * @param summaryFile csv file for the per variant status, NULL disables the summary
+ * @return int number of failed variants, -1 if the variation could not be started
+ */
+extern "C" EXPORTED int contextExecVariation(generatorContext* ctx, const char* templateFile, int nVariants, unsigned int seed, int nThreads, const char* summaryFile);
+
+/**
+ * @brief generate seeded variants of a template with the settings set by the functions above
+ * @param templateFile template file containing a vars node
+ * @param nVariants number of variants, a template without variables results in one variant
+ * @param seed seed of the random generator, the same seed results in the same variants
+ * @param nThreads number of worker threads, 0 uses all available cores
+ * @param summaryFile csv file for the per variant status, NULL disables the summary
+ * @return int number of failed variants, -1 if the variation could not be started
+ */
+extern "C" EXPORTED int executeVariation(const char* templateFile, int nVariants, unsigned int seed, int nThreads, const char* summaryFile);
+
+#endif
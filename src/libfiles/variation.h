@@ -0,0 +1,740 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file variation.h
+ *
+ * @brief This file contains the variation engine which generates seeded variants of a template on a pool of worker threads
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <random>
+#include <cmath>
+#include <limits>
+#include <cctype>
+#include <unordered_map>
+
+// defined in export.cpp
+int generateFromTree(DOMElement *root, const string &outputFile, string *buffer, incrementalState *incremental, spatialIndex *index, laneGraph *graph, networkReport *report, pipelineProfile *profile);
+
+enum variableType
+{
+    normalVariable,
+    uniformVariable,
+    lindepVariable
+};
+
+/**
+ * @brief stochastic variable declared in the vars node of a template
+ *
+ */
+struct variable
+{
+    string id;
+    variableType type = normalVariable;
+    double a = 0;   // mu of a normal, min of a uniform variable
+    double b = 0;   // sd of a normal, max of a uniform variable
+    string dp;      // equation of a lindep variable
+};
+
+/**
+ * @brief attribute of the template whose value is a reference ${id} to a variable
+ *
+ */
+struct templateSlot
+{
+    int element = -1;   // index of the element in document order
+    string attribute;
+    int var = -1;
+};
+
+/**
+ * @brief parsed template of a variation run
+ *
+ */
+struct variationTemplate
+{
+    vector<variable> vars;
+    unordered_map<string, int> varIndex;
+    vector<templateSlot> slots;
+
+    string document;                // template without the vars node, slots hold the values of the first variant
+    int variants = 0;
+    vector<vector<double>> values;  // values[variable][variant]
+};
+
+enum opCode
+{
+    pushConstant,
+    pushVariable,
+    addOp,
+    subOp,
+    mulOp,
+    divOp,
+    negOp
+};
+
+/**
+ * @brief instruction of a compiled lindep equation. The equations are evaluated on a stack of value arrays
+ *
+ */
+struct instruction
+{
+    opCode op = pushConstant;
+    double value = 0;   // pushConstant
+    int var = -1;       // pushVariable
+};
+
+/**
+ * @brief state of the compilation of a lindep equation
+ *
+ */
+struct equationCursor
+{
+    const variationTemplate &t;
+    const string &eq;
+    size_t pos;
+    vector<instruction> &code;
+};
+
+int compileSum(equationCursor &c);
+
+/**
+ * @brief skips the whitespaces of an equation
+ *
+ * @param c     equation cursor
+ */
+void skipSpaces(equationCursor &c)
+{
+    while (c.pos < c.eq.size() && isspace((unsigned char)c.eq[c.pos]))
+        c.pos++;
+}
+
+/**
+ * @brief appends an instruction to the compiled equation
+ *
+ * @param c     equation cursor
+ * @param op    operation
+ * @param value constant of pushConstant
+ * @param var   variable of pushVariable
+ */
+void emit(equationCursor &c, opCode op, double value = 0, int var = -1)
+{
+    instruction in;
+    in.op = op;
+    in.value = value;
+    in.var = var;
+    c.code.push_back(in);
+}
+
+/**
+ * @brief function compiles a factor of an equation: number, variable id, parenthesized sum or negated factor
+ *
+ * @param c     equation cursor
+ * @return int  error code
+ */
+int compileFactor(equationCursor &c)
+{
+    skipSpaces(c);
+    if (c.pos >= c.eq.size())
+    {
+        cerr << "ERR: unexpected end of equation '" << c.eq << "'" << endl;
+        return 1;
+    }
+
+    char ch = c.eq[c.pos];
+    if (ch == '-' || ch == '+')
+    {
+        c.pos++;
+        if (compileFactor(c)) return 1;
+        if (ch == '-') emit(c, negOp);
+        return 0;
+    }
+    if (ch == '(')
+    {
+        c.pos++;
+        if (compileSum(c)) return 1;
+        skipSpaces(c);
+        if (c.pos >= c.eq.size() || c.eq[c.pos] != ')')
+        {
+            cerr << "ERR: missing ')' in equation '" << c.eq << "'" << endl;
+            return 1;
+        }
+        c.pos++;
+        return 0;
+    }
+    if (isdigit((unsigned char)ch) || ch == '.')
+    {
+        const char *begin = c.eq.c_str() + c.pos;
+        char *end;
+        double value = strtod(begin, &end);
+        if (end == begin)
+        {
+            cerr << "ERR: invalid number in equation '" << c.eq << "'" << endl;
+            return 1;
+        }
+        c.pos += end - begin;
+        emit(c, pushConstant, value);
+        return 0;
+    }
+    if (isalpha((unsigned char)ch) || ch == '_')
+    {
+        size_t begin = c.pos;
+        while (c.pos < c.eq.size() && (isalnum((unsigned char)c.eq[c.pos]) || c.eq[c.pos] == '_'))
+            c.pos++;
+        string id = c.eq.substr(begin, c.pos - begin);
+
+        unordered_map<string, int>::const_iterator it = c.t.varIndex.find(id);
+        if (it == c.t.varIndex.end())
+        {
+            cerr << "ERR: unknown variable '" << id << "' in equation '" << c.eq << "'" << endl;
+            return 1;
+        }
+        emit(c, pushVariable, 0, it->second);
+        return 0;
+    }
+
+    cerr << "ERR: unexpected character '" << ch << "' in equation '" << c.eq << "'" << endl;
+    return 1;
+}
+
+/**
+ * @brief function compiles a product of factors
+ *
+ * @param c     equation cursor
+ * @return int  error code
+ */
+int compileProduct(equationCursor &c)
+{
+    if (compileFactor(c)) return 1;
+
+    while (true)
+    {
+        skipSpaces(c);
+        if (c.pos >= c.eq.size() || (c.eq[c.pos] != '*' && c.eq[c.pos] != '/'))
+            return 0;
+
+        char op = c.eq[c.pos++];
+        if (compileFactor(c)) return 1;
+        emit(c, (op == '*') ? mulOp : divOp);
+    }
+}
+
+/**
+ * @brief function compiles a sum of products
+ *
+ * @param c     equation cursor
+ * @return int  error code
+ */
+int compileSum(equationCursor &c)
+{
+    if (compileProduct(c)) return 1;
+
+    while (true)
+    {
+        skipSpaces(c);
+        if (c.pos >= c.eq.size() || (c.eq[c.pos] != '+' && c.eq[c.pos] != '-'))
+            return 0;
+
+        char op = c.eq[c.pos++];
+        if (compileProduct(c)) return 1;
+        emit(c, (op == '+') ? addOp : subOp);
+    }
+}
+
+/**
+ * @brief function compiles the equation of a lindep variable into a sequence of stack instructions
+ *
+ * @param t     variation template
+ * @param var   index of the variable
+ * @param code  compiled equation
+ * @return int  error code
+ */
+int compileEquation(const variationTemplate &t, int var, vector<instruction> &code)
+{
+    equationCursor c = {t, t.vars[var].dp, 0, code};
+    if (compileSum(c)) return 1;
+
+    skipSpaces(c);
+    if (c.pos != c.eq.size())
+    {
+        cerr << "ERR: unexpected character '" << c.eq[c.pos] << "' in equation '" << c.eq << "'" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief function sorts the lindep variables topologically, so that every variable is evaluated after the variables it depends on
+ *
+ * @param t         variation template
+ * @param code      compiled equations of all variables
+ * @param var       current variable
+ * @param state     visiting state of all variables: 0 not visited, 1 in progress, 2 done
+ * @param order     resulting order of the lindep variables
+ * @return int      error code
+ */
+int sortEquations(const variationTemplate &t, const vector<vector<instruction>> &code, int var, vector<int> &state, vector<int> &order)
+{
+    if (state[var] == 2) return 0;
+    if (state[var] == 1)
+    {
+        cerr << "ERR: cyclic dependency of variable " << t.vars[var].id << endl;
+        return 1;
+    }
+
+    state[var] = 1;
+    for (const instruction &in : code[var])
+        if (in.op == pushVariable && sortEquations(t, code, in.var, state, order))
+            return 1;
+    state[var] = 2;
+
+    if (t.vars[var].type == lindepVariable)
+        order.push_back(var);
+
+    return 0;
+}
+
+/**
+ * @brief function evaluates a compiled equation for all variants at once
+ *
+ * @param code      compiled equation
+ * @param values    values of all variables, the variables of the equation have to be evaluated already
+ * @param n         number of variants
+ * @param res       values of the equation for all variants
+ */
+void evaluateEquation(const vector<instruction> &code, const vector<vector<double>> &values, int n, vector<double> &res)
+{
+    vector<vector<double>> stack;
+    for (const instruction &in : code)
+    {
+        if (in.op == pushConstant)
+        {
+            stack.push_back(vector<double>(n, in.value));
+            continue;
+        }
+        if (in.op == pushVariable)
+        {
+            stack.push_back(values[in.var]);
+            continue;
+        }
+        if (in.op == negOp)
+        {
+            double *a = stack.back().data();
+            for (int i = 0; i < n; i++)
+                a[i] = -a[i];
+            continue;
+        }
+
+        double *a = stack[stack.size() - 2].data();
+        const double *b = stack.back().data();
+        switch (in.op)
+        {
+            case addOp: for (int i = 0; i < n; i++) a[i] += b[i]; break;
+            case subOp: for (int i = 0; i < n; i++) a[i] -= b[i]; break;
+            case mulOp: for (int i = 0; i < n; i++) a[i] *= b[i]; break;
+            case divOp: for (int i = 0; i < n; i++) a[i] /= b[i]; break;
+            default: break;
+        }
+        stack.pop_back();
+    }
+    res.swap(stack.back());
+}
+
+/**
+ * @brief function draws the values of all variables for all variants. The same seed always results in the same values.
+ * The lindep equations are compiled and sorted once and then evaluated for all variants at once
+ *
+ * @param t         variation template
+ * @param n         number of variants
+ * @param seed      seed of the random generator
+ * @return int      error code
+ */
+int sampleVariables(variationTemplate &t, int n, unsigned int seed)
+{
+    std::mt19937 gen(seed);
+    t.variants = n;
+    t.values.assign(t.vars.size(), vector<double>(n, 0));
+
+    for (size_t k = 0; k < t.vars.size(); k++)
+    {
+        const variable &v = t.vars[k];
+        if (v.type == normalVariable)
+        {
+            std::normal_distribution<double> dist(v.a, v.b);
+            for (int i = 0; i < n; i++)
+                t.values[k][i] = dist(gen);
+        }
+        else if (v.type == uniformVariable)
+        {
+            std::uniform_real_distribution<double> dist(v.a, v.b);
+            for (int i = 0; i < n; i++)
+                t.values[k][i] = dist(gen);
+        }
+    }
+
+    // --- lindep variables ----------------------------------------------------
+    vector<vector<instruction>> code(t.vars.size());
+    for (size_t k = 0; k < t.vars.size(); k++)
+    {
+        if (t.vars[k].type == lindepVariable && compileEquation(t, k, code[k]))
+        {
+            cerr << "ERR: variable " << t.vars[k].id << " can not be evaluated" << endl;
+            return 1;
+        }
+    }
+
+    vector<int> state(t.vars.size(), 0);
+    vector<int> order;
+    for (size_t k = 0; k < t.vars.size(); k++)
+    {
+        if (sortEquations(t, code, k, state, order))
+        {
+            cerr << "ERR: variable " << t.vars[k].id << " can not be evaluated" << endl;
+            return 1;
+        }
+    }
+
+    for (int k : order)
+        evaluateEquation(code[k], t.values, n, t.values[k]);
+
+    return 0;
+}
+
+/**
+ * @brief function parses a var node
+ *
+ * @param node  var node
+ * @param v     parsed variable
+ * @return int  error code
+ */
+int parseVariable(DOMElement *node, variable &v)
+{
+    v.id = readStrAttrFromNode(node, "id");
+    string type = readStrAttrFromNode(node, "type");
+
+    try
+    {
+        if (type == "normal")
+        {
+            v.type = normalVariable;
+            v.a = stod(readStrAttrFromNode(node, "mu"));
+            v.b = stod(readStrAttrFromNode(node, "sd"));
+        }
+        else if (type == "uniform")
+        {
+            v.type = uniformVariable;
+            v.a = stod(readStrAttrFromNode(node, "min"));
+            v.b = stod(readStrAttrFromNode(node, "max"));
+        }
+        else if (type == "lindep")
+        {
+            v.type = lindepVariable;
+            v.dp = readStrAttrFromNode(node, "dp");
+        }
+        else
+        {
+            cerr << "ERR: variable " << v.id << " has an invalid distribution type" << endl;
+            return 1;
+        }
+    }
+    catch (...)
+    {
+        cerr << "ERR: variable " << v.id << " has invalid parameters" << endl;
+        return 1;
+    }
+
+    if (v.type != lindepVariable && (!std::isfinite(v.a) || !std::isfinite(v.b)))
+    {
+        cerr << "ERR: variable " << v.id << " has parameters which are not finite" << endl;
+        return 1;
+    }
+    if (v.type == normalVariable && v.b <= 0)
+    {
+        cerr << "ERR: variable " << v.id << " has a standard deviation " << v.b << " which is not positive" << endl;
+        return 1;
+    }
+    if (v.type == uniformVariable && v.b < v.a)
+    {
+        cerr << "ERR: variable " << v.id << " has a maximum " << v.b << " below its minimum " << v.a << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function collects all elements of a tree in document order
+ *
+ * @param node      root of the tree
+ * @param elements  collected elements
+ */
+void collectElements(DOMElement *node, vector<DOMElement*> &elements)
+{
+    elements.push_back(node);
+    for (DOMElement *it = node->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        collectElements(it, elements);
+}
+
+/**
+ * @brief function formats a variable value so that it can be read again without loss
+ *
+ * @param value     variable value
+ * @return string   formatted value
+ */
+string formatVariable(double value)
+{
+    ostringstream s;
+    s << setprecision(numeric_limits<double>::max_digits10) << value;
+    return s.str();
+}
+
+/**
+ * @brief function writes a document to a string
+ *
+ * @param document  document to write
+ * @param res       resulting xml document
+ * @return int      error code
+ */
+int serializeDocument(DOMDocument *document, string &res)
+{
+    DOMImplementationLS *lsImpl = (DOMImplementationLS*)DOMImplementationRegistry::getDOMImplementation(X("LS"));
+    if (lsImpl == NULL) return 1;
+
+    DOMLSSerializer *serializer = lsImpl->createLSSerializer();
+    DOMLSOutput *output = lsImpl->createLSOutput();
+    MemBufFormatTarget target;
+    output->setByteStream(&target);
+    XStr encoding("UTF-8");
+    output->setEncoding(encoding.unicodeForm());
+
+    int errorCode = 0;
+    try
+    {
+        if (!serializer->write(document, output))
+            errorCode = 1;
+    }
+    catch (...)
+    {
+        errorCode = 1;
+    }
+    res.assign((const char*)target.getRawBuffer(), target.getLen());
+
+    output->release();
+    serializer->release();
+
+    return errorCode;
+}
+
+/**
+ * @brief function reads a template, draws the values of all variants and prepares the document which is shared by all variants.
+ * The template is validated against the input.xsd with the values of the first variant
+ *
+ * @param file      template file
+ * @param n         number of variants, a template without variables results in one variant
+ * @param seed      seed of the random generator
+ * @param t         resulting template
+ * @return int      error code
+ */
+int prepareVariation(const string &file, int n, unsigned int seed, variationTemplate &t)
+{
+    if (initializeXerces()) return 1;
+
+    // the template itself does not conform to the schema, the variable references are replaced first
+    XercesDOMParser parser;
+    parser.setValidationScheme(XercesDOMParser::Val_Never);
+    parser.setDoNamespaces(true);
+    try
+    {
+        parser.parse(file.c_str());
+    }
+    catch (...)
+    {
+        cerr << "ERR: template " << file << " can not be parsed" << endl;
+        return 1;
+    }
+    DOMDocument *document = parser.getDocument();
+    if (parser.getErrorCount() != 0 || document == NULL || document->getDocumentElement() == NULL)
+    {
+        cerr << "ERR: template " << file << " can not be parsed" << endl;
+        return 1;
+    }
+    DOMElement *root = document->getDocumentElement();
+
+    // --- variables -----------------------------------------------------------
+    DOMElement *vars = NULL;
+    for (DOMElement *it = root->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        if (readNameFromNode(it) == "vars")
+            vars = it;
+
+    if (vars != NULL)
+    {
+        for (DOMElement *it = vars->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            variable v;
+            if (parseVariable(it, v)) return 1;
+            if (t.varIndex.count(v.id))
+            {
+                cerr << "ERR: variable " << v.id << " is declared twice" << endl;
+                return 1;
+            }
+            t.varIndex[v.id] = t.vars.size();
+            t.vars.push_back(v);
+        }
+        root->removeChild(vars)->release();
+    }
+
+    if (t.vars.empty())
+    {
+        cout << "No variables declared. Running only one iteration!" << endl;
+        n = 1;
+    }
+    if (n <= 0)
+    {
+        cerr << "ERR: number of variants has to be positive" << endl;
+        return 1;
+    }
+
+    if (sampleVariables(t, n, seed)) return 1;
+
+    // --- variable references -------------------------------------------------
+    vector<DOMElement*> elements;
+    collectElements(root, elements);
+
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        DOMNamedNodeMap *attributes = elements[i]->getAttributes();
+        for (XMLSize_t j = 0; j < attributes->getLength(); j++)
+        {
+            DOMAttr *attr = (DOMAttr*)attributes->item(j);
+
+            char *c_value = XMLString::transcode(attr->getValue());
+            string value(c_value);
+            XMLString::release(&c_value);
+
+            if (value.size() < 3 || value.compare(0, 2, "${") != 0 || value.back() != '}')
+                continue;
+
+            string id = value.substr(2, value.size() - 3);
+            unordered_map<string, int>::iterator it = t.varIndex.find(id);
+            if (it == t.varIndex.end())
+            {
+                cerr << "ERR: unknown variable '" << id << "' referenced in template" << endl;
+                return 1;
+            }
+
+            char *c_name = XMLString::transcode(attr->getName());
+            templateSlot slot;
+            slot.element = i;
+            slot.attribute = c_name;
+            slot.var = it->second;
+            XMLString::release(&c_name);
+
+            t.slots.push_back(slot);
+        }
+    }
+
+    for (const templateSlot &slot : t.slots)
+        elements[slot.element]->setAttribute(X(slot.attribute.c_str()), X(formatVariable(t.values[slot.var][0]).c_str()));
+
+    if (serializeDocument(document, t.document))
+    {
+        cerr << "ERR: template " << file << " can not be serialized" << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function generates all variants of a template on a pool of worker threads.
+ * Every thread parses the prepared document once and only replaces the referenced attributes for each variant,
+ * no intermediate files are written
+ *
+ * @param base      context which holds the settings for all runs
+ * @param t         prepared template
+ * @param prefix    output file prefix, the variants are stored as <prefix>_rev<i>.xodr
+ * @param nThreads  number of worker threads, 0 uses all available cores
+ * @param results   per variant results in the order of the variants
+ * @return int      number of failed variants
+ */
+int runVariation(const generatorContext &base, const variationTemplate &t, const string &prefix, int nThreads, vector<batchResult> &results)
+{
+    size_t n = t.variants;
+    results.assign(n, batchResult());
+
+    if (nThreads <= 0)
+        nThreads = max(1u, std::thread::hardware_concurrency());
+    nThreads = min(nThreads, (int)n);
+
+    string schema = string_format("%s/xml/input.xsd", PROJ_DIR);
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        setting = base.setting;
+
+        xmlTree tree;
+        vector<DOMElement*> elements;
+        bool valid = !tree.loadGrammar(schema.c_str()) && !tree.parseBuffer(t.document, prefix.c_str()) && tree.getErrorCount() == 0;
+        if (valid)
+            collectElements(tree.getRootElement(), elements);
+        else
+            cerr << "ERR: template doesn't conform to the schema" << endl;
+
+        for (size_t k = next++; k < n; k = next++)
+        {
+            batchResult &r = results[k];
+            r.file = prefix + "_rev" + to_string(k);
+            if (!valid) continue;
+
+            char dt[100];
+            getTimeStamp(dt);
+            cerr << "\n" << dt << " Error log for variant: " << r.file << endl;
+
+            auto start = std::chrono::steady_clock::now();
+            setting.warnings = 0;
+            try
+            {
+                for (const templateSlot &slot : t.slots)
+                    elements[slot.element]->setAttribute(X(slot.attribute.c_str()), X(formatVariable(t.values[slot.var][k]).c_str()));
+
+                r.status = generateFromTree(tree.getRootElement(), r.file, NULL, NULL, NULL, NULL, NULL, NULL);
+            }
+            catch (...)
+            {
+                cerr << "ERR: unexpected exception during generation of " << r.file << endl;
+                r.status = -1;
+            }
+            r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            r.warnings = setting.warnings;
+        }
+    };
+
+    // the log is opened once for all variants
+    acquireLog(base.logfile, base.setting.overwriteLog);
+
+    vector<std::thread> pool;
+    for (int th = 1; th < nThreads; th++)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread &th : pool)
+        th.join();
+
+    releaseLog();
+
+    int nFailed = 0;
+    for (const batchResult &r : results)
+        if (r.status != 0)
+            nFailed++;
+
+    return nFailed;
+}
@@ -15,110 +15,260 @@
  *
  */
 
+#pragma once
+
 #include <math.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// coefficients of the rational approximation of the fresnel integrals for s^2 < 2.5625 (cephes), highest order first
+constexpr double fresnelSN[6] = {
+    -2.99181919401019853726E3,
+    7.08840045257738576863E5,
+    -6.29741486205862506537E7,
+    2.54890880573376359104E9,
+    -4.42979518059697779103E10,
+    3.18016297876567817986E11};
+
+constexpr double fresnelSD[7] = {
+    1.00000000000000000000E0,
+    2.81376268889994315696E2,
+    4.55847810806532581675E4,
+    5.17343888770096400730E6,
+    4.19320245898111231129E8,
+    2.24411795645340920940E10,
+    6.07366389490084639049E11};
+
+constexpr double fresnelCN[6] = {
+    -4.98843114573573548651E-8,
+    9.50428062829859605134E-6,
+    -6.45191435683965050962E-4,
+    1.88843319396703850064E-2,
+    -2.05525900955013891793E-1,
+    9.99999999999999998822E-1};
+
+constexpr double fresnelCD[7] = {
+    3.99982968972495980367E-12,
+    9.15439215774657478799E-10,
+    1.25001862479598821474E-7,
+    1.22262789024179030997E-5,
+    8.68029542941784300606E-4,
+    4.12142090722199792936E-2,
+    1.00000000000000000118E0};
+
+// coefficients of the auxiliary functions f and g of the asymptotic expansion for large s (cephes), highest order first
+constexpr double fresnelFN[10] = {
+    4.21543555043677546506E-1,
+    1.43407919780758885261E-1,
+    1.15220955073585758835E-2,
+    3.45017939782574027900E-4,
+    4.63613749287867322088E-6,
+    3.05568983790257605827E-8,
+    1.02304514164907233465E-10,
+    1.72010743268161828879E-13,
+    1.34283276233062758925E-16,
+    3.76329711269987889006E-20};
+
+constexpr double fresnelFD[11] = {
+    1.00000000000000000000E0,
+    7.51586398353378947175E-1,
+    1.16888925859191382142E-1,
+    6.44051526508858611005E-3,
+    1.55934409164153020873E-4,
+    1.84627567348930545870E-6,
+    1.12699224763999035261E-8,
+    3.60140029589371370404E-11,
+    5.88754533621578410010E-14,
+    4.52001434074129701496E-17,
+    1.25443237090011264384E-20};
+
+constexpr double fresnelGN[11] = {
+    5.04442073643383265887E-1,
+    1.97102833525523411709E-1,
+    1.87648584092575249293E-2,
+    6.84079380915393090172E-4,
+    1.15138826111884280931E-5,
+    9.82852443688422223854E-8,
+    4.45344415861750144738E-10,
+    1.08268041139020870318E-12,
+    1.37555460633261799868E-15,
+    8.36354435630677421531E-19,
+    1.86958710162783235106E-22};
+
+constexpr double fresnelGD[12] = {
+    1.00000000000000000000E0,
+    1.47495759925128324529E0,
+    3.37748989120019970451E-1,
+    2.53603741420338795122E-2,
+    8.14679107184306179049E-4,
+    1.27545075667729118702E-5,
+    1.04314589657571990585E-7,
+    4.60680728146520428211E-10,
+    1.10273215066240270757E-12,
+    1.38796531259578871258E-15,
+    8.39158816283118707363E-19,
+    1.86958710162783236342E-22};
 
 /**
- * @brief function computes the fresnel integral
+ * @brief accuracy of the fresnel integrals used for sampling reference lines
+ * 
+ * fresnelExact:    rational approximation for s^2 < 2.5625 and asymptotic expansion above
+ * fresnelFast:     cubic taylor expansion around a table with step h = 1 / 512 for |s| <= 8, larger s use fresnelExact.
+ *                  The absolute error is below (3 pi^2 |s| + pi^3 |s|^3) * (h / 2)^4 / 24, i.e. below 1e-9
+ */
+enum fresnelAccuracy
+{
+    fresnelExact,
+    fresnelFast
+};
+
+/**
+ * @brief function evaluates a polynomial with the horner scheme
+ * 
+ * @param c     coefficients, highest order first
+ * @param n     number of coefficients
+ * @param x     argument
+ * @return double value of the polynomial
+ */
+inline double horner(const double *c, int n, double x)
+{
+    double res = c[0];
+    for (int k = 1; k < n; k++)
+        res = res * x + c[k];
+    return res;
+}
+
+/**
+ * @brief function computes the fresnel integrals C(s) and S(s) of a normalized clothoid
  * 
  * @param s     position s in a spiral
  * @param x     result for x component
  * @param y     result for y component
  * @return int  error code
  */
-int fresnel(double s, double &x, double &y)
+inline int fresnel(double s, double &x, double &y)
 {
-    int sgn = (s > 0) - (s < 0);
-
-    double s2 = pow(s, 2);
-    double s4 = pow(s, 4);
-
-    double xn[6];
-    double yn[6];
-    double xd[7];
-    double yd[7];
-
-    xn[0] = -2.99181919401019853726E3,
-    xn[1] = 7.08840045257738576863E5,
-    xn[2] = -6.29741486205862506537E7,
-    xn[3] = 2.54890880573376359104E9,
-    xn[4] = -4.42979518059697779103E10,
-    xn[5] = 3.18016297876567817986E11;
-
-    xd[0] = 1.00000000000000000000E0,
-    xd[1] = 2.81376268889994315696E2,
-    xd[2] = 4.55847810806532581675E4,
-    xd[3] = 5.17343888770096400730E6,
-    xd[4] = 4.19320245898111231129E8,
-    xd[5] = 2.24411795645340920940E10,
-    xd[6] = 6.07366389490084639049E11;
-
-    yn[0] = -4.98843114573573548651E-8,
-    yn[1] = 9.50428062829859605134E-6,
-    yn[2] = -6.45191435683965050962E-4,
-    yn[3] = 1.88843319396703850064E-2,
-    yn[4] = -2.05525900955013891793E-1,
-    yn[5] = 9.99999999999999998822E-1;
-
-    yd[0] = 3.99982968972495980367E-12,
-    yd[1] = 9.15439215774657478799E-10,
-    yd[2] = 1.25001862479598821474E-7,
-    yd[3] = 1.22262789024179030997E-5,
-    yd[4] = 8.68029542941784300606E-4,
-    yd[5] = 4.12142090722199792936E-2,
-    yd[6] = 1.00000000000000000118E0;
-
-    double res1 = 0;
-    res1 += pow(s4, 0) * xn[5];
-    res1 += pow(s4, 1) * xn[4];
-    res1 += pow(s4, 2) * xn[3];
-    res1 += pow(s4, 3) * xn[2];
-    res1 += pow(s4, 4) * xn[1];
-    res1 += pow(s4, 5) * xn[0];
-
-    double res2 = 0;
-    res2 += pow(s4, 0) * xd[6];
-    res2 += pow(s4, 1) * xd[5];
-    res2 += pow(s4, 2) * xd[4];
-    res2 += pow(s4, 3) * xd[3];
-    res2 += pow(s4, 4) * xd[2];
-    res2 += pow(s4, 5) * xd[1];
-    res2 += pow(s4, 6) * xd[0];
-
-    double res3 = 0;
-    res3 += pow(s4, 0) * yn[5];
-    res3 += pow(s4, 1) * yn[4];
-    res3 += pow(s4, 2) * yn[3];
-    res3 += pow(s4, 3) * yn[2];
-    res3 += pow(s4, 4) * yn[1];
-    res3 += pow(s4, 5) * yn[0];
-
-    double res4 = 0;
-    res4 += pow(s4, 0) * yd[6];
-    res4 += pow(s4, 1) * yd[5];
-    res4 += pow(s4, 2) * yd[4];
-    res4 += pow(s4, 3) * yd[3];
-    res4 += pow(s4, 4) * yd[2];
-    res4 += pow(s4, 5) * yd[1];
-    res4 += pow(s4, 6) * yd[0];
-
-    x = sgn * abs(s) * res3 / res4;
-    y = sgn * abs(s) * s2 * res1 / res2;
+    double s2 = s * s;
+
+    if (s2 < 2.5625)
+    {
+        double s4 = s2 * s2;
+        x = s * horner(fresnelCN, 6, s4) / horner(fresnelCD, 7, s4);
+        y = s * s2 * horner(fresnelSN, 6, s4) / horner(fresnelSD, 7, s4);
+        return 0;
+    }
+
+    double sAbs = fabs(s);
+    if (sAbs > 36974.0)
+    {
+        x = (s > 0) ? 0.5 : -0.5;
+        y = x;
+        return 0;
+    }
+
+    // asymptotic expansion with the auxiliary functions f and g
+    double t = M_PI * s2;
+    double u = 1.0 / (t * t);
+    t = 1.0 / t;
+    double f = 1.0 - u * horner(fresnelFN, 10, u) / horner(fresnelFD, 11, u);
+    double g = t * horner(fresnelGN, 11, u) / horner(fresnelGD, 12, u);
 
+    double c = cos(M_PI_2 * s2);
+    double si = sin(M_PI_2 * s2);
+    t = M_PI * sAbs;
+    x = 0.5 + (f * si - g * c) / t;
+    y = 0.5 - (f * c + g * si) / t;
+
+    if (s < 0)
+    {
+        x = -x;
+        y = -y;
+    }
     return 0;
 }
 
 /**
- * @brief function computes the x, y, phi value for a given geometry at position s
+ * @brief table of the fresnel integrals and the direction of the clothoid at equidistant nodes, used by fresnelTabulated
+ * 
+ */
+struct fresnelTable
+{
+    static constexpr double step = 1.0 / 512;
+    static constexpr double range = 8;
+    static constexpr int nodes = 4097; // range / step + 1
+
+    vector<double> C, S, cosT, sinT;
+
+    fresnelTable() : C(nodes), S(nodes), cosT(nodes), sinT(nodes)
+    {
+        for (int k = 0; k < nodes; k++)
+        {
+            double s = k * step;
+            fresnel(s, C[k], S[k]);
+            cosT[k] = cos(M_PI_2 * s * s);
+            sinT[k] = sin(M_PI_2 * s * s);
+        }
+    }
+};
+
+/**
+ * @brief function computes the fresnel integrals with a taylor expansion of third order around the nearest table node.
+ * The table is built on the first call
+ * 
+ * @param s     position s in a spiral
+ * @param x     result for x component
+ * @param y     result for y component
+ * @return int  error code
+ */
+inline int fresnelTabulated(double s, double &x, double &y)
+{
+    static const fresnelTable table;
+
+    double sAbs = fabs(s);
+    if (sAbs > 8)
+        return fresnel(s, x, y);
+
+    int k = (int)(sAbs * 512 + 0.5);
+    double s0 = k / 512.0;
+    double h = sAbs - s0;
+
+    // derivatives of C and S: first cos and sin, second -pi s sin and pi s cos,
+    // third -pi sin - pi^2 s^2 cos and pi cos - pi^2 s^2 sin
+    double c = table.cosT[k];
+    double si = table.sinT[k];
+    double ps = M_PI * s0;
+    double pss = ps * ps;
+
+    double dC2 = -ps * si;
+    double dS2 = ps * c;
+    double dC3 = -M_PI * si - pss * c;
+    double dS3 = M_PI * c - pss * si;
+
+    x = table.C[k] + h * (c + h * (0.5 * dC2 + h * dC3 / 6));
+    y = table.S[k] + h * (si + h * (0.5 * dS2 + h * dS3 / 6));
+
+    if (s < 0)
+    {
+        x = -x;
+        y = -y;
+    }
+    return 0;
+}
+
+/**
+ * @brief function computes the x, y, phi value for a given geometry at position s.
+ * The heading of a spiral is computed analytically: phi + c1 * s + sigma * s^2 / 2
  * 
  * @param s     position where x, y, phi should be computed
  * @param geo   geometry
  * @param x     start value of geometry and holds resulting value for x
  * @param y     start value of geometry and holds resulting value for y
  * @param phi   start value of geometry and holds resulting value for phi
- * @param fd    determines if finite differences should be used for derivative
+ * @param fd    determines if the heading of a spiral should be computed
  * @return int  error code
  */
-int curve(double s, geometry geo, double &x, double &y, double &phi, int fd)
+int curve(double s, const geometry &geo, double &x, double &y, double &phi, int fd)
 {
     geometryType type = geo.type;
     double c = geo.c;
@@ -126,6 +276,15 @@ int curve(double s, geometry geo, double &x, double &y, double &phi, int fd)
     double c2 = geo.c2;
     double ds = geo.length;
 
+    // a spiral without curvature change degenerates to an arc
+    if (type == spiral && c1 == c2)
+    {
+        type = arc;
+        c = c1;
+    }
+    if (type == arc && c == 0)
+        type = line;
+
     if (type == line)
     {
         x += s * cos(phi);
@@ -166,19 +325,287 @@ int curve(double s, geometry geo, double &x, double &y, double &phi, int fd)
         x += a * (cos(phi - tau) * x2 - sin(phi - tau) * y2);
         y += a * (sin(phi - tau) * x2 + cos(phi - tau) * y2);
 
-        // calculate angle with finite differences
         if (fd)
+            phi += s * (c1 + 0.5 * sigma * s);
+    }
+    return 0;
+}
+
+/**
+ * @brief function computes the x, y, phi value and the derivatives for a given geometry at position s.
+ * The tangent is (dx, dy), the normal pointing to the left is (-dy, dx)
+ * 
+ * @param s     position where x, y, phi should be computed
+ * @param geo   geometry
+ * @param x     start value of geometry and holds resulting value for x
+ * @param y     start value of geometry and holds resulting value for y
+ * @param phi   start value of geometry and holds resulting value for phi
+ * @param dx    resulting derivative of x with respect to s
+ * @param dy    resulting derivative of y with respect to s
+ * @param kappa resulting curvature, the derivative of phi with respect to s
+ * @return int  error code
+ */
+int curveDerivatives(double s, const geometry &geo, double &x, double &y, double &phi, double &dx, double &dy, double &kappa)
+{
+    if (curve(s, geo, x, y, phi, 1))
+        return 1;
+
+    dx = cos(phi);
+    dy = sin(phi);
+
+    if (geo.type == line)
+        kappa = 0;
+    else if (geo.type == arc)
+        kappa = geo.c;
+    else
+        kappa = geo.c1 + s * (geo.c2 - geo.c1) / geo.length;
+
+    return 0;
+}
+
+/**
+ * @brief function computes the end of a road. The end of the last geometry relative to its start is cached in the road,
+ * so that the geometry is only evaluated again if its shape changed
+ * 
+ * @param r     road
+ * @param x     start value of the last geometry and holds resulting value for x
+ * @param y     start value of the last geometry and holds resulting value for y
+ * @param phi   start value of the last geometry and holds resulting value for phi
+ * @return int  error code
+ */
+int endOfRoad(const road &r, double &x, double &y, double &phi)
+{
+    if (r.geometries.empty()) return 1;
+
+    const geometry &g = r.geometries.back();
+
+    // lines are cheaper to evaluate than to rotate
+    if (g.type == line)
+        return curve(g.length, g, x, y, phi, 1);
+
+    endPoseCache &p = r.endPose;
+    if (!p.valid || p.type != g.type || p.length != g.length || p.c != g.c || p.c1 != g.c1 || p.c2 != g.c2)
+    {
+        p.type = g.type;
+        p.length = g.length;
+        p.c = g.c;
+        p.c1 = g.c1;
+        p.c2 = g.c2;
+
+        p.dx = 0;
+        p.dy = 0;
+        p.dHdg = 0;
+        curve(g.length, g, p.dx, p.dy, p.dHdg, 1);
+        p.valid = true;
+    }
+
+    double cp = cos(phi);
+    double sp = sin(phi);
+    x += cp * p.dx - sp * p.dy;
+    y += sp * p.dx + cp * p.dy;
+    phi += p.dHdg;
+    return 0;
+}
+
+/**
+ * @brief function finds the geometry of a reference line which contains a position by binary search
+ * 
+ * @param geos  geometries of the reference line, sorted by s
+ * @param s     position along the reference line
+ * @return int  index of the last geometry which starts before or at s, -1 if s is before the first geometry
+ */
+int findGeometry(const vector<geometry> &geos, double s)
+{
+    return (int)(upper_bound(geos.begin(), geos.end(), s,
+                             [](double v, const geometry &geo) { return v < geo.s; }) - geos.begin()) - 1;
+}
+
+/**
+ * @brief function computes x, y and phi for a sorted list of s values on one geometry.
+ * The loops work on plain arrays without branches, so that the compiler can vectorize them
+ * 
+ * @param geo       geometry
+ * @param ds        positions relative to the start of the geometry
+ * @param n         number of positions
+ * @param x         resulting x values
+ * @param y         resulting y values
+ * @param phi       resulting heading values
+ * @param accuracy  accuracy of the fresnel integrals
+ */
+void curveBatchGeometry(const geometry &geo, const double *ds, int n, double *x, double *y, double *phi, fresnelAccuracy accuracy = fresnelExact)
+{
+    const double x0 = geo.x;
+    const double y0 = geo.y;
+    const double h0 = geo.hdg;
+
+    double sigma = (geo.type == spiral) ? (geo.c2 - geo.c1) / geo.length : 0;
+
+    // a spiral without curvature change degenerates to an arc
+    geometryType type = geo.type;
+    double c = geo.c;
+    if (type == spiral && sigma == 0)
+    {
+        type = arc;
+        c = geo.c1;
+    }
+    if (type == arc && c == 0)
+        type = line;
+
+    if (type == line)
+    {
+        const double ch = cos(h0);
+        const double sh = sin(h0);
+        for (int k = 0; k < n; k++)
+        {
+            x[k] = x0 + ds[k] * ch;
+            y[k] = y0 + ds[k] * sh;
+            phi[k] = h0;
+        }
+    }
+    else if (type == arc)
+    {
+        const double sh = sin(h0);
+        const double ch = cos(h0);
+        const double r = 1 / c;
+        for (int k = 0; k < n; k++)
         {
-            double xTmp1 = 0;
-            double xTmp2 = 0;
-            double yTmp1 = 0;
-            double yTmp2 = 0;
-            double phiTmp = 0;
-            curve(s - 0.001, geo, xTmp1, yTmp1, phiTmp, 0);
-            curve(s + 0.001, geo, xTmp2, yTmp2, phiTmp, 0);
-
-            phi += atan2((yTmp2 - yTmp1), (xTmp2 - xTmp1));
+            double h = h0 + c * ds[k];
+            x[k] = x0 + (sin(h) - sh) * r;
+            y[k] = y0 + (ch - cos(h)) * r;
+            phi[k] = h;
         }
     }
+    else
+    {
+        const double c1 = geo.c1;
+        const double a = sqrt(M_PI) / sqrt(fabs(sigma));
+        const double s1 = c1 / sigma;
+        const double tau = 0.5 * s1 * sigma * s1;
+        const double dir = (sigma > 0) ? 1 : -1;
+
+        double fx1, fy1;
+        fresnel(s1 / a, fx1, fy1);
+        fy1 *= dir;
+
+        const double cr = cos(h0 - tau);
+        const double sr = sin(h0 - tau);
+
+        // the arguments are monotonic in ds, so the end points decide if the branch free small argument kernel suffices
+        double tFirst = (c1 + ds[0] * sigma) / sigma / a;
+        double tLast = (c1 + ds[n - 1] * sigma) / sigma / a;
+        bool small = accuracy == fresnelExact && tFirst * tFirst < 2.5625 && tLast * tLast < 2.5625;
+
+        for (int k = 0; k < n; k++)
+        {
+            double t = (c1 + ds[k] * sigma) / sigma / a;
+            double fx, fy;
+
+            if (small)
+            {
+                double t2 = t * t;
+                double t4 = t2 * t2;
+                fx = t * horner(fresnelCN, 6, t4) / horner(fresnelCD, 7, t4);
+                fy = t * t2 * horner(fresnelSN, 6, t4) / horner(fresnelSD, 7, t4);
+            }
+            else if (accuracy == fresnelFast)
+                fresnelTabulated(t, fx, fy);
+            else
+                fresnel(t, fx, fy);
+
+            fx -= fx1;
+            fy = dir * fy - fy1;
+
+            x[k] = x0 + a * (cr * fx - sr * fy);
+            y[k] = y0 + a * (sr * fx + cr * fy);
+            phi[k] = h0 + ds[k] * (c1 + 0.5 * sigma * ds[k]);
+        }
+    }
+}
+
+/**
+ * @brief function computes x, y and phi for many positions along a reference line in one call.
+ * The heading of spirals is computed analytically
+ * 
+ * @param geos  geometries of the reference line, sorted by s
+ * @param s     positions along the reference line, should be sorted ascending, have to be finite
+ * @param x     resulting x values
+ * @param y     resulting y values
+ * @param phi   resulting heading values
+ * @param accuracy  accuracy of the fresnel integrals
+ * @return int  error code
+ */
+int curveBatch(const vector<geometry> &geos, const vector<double> &s, vector<double> &x, vector<double> &y, vector<double> &phi,
+               fresnelAccuracy accuracy = fresnelExact)
+{
+    size_t n = s.size();
+    x.resize(n);
+    y.resize(n);
+    phi.resize(n);
+
+    if (n == 0) return 0;
+    if (geos.empty()) return 1;
+
+    // a position which is not finite would never be assigned to a geometry
+    for (size_t k = 0; k < n; k++)
+    {
+        if (!std::isfinite(s[k]))
+        {
+            cerr << "ERR: position " << s[k] << " on the reference line is not finite" << endl;
+            return 1;
+        }
+    }
+
+    vector<double> ds(n);
+
+    size_t k = 0;
+    while (k < n)
+    {
+        // find geometry of the current position, positions outside of the reference line are extrapolated
+        size_t g = upper_bound(geos.begin() + 1, geos.end(), s[k],
+                               [](double v, const geometry &geo) { return v < geo.s; }) - geos.begin() - 1;
+
+        double sEnd = (g + 1 < geos.size()) ? geos[g + 1].s : INFINITY;
+
+        // collect all following positions on the same geometry
+        size_t start = k;
+        while (k < n && s[k] < sEnd && (k == start || s[k] >= s[k - 1]))
+        {
+            ds[k] = s[k] - geos[g].s;
+            k++;
+        }
+
+        curveBatchGeometry(geos[g], &ds[start], (int)(k - start), &x[start], &y[start], &phi[start], accuracy);
+    }
+
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief function samples a reference line with a constant step size. The end of the reference line is always included
+ * 
+ * @param geos  geometries of the reference line, sorted by s
+ * @param step  step size
+ * @param s     resulting positions
+ * @param x     resulting x values
+ * @param y     resulting y values
+ * @param phi   resulting heading values
+ * @param accuracy  accuracy of the fresnel integrals
+ * @return int  error code
+ */
+int sampleReferenceLine(const vector<geometry> &geos, double step, vector<double> &s, vector<double> &x, vector<double> &y, vector<double> &phi,
+                        fresnelAccuracy accuracy = fresnelExact)
+{
+    s.clear();
+    if (geos.empty() || step <= 0) return 1;
+
+    double sStart = geos.front().s;
+    double sEnd = geos.back().s + geos.back().length;
+
+    int nSteps = (int)ceil((sEnd - sStart) / step);
+    s.reserve(nSteps + 1);
+    for (int k = 0; k < nSteps; k++)
+        s.push_back(sStart + k * step);
+    s.push_back(sEnd);
+
+    return curveBatch(geos, s, x, y, phi, accuracy);
+}
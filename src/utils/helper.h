@@ -132,7 +132,7 @@ int findLane(laneSection sec, lane &l, int id)
  * @param id    roadId of the lane to find
  * @return int  position in road vector
  */
-int findRoad(vector<road> roads, road &r, int id)
+int findRoad(const vector<road> &roads, road &r, int id)
 {
     for (int i = 0; i < roads.size(); i++)
     {
@@ -145,6 +145,161 @@ int findRoad(vector<road> roads, road &r, int id)
     return -1;
 }
 
+/**
+ * @brief function adds all roads, junctions and junction groups which were appended since the last call to the lookup tables
+ * 
+ * @param data  road network
+ */
+void updateIndex(roadNetwork &data)
+{
+    networkIndex &idx = data.index;
+
+    // the tables are only extended, so they have to be rebuilt if elements were removed
+    if (data.roads.size() < idx.nRoads || data.junctions.size() < idx.nJunctions || data.juncGroups.size() < idx.nJuncGroups)
+        idx = networkIndex();
+
+    for (; idx.nRoads < data.roads.size(); idx.nRoads++)
+    {
+        const road &r = data.roads[idx.nRoads];
+        int i = (int)idx.nRoads;
+        idx.roadsById[r.id].push_back(i);
+        idx.roadsBySegment[r.junction].push_back(i);
+        idx.roadsByInputSegment[r.inputSegmentId].push_back(i);
+        idx.roadsByRoundAboutSegment[r.roundAboutInputSegment].push_back(i);
+        idx.roadsByInputId[r.inputId].push_back(i);
+    }
+
+    for (; idx.nJunctions < data.junctions.size(); idx.nJunctions++)
+        idx.junctionById.emplace(data.junctions[idx.nJunctions].id, (int)idx.nJunctions);
+
+    for (; idx.nJuncGroups < data.juncGroups.size(); idx.nJuncGroups++)
+    {
+        const junctionGroup &jg = data.juncGroups[idx.nJuncGroups];
+        // a roundabout entry is never overwritten, since any roundabout group with the id marks the segment as roundabout
+        if (idx.juncGroupTypes.count(jg.id) == 0 || jg.type == roundaboutType)
+            idx.juncGroupTypes[jg.id] = jg.type;
+    }
+}
+
+/**
+ * @brief helper function to look up a road list in one of the index tables
+ * 
+ * @param table     index table
+ * @param key       key to look up
+ * @return const vector<int>&   road indices in ascending order
+ */
+const vector<int> &lookupRoads(const unordered_map<int, vector<int>> &table, int key)
+{
+    static const vector<int> empty;
+    unordered_map<int, vector<int>>::const_iterator it = table.find(key);
+    return (it == table.end()) ? empty : it->second;
+}
+
+/**
+ * @brief function returns the indices of all roads with the given id
+ * 
+ * @param data  road network
+ * @param id    road id
+ * @return const vector<int>&   road indices in ascending order
+ */
+const vector<int> &roadsWithId(roadNetwork &data, int id)
+{
+    updateIndex(data);
+    return lookupRoads(data.index.roadsById, id);
+}
+
+/**
+ * @brief function returns the indices of all roads whose junction attribute (the segment id) matches
+ * 
+ * @param data      road network
+ * @param segment   segment id
+ * @return const vector<int>&   road indices in ascending order
+ */
+const vector<int> &roadsOfSegment(roadNetwork &data, int segment)
+{
+    updateIndex(data);
+    return lookupRoads(data.index.roadsBySegment, segment);
+}
+
+/**
+ * @brief function returns the indices of all roads generated from the given input segment
+ * 
+ * @param data      road network
+ * @param segment   input segment id
+ * @return const vector<int>&   road indices in ascending order
+ */
+const vector<int> &roadsOfInputSegment(roadNetwork &data, int segment)
+{
+    updateIndex(data);
+    return lookupRoads(data.index.roadsByInputSegment, segment);
+}
+
+/**
+ * @brief function returns the indices of all roads which belong to the given roundabout segment
+ * 
+ * @param data      road network
+ * @param segment   roundabout segment id
+ * @return const vector<int>&   road indices in ascending order
+ */
+const vector<int> &roadsOfRoundAboutSegment(roadNetwork &data, int segment)
+{
+    updateIndex(data);
+    return lookupRoads(data.index.roadsByRoundAboutSegment, segment);
+}
+
+/**
+ * @brief function returns the indices of all roads with the given input id
+ * 
+ * @param data      road network
+ * @param inputId   road id from the input file
+ * @return const vector<int>&   road indices in ascending order
+ */
+const vector<int> &roadsWithInputId(roadNetwork &data, int inputId)
+{
+    updateIndex(data);
+    return lookupRoads(data.index.roadsByInputId, inputId);
+}
+
+/**
+ * @brief function returns the position of the road with the given id
+ * 
+ * @param data  road network
+ * @param id    road id
+ * @return int  position in road vector, -1 if the road does not exist
+ */
+int findRoad(roadNetwork &data, int id)
+{
+    const vector<int> &res = roadsWithId(data, id);
+    return res.empty() ? -1 : res.front();
+}
+
+/**
+ * @brief function checks if a junction with the given id exists
+ * 
+ * @param data  road network
+ * @param id    junction id
+ * @return true if the junction exists
+ */
+bool isJunction(roadNetwork &data, int id)
+{
+    updateIndex(data);
+    return data.index.junctionById.count(id) > 0;
+}
+
+/**
+ * @brief function checks if the given segment is a roundabout
+ * 
+ * @param data  road network
+ * @param id    segment id
+ * @return true if a junction group of type roundabout with the id exists
+ */
+bool isRoundabout(roadNetwork &data, int id)
+{
+    updateIndex(data);
+    unordered_map<int, junctionGroupType>::const_iterator it = data.index.juncGroupTypes.find(id);
+    return it != data.index.juncGroupTypes.end() && it->second == roundaboutType;
+}
+
 /**
  * @brief function determines lanewidth of the given lane at positon s
  * 
@@ -706,12 +861,16 @@ bool compareSignals(const sign &a, const sign &b)
 size_t getTimeStamp(char* date_time)
 {
 	time_t curr_time;
-	tm * curr_tm;
+	tm curr_tm;
 	
 	time(&curr_time);
-	curr_tm = localtime(&curr_time);
+#ifdef _WIN32
+	localtime_s(&curr_tm, &curr_time);
+#else
+	localtime_r(&curr_time, &curr_tm); // localtime is not thread safe
+#endif
 	
-    return strftime(date_time, 100, "%Y-%m-%d %H:%M:%S", curr_tm);
+    return strftime(date_time, 100, "%Y-%m-%d %H:%M:%S", &curr_tm);
 }
 /**
  * @brief function compares lanes by id
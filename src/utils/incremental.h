@@ -0,0 +1,117 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file incremental.h
+ *
+ * @brief This file contains the per segment results which are kept between runs of the incremental mode
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <limits>
+#include <mutex>
+
+/**
+ * @brief result of a single segment. The counters at the start of the segment are stored, since the generated ids
+ * depend on them. A segment is only reused if its input and these counters are unchanged
+ *
+ */
+struct segmentState
+{
+    int id = -1;
+    string key;             // key of the input model of the segment, see segmentKey
+    bool rebuilt = true;    // generated in the current run
+
+    // state at the start of the segment
+    size_t firstRoad = 0;
+    size_t firstJunction = 0;
+    size_t firstJuncGroup = 0;
+    size_t nControllers = 0;
+    int nSignal = 0;
+    int nSegment = 0;
+    vector<control> controllersBefore;  // only stored if the segment adds signals
+
+    // results
+    vector<road> roads;             // roads after buildSegments
+    vector<road> linkedRoads;       // roads after linkSegments
+    vector<junction> junctions;
+    vector<junctionGroup> juncGroups;
+    int addedSignals = 0;
+    int addedSegments = 0;
+    vector<control> controllersAfter;   // only stored if the segment adds signals
+};
+
+/**
+ * @brief results of the last successful run of a context in incremental mode
+ *
+ */
+struct incrementalState
+{
+    std::mutex mtx; // runs of the same context are serialized
+
+    bool valid = false;
+    string settingsKey;
+    string linksKey;
+    vector<segmentState> segments;
+};
+
+/**
+ * @brief function compares two signals
+ *
+ * @param a     first signal
+ * @param b     second signal
+ * @return true if all properties are equal
+ */
+bool equalSigns(const sign &a, const sign &b)
+{
+    return a.id == b.id && a.type == b.type && a.subtype == b.subtype && a.rule == b.rule && a.value == b.value &&
+           a.s == b.s && a.t == b.t && a.z == b.z && a.orientation == b.orientation && a.width == b.width &&
+           a.height == b.height && a.dynamic == b.dynamic && a.country == b.country;
+}
+
+/**
+ * @brief function compares two lists of controllers
+ *
+ * @param a     first list
+ * @param b     second list
+ * @return true if both lists hold the same controllers and signals
+ */
+bool equalControllers(const vector<control> &a, const vector<control> &b)
+{
+    if (a.size() != b.size()) return false;
+
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (a[i].id != b[i].id || a[i].signs.size() != b[i].signs.size()) return false;
+        for (size_t j = 0; j < a[i].signs.size(); j++)
+            if (!equalSigns(a[i].signs[j], b[i].signs[j])) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief function computes a key of the links of the input. Segments can only keep their linked roads if the links are unchanged
+ *
+ * @param input     input model
+ * @return string   key of the links
+ */
+string linksKey(const inputModel &input)
+{
+    if (!input.hasLinks) return "";
+
+    ostringstream s;
+    s << setprecision(numeric_limits<double>::max_digits10);
+    s << input.links.refId << " " << input.links.xOffset << " " << input.links.yOffset << " " << input.links.hdgOffset << "\n";
+    for (const segmentLinkInput &l : input.links.segmentLinks)
+        s << l.fromSegment << " " << l.toSegment << " " << l.fromRoad << " " << l.toRoad << " " << l.fromPos << " " << l.toPos << "\n";
+    return s.str();
+}
@@ -0,0 +1,977 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file inputModel.h
+ *
+ * @brief This file contains the typed representation of the input file and the function which converts the validated xml tree into it
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+/**
+ * @brief single geometry of a reference line
+ *
+ */
+struct geometryInput
+{
+    geometryType type = line;
+    bool circle = false;    // circle of a roundabout, stored as arc. The radius is set by the roundabout
+    double length = 0;
+    double R = -1;          // arc
+    double Rs = -1;         // spiral
+    double Re = -1;         // spiral
+};
+
+/**
+ * @brief user defined lane. Empty strings and unset flags keep the default values
+ *
+ */
+struct laneInput
+{
+    int id = 0;
+    string type;
+
+    bool hasWidth = false;
+    double width = 0;
+    bool hasSpeed = false;
+    double speed = 0;
+
+    // roadMark
+    string markType;
+    string markColor;
+    bool hasMarkWidth = false;
+    double markWidth = 0;
+
+    // material
+    string surface;
+    bool hasFriction = false;
+    double friction = 0;
+    bool hasRoughness = false;
+    double roughness = 0;
+};
+
+/**
+ * @brief user defined laneWidening or laneDrop
+ *
+ */
+struct laneChangeInput
+{
+    bool widening = true;   // false for a laneDrop
+    int side = 0;
+    double s = 0;
+    bool hasLength = false;
+    double length = 0;
+
+    bool restrictedArea = false;
+    bool hasRestrictedLength = false;
+    int restrictedLength = 0;
+};
+
+/**
+ * @brief automaticWidening of a junction
+ *
+ */
+struct automaticWideningInput
+{
+    bool hasActive = false;
+    string active;
+    bool hasLength = false;
+    double length = 0;
+    bool hasDs = false;
+    double ds = 0;
+    bool restricted = false;
+};
+
+/**
+ * @brief signal of a traffic rule
+ *
+ */
+struct signalInput
+{
+    int id = -1;
+    string type;
+    double value = -1;
+    bool dynamic = false;
+    double s = 0;
+    double t = 0;
+    double z = 0;
+};
+
+/**
+ * @brief object of a road. Only the values of the given type are set
+ *
+ */
+struct objectInput
+{
+    string type;    // trafficRule, streetLamp, roadWork, busStop, parkingSpace or trafficIsland
+    int id = -1;
+
+    // relativePosition or repeatPosition
+    double s = 0;
+    double t = 0;
+    double hdg = 0;
+    bool repeat = false;
+    double len = 0;     // length of the repetition, length of a roadWork
+
+    double length = 0;  // parkingSpace, trafficIsland
+    double width = 0;   // parkingSpace, trafficIsland
+    int laneId = 0;     // roadWork
+
+    vector<signalInput> signals;    // trafficRule
+};
+
+/**
+ * @brief road of a segment
+ *
+ */
+struct roadInput
+{
+    int id = -1;
+    string classification;
+
+    vector<geometryInput> referenceLine;
+    vector<laneInput> lanes;
+    vector<laneChangeInput> laneChanges;    // in input order
+    vector<objectInput> objects;            // in input order
+};
+
+struct adRoadInput
+{
+    int id = -1;
+    double s = 0;
+    double angle = 0;
+};
+
+struct intersectionPointInput
+{
+    int refRoad = -1;
+    double s = 0;
+    vector<adRoadInput> adRoads;
+};
+
+struct roadGapInput
+{
+    int id = -1;
+    double gap = 0;
+};
+
+struct laneLinkInput
+{
+    int fromId = 0;
+    int toId = 0;
+    string left;    // empty if not specified
+    string right;   // empty if not specified
+};
+
+struct roadLinkInput
+{
+    int fromId = -1;
+    int toId = -1;
+    string fromPos = "end";
+    string toPos = "end";
+    vector<laneLinkInput> laneLinks;
+};
+
+struct additionalLaneInput
+{
+    int roadId = -1;
+    string roadPos = "end";
+    string type;
+    bool hasLength = false;
+    double length = 0;
+    bool hasDs = false;
+    double ds = 0;
+    int amount = 1;
+    bool verschwenkung = true;
+};
+
+/**
+ * @brief coupler of a junction or roundabout
+ *
+ */
+struct couplerInput
+{
+    bool hasJunctionArea = false;
+    double gap = 0;
+    vector<roadGapInput> roadGaps;
+
+    bool hasConnection = false;
+    string connectionType;
+    vector<roadLinkInput> roadLinks;
+
+    bool hasAdditionalLanes = false;
+    vector<additionalLaneInput> additionalLanes;
+};
+
+enum segmentKind
+{
+    junctionSegment,
+    roundaboutSegment,
+    connectingRoadSegment
+};
+
+/**
+ * @brief segment of the input file: junction, roundabout or connecting road
+ *
+ */
+struct segmentInput
+{
+    segmentKind kind = connectingRoadSegment;
+    int id = -1;
+    string type;    // junction type
+
+    vector<roadInput> roads;
+    bool hasCircle = false;
+    roadInput circle;   // roundabout only
+    vector<intersectionPointInput> intersectionPoints;
+
+    couplerInput coupler;
+    bool hasAutomaticWidening = false;
+    automaticWideningInput automaticWidening;
+};
+
+/**
+ * @brief link between two segments, used by links and closeRoads
+ *
+ */
+struct segmentLinkInput
+{
+    int fromSegment = -1;
+    int toSegment = -1;
+    int fromRoad = -1;
+    int toRoad = -1;
+    string fromPos;
+    string toPos;
+};
+
+struct linksInput
+{
+    int refId = -1;
+    double xOffset = 0;
+    double yOffset = 0;
+    double hdgOffset = 0;
+    vector<segmentLinkInput> segmentLinks;
+};
+
+/**
+ * @brief complete input of a pipeline run. All generation stages read from this model instead of the xml tree
+ *
+ */
+struct inputModel
+{
+    vector<segmentInput> segments;
+
+    bool hasLinks = false;
+    linksInput links;
+
+    bool hasCloseRoads = false;
+    vector<segmentLinkInput> closeRoads;
+};
+
+/**
+ * @brief function parses an object node
+ *
+ * @param node  object node
+ * @param o     parsed object
+ * @return int  error code
+ */
+int parseObject(DOMElement *node, objectInput &o)
+{
+    o.type = readNameFromNode(node);
+
+    if (o.type == "trafficRule")
+    {
+        o.id = readIntAttrFromNode(node, "id");
+        for (DOMElement *it = node->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            signalInput sig;
+            sig.id = readIntAttrFromNode(it, "id");
+            sig.type = readStrAttrFromNode(it, "type");
+            sig.value = readDoubleAttrFromNode(it, "value");
+            sig.dynamic = readBoolAttrFromNode(it, "dynamic");
+
+            DOMElement *position = getChildWithName(it, "relativePosition");
+            sig.s = readDoubleAttrFromNode(position, "s");
+            sig.t = readDoubleAttrFromNode(position, "t");
+            sig.z = readDoubleAttrFromNode(position, "z");
+            o.signals.push_back(sig);
+        }
+        return 0;
+    }
+
+    o.id = readDoubleAttrFromNode(node, "id");
+
+    // position of the object in st coordinates
+    DOMElement *position = getChildWithName(node, "relativePosition");
+    if (position != NULL)
+    {
+        o.s = readDoubleAttrFromNode(position, "s");
+        o.t = readDoubleAttrFromNode(position, "t");
+        o.hdg = readDoubleAttrFromNode(position, "hdg");
+    }
+    position = getChildWithName(node, "repeatPosition");
+    if (position != NULL)
+    {
+        o.s = readDoubleAttrFromNode(position, "s");
+        o.t = readDoubleAttrFromNode(position, "t");
+        o.hdg = readDoubleAttrFromNode(position, "hdg");
+        o.repeat = true;
+        o.len = readDoubleAttrFromNode(position, "length");
+    }
+
+    if (o.type == "parkingSpace")
+    {
+        o.length = readDoubleAttrFromNode(node, "length");
+        o.width = readDoubleAttrFromNode(node, "width");
+    }
+    if (o.type == "roadWork")
+    {
+        o.s = readDoubleAttrFromNode(node, "s");
+        o.len = readDoubleAttrFromNode(node, "length");
+        o.laneId = readIntAttrFromNode(node, "laneId");
+    }
+    if (o.type == "trafficIsland")
+    {
+        o.s = readDoubleAttrFromNode(node, "s");
+        o.length = readDoubleAttrFromNode(node, "length");
+        o.width = readDoubleAttrFromNode(node, "width");
+    }
+    return 0;
+}
+
+/**
+ * @brief function parses a road node
+ *
+ * @param node  road node
+ * @param r     parsed road
+ * @return int  error code
+ */
+int parseRoad(DOMElement *node, roadInput &r)
+{
+    r.id = readIntAttrFromNode(node, "id");
+    r.classification = readStrAttrFromNode(node, "classification");
+
+    DOMElement *referenceLine = getChildWithName(node, "referenceLine");
+    if (referenceLine == NULL)
+    {
+        cerr << "ERR: road " << r.id << " has no referenceLine." << endl;
+        return 1;
+    }
+
+    for (DOMElement *it = referenceLine->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+    {
+        geometryInput g;
+        string name = readNameFromNode(it);
+
+        if (name == "line")
+            g.type = line;
+        if (name == "spiral")
+            g.type = spiral;
+        if (name == "arc" || name == "circle")
+            g.type = arc;
+        g.circle = (name == "circle");
+
+        g.length = readDoubleAttrFromNode(it, "length");
+        if (g.type == spiral)
+        {
+            g.Rs = readDoubleAttrFromNode(it, "Rs");
+            g.Re = readDoubleAttrFromNode(it, "Re");
+        }
+        if (g.type == arc && !g.circle)
+            g.R = readDoubleAttrFromNode(it, "R");
+
+        r.referenceLine.push_back(g);
+    }
+
+    DOMElement *objects = getChildWithName(node, "objects");
+    if (objects != NULL)
+    {
+        for (DOMElement *it = objects->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            objectInput o;
+            parseObject(it, o);
+            r.objects.push_back(o);
+        }
+    }
+
+    DOMElement *lanes = getChildWithName(node, "lanes");
+    if (lanes == NULL)
+        return 0;
+
+    for (DOMElement *it = lanes->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+    {
+        string name = readNameFromNode(it);
+
+        if (name == "lane")
+        {
+            laneInput l;
+            l.id = readIntAttrFromNode(it, "id");
+            l.type = readStrAttrFromNode(it, "type");
+
+            l.hasWidth = attributeExits(it, "width");
+            if (l.hasWidth)
+                l.width = readDoubleAttrFromNode(it, "width");
+            l.hasSpeed = attributeExits(it, "speed");
+            if (l.hasSpeed)
+                l.speed = readDoubleAttrFromNode(it, "speed");
+
+            DOMElement *rm = getChildWithName(it, "roadMark");
+            if (rm != NULL)
+            {
+                l.markType = readStrAttrFromNode(rm, "type");
+                l.markColor = readStrAttrFromNode(rm, "color");
+                l.hasMarkWidth = attributeExits(rm, "width");
+                if (l.hasMarkWidth)
+                    l.markWidth = readDoubleAttrFromNode(rm, "width");
+            }
+
+            DOMElement *m = getChildWithName(it, "material");
+            if (m != NULL)
+            {
+                l.surface = readStrAttrFromNode(m, "surface");
+                l.hasFriction = attributeExits(m, "friction");
+                if (l.hasFriction)
+                    l.friction = readDoubleAttrFromNode(m, "friction");
+                l.hasRoughness = attributeExits(m, "roughness");
+                if (l.hasRoughness)
+                    l.roughness = readDoubleAttrFromNode(m, "roughness");
+            }
+
+            r.lanes.push_back(l);
+        }
+
+        if (name == "laneWidening" || name == "laneDrop")
+        {
+            laneChangeInput c;
+            c.widening = (name == "laneWidening");
+            c.side = readIntAttrFromNode(it, "side");
+            c.s = readDoubleAttrFromNode(it, "s");
+            c.hasLength = attributeExits(it, "length");
+            if (c.hasLength)
+                c.length = readDoubleAttrFromNode(it, "length");
+
+            DOMElement *ra = getChildWithName(it, "restrictedArea");
+            c.restrictedArea = (ra != NULL);
+            if (ra != NULL)
+            {
+                c.hasRestrictedLength = attributeExits(ra, "length");
+                if (c.hasRestrictedLength)
+                    c.restrictedLength = readIntAttrFromNode(ra, "length");
+            }
+
+            r.laneChanges.push_back(c);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function parses an intersectionPoint node
+ *
+ * @param node  intersectionPoint node
+ * @param ip    parsed intersection point
+ * @return int  error code
+ */
+int parseIntersectionPoint(DOMElement *node, intersectionPointInput &ip)
+{
+    ip.refRoad = readIntAttrFromNode(node, "refRoad");
+    ip.s = readDoubleAttrFromNode(node, "s");
+
+    for (DOMElement *it = node->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+    {
+        if (readNameFromNode(it) != "adRoad")
+            continue;
+
+        adRoadInput ad;
+        ad.id = readIntAttrFromNode(it, "id");
+        ad.s = readDoubleAttrFromNode(it, "s");
+        ad.angle = readDoubleAttrFromNode(it, "angle");
+        ip.adRoads.push_back(ad);
+    }
+    return 0;
+}
+
+/**
+ * @brief function parses the coupler node of a junction or roundabout
+ *
+ * @param node  coupler node
+ * @param c     parsed coupler
+ * @return int  error code
+ */
+int parseCoupler(DOMElement *node, couplerInput &c)
+{
+    DOMElement *area = getChildWithName(node, "junctionArea");
+    if (area != NULL)
+    {
+        c.hasJunctionArea = true;
+        c.gap = readDoubleAttrFromNode(area, "gap");
+
+        for (DOMElement *it = area->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            if (readNameFromNode(it) != "roadGap")
+                continue;
+
+            roadGapInput g;
+            g.id = readIntAttrFromNode(it, "id");
+            g.gap = readDoubleAttrFromNode(it, "gap");
+            c.roadGaps.push_back(g);
+        }
+    }
+
+    DOMElement *con = getChildWithName(node, "connection");
+    if (con != NULL)
+    {
+        c.hasConnection = true;
+        c.connectionType = readStrAttrFromNode(con, "type");
+
+        for (DOMElement *it = con->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            if (readNameFromNode(it) != "roadLink")
+                continue;
+
+            roadLinkInput rl;
+            rl.fromId = readIntAttrFromNode(it, "fromId");
+            rl.toId = readIntAttrFromNode(it, "toId");
+            if (attributeExits(it, "fromPos"))
+                rl.fromPos = readStrAttrFromNode(it, "fromPos");
+            if (attributeExits(it, "toPos"))
+                rl.toPos = readStrAttrFromNode(it, "toPos");
+
+            for (DOMElement *ll = it->getFirstElementChild(); ll != NULL; ll = ll->getNextElementSibling())
+            {
+                if (readNameFromNode(ll) != "laneLink")
+                    continue;
+
+                laneLinkInput l;
+                l.fromId = readIntAttrFromNode(ll, "fromId");
+                l.toId = readIntAttrFromNode(ll, "toId");
+                l.left = readStrAttrFromNode(ll, "left");
+                l.right = readStrAttrFromNode(ll, "right");
+                rl.laneLinks.push_back(l);
+            }
+            c.roadLinks.push_back(rl);
+        }
+    }
+
+    DOMElement *addLanes = getChildWithName(node, "additionalLanes");
+    if (addLanes != NULL)
+    {
+        c.hasAdditionalLanes = true;
+
+        for (DOMElement *it = addLanes->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            if (readNameFromNode(it) != "additionalLane")
+                continue;
+
+            additionalLaneInput a;
+            a.roadId = readIntAttrFromNode(it, "roadId");
+            if (attributeExits(it, "roadPos"))
+                a.roadPos = readStrAttrFromNode(it, "roadPos");
+            a.type = readStrAttrFromNode(it, "type");
+            a.hasLength = attributeExits(it, "length");
+            if (a.hasLength)
+                a.length = readDoubleAttrFromNode(it, "length");
+            a.hasDs = attributeExits(it, "ds");
+            if (a.hasDs)
+                a.ds = readDoubleAttrFromNode(it, "ds");
+            if (attributeExits(it, "amount"))
+                a.amount = readIntAttrFromNode(it, "amount");
+            if (attributeExits(it, "verschwenkung"))
+                a.verschwenkung = readBoolAttrFromNode(it, "verschwenkung");
+            c.additionalLanes.push_back(a);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief function parses a junction, roundabout or connectingRoad node
+ *
+ * @param node  segment node
+ * @param seg   parsed segment
+ * @return int  error code
+ */
+int parseSegment(DOMElement *node, segmentInput &seg)
+{
+    string name = readNameFromNode(node);
+    if (name == "junction")
+        seg.kind = junctionSegment;
+    else if (name == "roundabout")
+        seg.kind = roundaboutSegment;
+    else
+        seg.kind = connectingRoadSegment;
+
+    seg.id = readIntAttrFromNode(node, "id");
+    seg.type = readStrAttrFromNode(node, "type", true);
+
+    for (DOMElement *it = node->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+    {
+        string childName = readNameFromNode(it);
+
+        if (childName == "road")
+        {
+            roadInput r;
+            if (parseRoad(it, r))
+                return 1;
+            seg.roads.push_back(r);
+        }
+        else if (childName == "circle")
+        {
+            seg.hasCircle = true;
+            if (parseRoad(it, seg.circle))
+                return 1;
+        }
+        else if (childName == "intersectionPoint")
+        {
+            intersectionPointInput ip;
+            parseIntersectionPoint(it, ip);
+            seg.intersectionPoints.push_back(ip);
+        }
+        else if (childName == "coupler")
+        {
+            parseCoupler(it, seg.coupler);
+        }
+        else if (childName == "automaticWidening")
+        {
+            automaticWideningInput &aw = seg.automaticWidening;
+            seg.hasAutomaticWidening = true;
+
+            aw.hasActive = attributeExits(it, "active");
+            aw.active = readStrAttrFromNode(it, "active");
+            aw.hasLength = attributeExits(it, "length");
+            if (aw.hasLength)
+                aw.length = readDoubleAttrFromNode(it, "length");
+            aw.hasDs = attributeExits(it, "ds");
+            if (aw.hasDs)
+                aw.ds = readDoubleAttrFromNode(it, "ds");
+            aw.restricted = readBoolAttrFromNode(it, "restricted");
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief function parses a segmentLink node
+ *
+ * @param node  segmentLink node
+ * @param link  parsed link
+ */
+void parseSegmentLink(DOMElement *node, segmentLinkInput &link)
+{
+    link.fromSegment = readIntAttrFromNode(node, "fromSegment");
+    link.toSegment = readIntAttrFromNode(node, "toSegment");
+    link.fromRoad = readIntAttrFromNode(node, "fromRoad");
+    link.toRoad = readIntAttrFromNode(node, "toRoad");
+    link.fromPos = readStrAttrFromNode(node, "fromPos");
+    link.toPos = readStrAttrFromNode(node, "toPos");
+}
+
+/**
+ * @brief function converts the validated input tree into the input model. This is the only place where the generation reads the xml tree
+ *
+ * @param root      root node of the validated input tree
+ * @param input     resulting input model
+ * @return int      error code
+ */
+int parseInput(DOMElement *root, inputModel &input)
+{
+    DOMElement *segments = getChildWithName(root, "segments");
+    if (segments == NULL)
+    {
+        cerr << "ERR: 'segments' not found in input file." << endl;
+        cout << "ERR: 'segments' not found in input file." << endl;
+        return 1;
+    }
+
+    for (DOMElement *it = segments->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+    {
+        string name = readNameFromNode(it);
+        if (name != "junction" && name != "roundabout" && name != "connectingRoad")
+            continue;
+
+        segmentInput seg;
+        if (parseSegment(it, seg))
+        {
+            cerr << "ERR: segment " << seg.id << " can not be parsed." << endl;
+            return 1;
+        }
+        input.segments.push_back(seg);
+    }
+
+    DOMElement *links = getChildWithName(root, "links");
+    if (links != NULL)
+    {
+        input.hasLinks = true;
+        input.links.refId = readIntAttrFromNode(links, "refId");
+        input.links.hdgOffset = readDoubleAttrFromNode(links, "hdgOffset");
+        input.links.xOffset = readDoubleAttrFromNode(links, "xOffset");
+        input.links.yOffset = readDoubleAttrFromNode(links, "yOffset");
+
+        for (DOMElement *it = links->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            segmentLinkInput link;
+            parseSegmentLink(it, link);
+            input.links.segmentLinks.push_back(link);
+        }
+    }
+
+    DOMElement *closeRoads = getChildWithName(root, "closeRoads");
+    if (closeRoads != NULL)
+    {
+        input.hasCloseRoads = true;
+
+        for (DOMElement *it = closeRoads->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            if (readNameFromNode(it) != "segmentLink")
+                continue;
+
+            segmentLinkInput link;
+            parseSegmentLink(it, link);
+            input.closeRoads.push_back(link);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function converts the validated input tree into the input model
+ *
+ * @param inputxml  validated input tree
+ * @param input     resulting input model
+ * @return int      error code
+ */
+int parseInput(xmlTree &inputxml, inputModel &input)
+{
+    return parseInput(inputxml.getRootElement(), input);
+}
+
+/**
+ * @brief functions append a value to the key of a model. Strings are prefixed with their length, so that no escaping is needed,
+ * doubles are written with all significant digits
+ *
+ * @param key   resulting key
+ * @param v     value
+ */
+void appendKeyValue(string &key, const string &v)
+{
+    key += to_string(v.size()) + ":" + v + " ";
+}
+
+void appendKeyValue(string &key, double v)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.17g ", v);
+    key += buffer;
+}
+
+void appendKeyValue(string &key, int v)
+{
+    key += to_string(v) + " ";
+}
+
+void appendKeyValue(string &key, bool v)
+{
+    key += v ? "1 " : "0 ";
+}
+
+/**
+ * @brief function appends a list of model elements to a key
+ *
+ * @param key   resulting key
+ * @param v     model elements
+ */
+template <class T>
+void appendModelKey(string &key, const vector<T> &v)
+{
+    key += "[" + to_string(v.size()) + " ";
+    for (const T &e : v)
+        appendModelKey(key, e);
+    key += "] ";
+}
+
+void appendModelKey(string &key, const geometryInput &g)
+{
+    appendKeyValue(key, (int)g.type);
+    appendKeyValue(key, g.circle);
+    appendKeyValue(key, g.length);
+    appendKeyValue(key, g.R);
+    appendKeyValue(key, g.Rs);
+    appendKeyValue(key, g.Re);
+}
+
+void appendModelKey(string &key, const laneInput &l)
+{
+    appendKeyValue(key, l.id);
+    appendKeyValue(key, l.type);
+    appendKeyValue(key, l.hasWidth);
+    appendKeyValue(key, l.width);
+    appendKeyValue(key, l.hasSpeed);
+    appendKeyValue(key, l.speed);
+    appendKeyValue(key, l.markType);
+    appendKeyValue(key, l.markColor);
+    appendKeyValue(key, l.hasMarkWidth);
+    appendKeyValue(key, l.markWidth);
+    appendKeyValue(key, l.surface);
+    appendKeyValue(key, l.hasFriction);
+    appendKeyValue(key, l.friction);
+    appendKeyValue(key, l.hasRoughness);
+    appendKeyValue(key, l.roughness);
+}
+
+void appendModelKey(string &key, const laneChangeInput &c)
+{
+    appendKeyValue(key, c.widening);
+    appendKeyValue(key, c.side);
+    appendKeyValue(key, c.s);
+    appendKeyValue(key, c.hasLength);
+    appendKeyValue(key, c.length);
+    appendKeyValue(key, c.restrictedArea);
+    appendKeyValue(key, c.hasRestrictedLength);
+    appendKeyValue(key, c.restrictedLength);
+}
+
+void appendModelKey(string &key, const signalInput &sig)
+{
+    appendKeyValue(key, sig.id);
+    appendKeyValue(key, sig.type);
+    appendKeyValue(key, sig.value);
+    appendKeyValue(key, sig.dynamic);
+    appendKeyValue(key, sig.s);
+    appendKeyValue(key, sig.t);
+    appendKeyValue(key, sig.z);
+}
+
+void appendModelKey(string &key, const objectInput &o)
+{
+    appendKeyValue(key, o.type);
+    appendKeyValue(key, o.id);
+    appendKeyValue(key, o.s);
+    appendKeyValue(key, o.t);
+    appendKeyValue(key, o.hdg);
+    appendKeyValue(key, o.repeat);
+    appendKeyValue(key, o.len);
+    appendKeyValue(key, o.length);
+    appendKeyValue(key, o.width);
+    appendKeyValue(key, o.laneId);
+    appendModelKey(key, o.signals);
+}
+
+void appendModelKey(string &key, const roadInput &r)
+{
+    appendKeyValue(key, r.id);
+    appendKeyValue(key, r.classification);
+    appendModelKey(key, r.referenceLine);
+    appendModelKey(key, r.lanes);
+    appendModelKey(key, r.laneChanges);
+    appendModelKey(key, r.objects);
+}
+
+void appendModelKey(string &key, const adRoadInput &ad)
+{
+    appendKeyValue(key, ad.id);
+    appendKeyValue(key, ad.s);
+    appendKeyValue(key, ad.angle);
+}
+
+void appendModelKey(string &key, const intersectionPointInput &ip)
+{
+    appendKeyValue(key, ip.refRoad);
+    appendKeyValue(key, ip.s);
+    appendModelKey(key, ip.adRoads);
+}
+
+void appendModelKey(string &key, const roadGapInput &g)
+{
+    appendKeyValue(key, g.id);
+    appendKeyValue(key, g.gap);
+}
+
+void appendModelKey(string &key, const laneLinkInput &l)
+{
+    appendKeyValue(key, l.fromId);
+    appendKeyValue(key, l.toId);
+    appendKeyValue(key, l.left);
+    appendKeyValue(key, l.right);
+}
+
+void appendModelKey(string &key, const roadLinkInput &rl)
+{
+    appendKeyValue(key, rl.fromId);
+    appendKeyValue(key, rl.toId);
+    appendKeyValue(key, rl.fromPos);
+    appendKeyValue(key, rl.toPos);
+    appendModelKey(key, rl.laneLinks);
+}
+
+void appendModelKey(string &key, const additionalLaneInput &a)
+{
+    appendKeyValue(key, a.roadId);
+    appendKeyValue(key, a.roadPos);
+    appendKeyValue(key, a.type);
+    appendKeyValue(key, a.hasLength);
+    appendKeyValue(key, a.length);
+    appendKeyValue(key, a.hasDs);
+    appendKeyValue(key, a.ds);
+    appendKeyValue(key, a.amount);
+    appendKeyValue(key, a.verschwenkung);
+}
+
+void appendModelKey(string &key, const couplerInput &c)
+{
+    appendKeyValue(key, c.hasJunctionArea);
+    appendKeyValue(key, c.gap);
+    appendModelKey(key, c.roadGaps);
+    appendKeyValue(key, c.hasConnection);
+    appendKeyValue(key, c.connectionType);
+    appendModelKey(key, c.roadLinks);
+    appendKeyValue(key, c.hasAdditionalLanes);
+    appendModelKey(key, c.additionalLanes);
+}
+
+void appendModelKey(string &key, const automaticWideningInput &aw)
+{
+    appendKeyValue(key, aw.hasActive);
+    appendKeyValue(key, aw.active);
+    appendKeyValue(key, aw.hasLength);
+    appendKeyValue(key, aw.length);
+    appendKeyValue(key, aw.hasDs);
+    appendKeyValue(key, aw.ds);
+    appendKeyValue(key, aw.restricted);
+}
+
+/**
+ * @brief function computes the key of a segment from its input model. Segments with equal keys generate equal networks
+ *
+ * @param seg       segment input data
+ * @param withId    false if segments which only differ in their id should have the same key
+ * @return string   key of the segment
+ */
+string segmentKey(const segmentInput &seg, bool withId)
+{
+    string key;
+    appendKeyValue(key, (int)seg.kind);
+    if (withId)
+        appendKeyValue(key, seg.id);
+    appendKeyValue(key, seg.type);
+    appendModelKey(key, seg.roads);
+    appendKeyValue(key, seg.hasCircle);
+    if (seg.hasCircle)
+        appendModelKey(key, seg.circle);
+    appendModelKey(key, seg.intersectionPoints);
+    appendModelKey(key, seg.coupler);
+    appendKeyValue(key, seg.hasAutomaticWidening);
+    if (seg.hasAutomaticWidening)
+        appendModelKey(key, seg.automaticWidening);
+    return key;
+}
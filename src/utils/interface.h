@@ -15,7 +15,9 @@
  *
  */
 
-extern settings setting;
+#include <unordered_map>
+
+extern thread_local settings setting;
 
 // definition of basic types
 enum junctionGroupType
@@ -254,6 +256,25 @@ struct control
     vector<sign> signs;
 };
 
+/**
+ * @brief end of the last geometry of a road relative to the start of the geometry. The relative end does not change
+ * if the road is moved or rotated, so it stays valid as long as type, length and curvatures of the geometry are unchanged
+ * 
+ */
+struct endPoseCache
+{
+    bool valid = false;
+    geometryType type;
+    double length = 0;
+    double c = 0;
+    double c1 = 0;
+    double c2 = 0;
+
+    double dx = 0;
+    double dy = 0;
+    double dHdg = 0;
+};
+
 /**
  * @brief road holding all properties of a road
  * 
@@ -282,6 +303,8 @@ struct road
     vector<laneSection> laneSections;
     vector<object> objects;
     vector<sign> signs;
+
+    mutable endPoseCache endPose; // see endOfRoad
 };
 
 
@@ -307,6 +330,27 @@ struct junctionGroup
 
 };
 
+/**
+ * @brief lookup tables of the road network. Roads, junctions and junction groups are only appended and their ids
+ * are not changed afterwards, so the tables are extended incrementally before each lookup (see updateIndex).
+ * All road lists hold indices into roadNetwork::roads in ascending order
+ * 
+ */
+struct networkIndex
+{
+    size_t nRoads = 0;
+    size_t nJunctions = 0;
+    size_t nJuncGroups = 0;
+
+    unordered_map<int, vector<int>> roadsById;
+    unordered_map<int, vector<int>> roadsBySegment;             // road.junction, which holds the segment id
+    unordered_map<int, vector<int>> roadsByInputSegment;        // road.inputSegmentId
+    unordered_map<int, vector<int>> roadsByRoundAboutSegment;   // road.roundAboutInputSegment
+    unordered_map<int, vector<int>> roadsByInputId;             // road.inputId
+    unordered_map<int, int> junctionById;
+    unordered_map<int, junctionGroupType> juncGroupTypes;
+};
+
 /**
  * @brief roadNetwork is the overall struct holding all data
  * 
@@ -328,4 +372,7 @@ struct roadNetwork
     // global counters
     int nSignal = 0;
     int nSegment = 0;
+
+    // lookup tables, use the accessor functions in helper.h
+    networkIndex index;
 };
\ No newline at end of file
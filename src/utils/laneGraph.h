@@ -0,0 +1,363 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file laneGraph.h
+ *
+ * @brief This file contains the lane level routing graph of a generated network in compressed sparse row form
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <cstdint>
+
+/**
+ * @brief lane of a lane section, i.e. a node of the lane graph
+ *
+ */
+struct laneNode
+{
+    int road = -1;      // road id
+    int section = 0;    // index of the lane section in the road
+    int lane = 0;       // lane id
+    double length = 0;  // length of the lane section along the reference line
+    double speed = 0;   // speed limit in km/h
+};
+
+/**
+ * @brief lane graph of a network. The successors of node n are targets[offsets[n]] to targets[offsets[n + 1] - 1],
+ * an edge follows the driving direction of the lanes (right hand traffic) and costs the travel time of its source lane in seconds.
+ * Lanes without a speed limit use the standard speed of the settings
+ *
+ */
+struct laneGraph
+{
+    vector<laneNode> nodes;
+    vector<int> offsets;
+    vector<int> targets;
+    vector<double> costs;
+};
+
+/**
+ * @brief function finds the node of a lane at one end of a road
+ *
+ * @param data          roadNetwork data
+ * @param first         index of the first node of every road
+ * @param r             index of the road
+ * @param atStart       true for the first lane section, false for the last one
+ * @param lane          lane id
+ * @return int          node index, -1 if the lane does not exist
+ */
+int laneNodeAt(const roadNetwork &data, const vector<vector<int>> &first, int r, bool atStart, int lane)
+{
+    const road &rd = data.roads[r];
+    if (lane == 0 || rd.laneSections.empty())
+        return -1;
+
+    int sec = atStart ? 0 : (int)rd.laneSections.size() - 1;
+    const laneSection &ls = rd.laneSections[sec];
+    for (size_t k = 0; k < ls.lanes.size(); k++)
+        if (ls.lanes[k].id == lane)
+            return first[r][sec] + (int)k;
+    return -1;
+}
+
+/**
+ * @brief function adds the edge between two adjacent lanes. The direction is given by the first lane:
+ * traffic leaves a road at its end on the right lanes and at its start on the left lanes
+ *
+ * @param from      node of the first lane
+ * @param atEnd     true if the lanes meet at the end of the first lane
+ * @param lane      id of the first lane
+ * @param to        node of the second lane
+ * @param edges     list of edges
+ */
+void addLaneEdge(int from, bool atEnd, int lane, int to, vector<pair<int, int>> &edges)
+{
+    if (from < 0 || to < 0)
+        return;
+
+    if ((lane < 0) == atEnd)
+        edges.push_back(make_pair(from, to));
+    else
+        edges.push_back(make_pair(to, from));
+}
+
+/**
+ * @brief function builds the lane graph of a network. Lanes are linked by the lane predecessors and successors inside of a road
+ * and at road links. Connecting roads of junctions carry road links to their incoming and outgoing roads,
+ * the lane links of the junction connections are only used for connecting roads without such a road link
+ *
+ * @param data      roadNetwork data
+ * @param graph     resulting lane graph
+ * @return int      error code
+ */
+int buildLaneGraph(const roadNetwork &data, laneGraph &graph)
+{
+    graph = laneGraph();
+
+    unordered_map<int, int> roadIndex;
+    for (size_t r = 0; r < data.roads.size(); r++)
+        roadIndex.emplace(data.roads[r].id, (int)r);
+
+    // --- nodes ---------------------------------------------------------------
+    // every lane of a section gets a node, the center lane is kept to simplify the indexing and has no edges
+    vector<vector<int>> first(data.roads.size());
+    for (size_t r = 0; r < data.roads.size(); r++)
+    {
+        const road &rd = data.roads[r];
+        for (size_t sec = 0; sec < rd.laneSections.size(); sec++)
+        {
+            const laneSection &ls = rd.laneSections[sec];
+            double sEnd = (sec + 1 < rd.laneSections.size()) ? rd.laneSections[sec + 1].s : rd.length;
+
+            first[r].push_back((int)graph.nodes.size());
+            for (const lane &l : ls.lanes)
+            {
+                laneNode n;
+                n.road = rd.id;
+                n.section = (int)sec;
+                n.lane = l.id;
+                n.length = max(0.0, sEnd - ls.s);
+                n.speed = l.speed;
+                graph.nodes.push_back(n);
+            }
+        }
+    }
+
+    // --- edges ---------------------------------------------------------------
+    vector<pair<int, int>> edges;
+    for (size_t r = 0; r < data.roads.size(); r++)
+    {
+        const road &rd = data.roads[r];
+        int nSec = (int)rd.laneSections.size();
+
+        for (int sec = 0; sec < nSec; sec++)
+        {
+            const laneSection &ls = rd.laneSections[sec];
+            for (size_t k = 0; k < ls.lanes.size(); k++)
+            {
+                const lane &l = ls.lanes[k];
+                if (l.id == 0)
+                    continue;
+                int node = first[r][sec] + (int)k;
+
+                // successor, the next section or the successor road
+                if (l.sucId != 0 && sec + 1 < nSec)
+                {
+                    const laneSection &next = rd.laneSections[sec + 1];
+                    for (size_t j = 0; j < next.lanes.size(); j++)
+                        if (next.lanes[j].id == l.sucId)
+                            addLaneEdge(node, true, l.id, first[r][sec + 1] + (int)j, edges);
+                }
+                else if (l.sucId != 0 && rd.successor.elementType == roadType)
+                {
+                    unordered_map<int, int>::const_iterator it = roadIndex.find(rd.successor.id);
+                    if (it != roadIndex.end())
+                        addLaneEdge(node, true, l.id, laneNodeAt(data, first, it->second, rd.successor.contactPoint != endType, l.sucId), edges);
+                }
+
+                // predecessor, the previous section or the predecessor road
+                if (l.preId != 0 && sec > 0)
+                {
+                    const laneSection &prev = rd.laneSections[sec - 1];
+                    for (size_t j = 0; j < prev.lanes.size(); j++)
+                        if (prev.lanes[j].id == l.preId)
+                            addLaneEdge(node, false, l.id, first[r][sec - 1] + (int)j, edges);
+                }
+                else if (l.preId != 0 && rd.predecessor.elementType == roadType)
+                {
+                    unordered_map<int, int>::const_iterator it = roadIndex.find(rd.predecessor.id);
+                    if (it != roadIndex.end())
+                        addLaneEdge(node, false, l.id, laneNodeAt(data, first, it->second, rd.predecessor.contactPoint != endType, l.preId), edges);
+                }
+            }
+        }
+    }
+
+    for (const junction &j : data.junctions)
+    {
+        for (const connection &c : j.connections)
+        {
+            unordered_map<int, int>::const_iterator from = roadIndex.find(c.from);
+            unordered_map<int, int>::const_iterator to = roadIndex.find(c.to);
+            if (from == roadIndex.end() || to == roadIndex.end())
+                continue;
+
+            const road &incoming = data.roads[from->second];
+            const road &connecting = data.roads[to->second];
+
+            bool connectingAtStart = c.contactPoint != endType;
+            const link &l = connectingAtStart ? connecting.predecessor : connecting.successor;
+            if (l.elementType == roadType && l.id == incoming.id)
+                continue;
+
+            bool incomingAtEnd = incoming.successor.elementType == junctionType && incoming.successor.id == j.id;
+            if (!incomingAtEnd && !(incoming.predecessor.elementType == junctionType && incoming.predecessor.id == j.id))
+                continue;
+
+            int a = laneNodeAt(data, first, from->second, !incomingAtEnd, c.fromLane);
+            int b = laneNodeAt(data, first, to->second, connectingAtStart, c.toLane);
+            addLaneEdge(a, incomingAtEnd, c.fromLane, b, edges);
+        }
+    }
+
+    // both lanes of a link add its edge
+    sort(edges.begin(), edges.end());
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+
+    // --- compressed sparse rows ----------------------------------------------
+    graph.offsets.assign(graph.nodes.size() + 1, 0);
+    for (const pair<int, int> &e : edges)
+        graph.offsets[e.first + 1]++;
+    for (size_t n = 1; n < graph.offsets.size(); n++)
+        graph.offsets[n] += graph.offsets[n - 1];
+
+    // lanes without a speed limit are driven with the standard speed, edges are excluded from the routing by an
+    // infinite cost if the standard speed is not positive either
+    graph.targets.resize(edges.size());
+    graph.costs.resize(edges.size());
+    for (size_t k = 0; k < edges.size(); k++)
+    {
+        const laneNode &n = graph.nodes[edges[k].first];
+        double speed = (n.speed > 0) ? n.speed : setting.speed.standard;
+        graph.targets[k] = edges[k].second;
+        graph.costs[k] = (speed > 0) ? n.length / (speed / 3.6) : INFINITY;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function computes the fastest path between two lanes (dijkstra). The path starts at the first section of the start lane
+ * in driving direction and ends at the first reached section of the target lane
+ *
+ * @param graph     lane graph
+ * @param fromRoad  road id of the start lane
+ * @param fromLane  lane id of the start lane
+ * @param toRoad    road id of the target lane
+ * @param toLane    lane id of the target lane
+ * @param path      resulting nodes of the path
+ * @param cost      resulting travel time from the start of the first to the start of the last lane in seconds
+ * @return int      0 if a path was found, 1 otherwise
+ */
+int findLanePath(const laneGraph &graph, int fromRoad, int fromLane, int toRoad, int toLane, vector<int> &path, double &cost)
+{
+    path.clear();
+    if (fromLane == 0 || toLane == 0)
+        return 1;
+
+    // right lanes start in the first section, left lanes in the last one
+    int start = -1;
+    for (size_t n = 0; n < graph.nodes.size(); n++)
+    {
+        const laneNode &node = graph.nodes[n];
+        if (node.road != fromRoad || node.lane != fromLane)
+            continue;
+        if (start < 0 || (fromLane > 0 && node.section > graph.nodes[start].section))
+            start = (int)n;
+        if (fromLane < 0)
+            break;
+    }
+    if (start < 0)
+        return 1;
+
+    vector<double> dist(graph.nodes.size(), INFINITY);
+    vector<int> prev(graph.nodes.size(), -1);
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> queue;
+
+    dist[start] = 0;
+    queue.push(make_pair(0.0, start));
+
+    int target = -1;
+    while (!queue.empty())
+    {
+        pair<double, int> cur = queue.top();
+        queue.pop();
+        int n = cur.second;
+        if (cur.first > dist[n])
+            continue;
+
+        if (graph.nodes[n].road == toRoad && graph.nodes[n].lane == toLane)
+        {
+            target = n;
+            break;
+        }
+
+        for (int k = graph.offsets[n]; k < graph.offsets[n + 1]; k++)
+        {
+            int m = graph.targets[k];
+            double d = cur.first + graph.costs[k];
+            if (d < dist[m])
+            {
+                dist[m] = d;
+                prev[m] = n;
+                queue.push(make_pair(d, m));
+            }
+        }
+    }
+
+    if (target < 0)
+        return 1;
+
+    for (int n = target; n >= 0; n = prev[n])
+        path.push_back(n);
+    reverse(path.begin(), path.end());
+    cost = dist[target];
+    return 0;
+}
+
+/**
+ * @brief function writes the lane graph to a binary file. All values are stored in the byte order of the machine:
+ *
+ * header:  char[4] "RGLG", int32 version (1), int32 number of nodes N, int32 number of edges E
+ * nodes:   N times int32 road, int32 section, int32 lane, float64 length, float64 speed
+ * edges:   int32 offsets[N + 1], int32 targets[E], float64 costs[E]
+ *
+ * @param file      output file
+ * @param graph     lane graph
+ * @return int      error code
+ */
+int writeLaneGraph(const string &file, const laneGraph &graph)
+{
+    ofstream out(file.c_str(), ios::out | ios::binary);
+    if (!out.is_open())
+    {
+        cerr << "ERR: lane graph file " << file << " can not be opened" << endl;
+        return 1;
+    }
+
+    int32_t header[3] = {1, (int32_t)graph.nodes.size(), (int32_t)graph.targets.size()};
+    out.write("RGLG", 4);
+    out.write((const char *)header, sizeof(header));
+
+    for (const laneNode &n : graph.nodes)
+    {
+        int32_t ids[3] = {n.road, n.section, n.lane};
+        out.write((const char *)ids, sizeof(ids));
+        out.write((const char *)&n.length, sizeof(double));
+        out.write((const char *)&n.speed, sizeof(double));
+    }
+
+    out.write((const char *)graph.offsets.data(), graph.offsets.size() * sizeof(int32_t));
+    out.write((const char *)graph.targets.data(), graph.targets.size() * sizeof(int32_t));
+    out.write((const char *)graph.costs.data(), graph.costs.size() * sizeof(double));
+
+    if (!out.good())
+    {
+        cerr << "ERR: lane graph file " << file << " can not be written" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,517 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file networkAnalysis.h
+ *
+ * @brief This file contains the connectivity analysis of the driving lanes of a generated network
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <numeric>
+#include <map>
+
+/**
+ * @brief result of the connectivity analysis
+ *
+ */
+struct networkReport
+{
+    int problems = 0;
+    string json;
+};
+
+/**
+ * @brief disjoint sets with path halving and union by size
+ *
+ */
+struct unionFind
+{
+    vector<int> parent;
+    vector<int> size;
+
+    unionFind(int n) : parent(n), size(n, 1)
+    {
+        iota(parent.begin(), parent.end(), 0);
+    }
+
+    int find(int a)
+    {
+        while (parent[a] != a)
+        {
+            parent[a] = parent[parent[a]];
+            a = parent[a];
+        }
+        return a;
+    }
+
+    void unite(int a, int b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return;
+        if (size[a] < size[b])
+            swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+    }
+};
+
+/**
+ * @brief function writes a lane as json array
+ *
+ * @param n     lane node
+ * @param s     output stream
+ */
+void writeLaneJson(const laneNode &n, ostringstream &s)
+{
+    s << "[" << n.road << ", " << n.section << ", " << n.lane << "]";
+}
+
+// minimal penetration of two lane outlines which is reported as overlap
+const double overlapTolerance = 0.1;
+
+// overlaps of linked roads within this distance of their contact point are ignored
+const double overlapLinkDistance = 5.0;
+
+/**
+ * @brief overlap of two roads or self-intersection of a road (road1 == road2). The position of the first detected pair of lane outlines is stored
+ *
+ */
+struct roadOverlap
+{
+    int road1 = -1;
+    int road2 = -1;
+    int lane1 = 0;
+    int lane2 = 0;
+    double s1 = 0;
+    double s2 = 0;
+    double x = 0;
+    double y = 0;
+    int count = 0; // number of overlapping pairs of lane outlines
+};
+
+/**
+ * @brief function computes the penetration depth of two lane outlines (separating axis test)
+ *
+ * @param a         first element
+ * @param b         second element
+ * @return double   minimal overlap of the projections on all edge normals, 0 if the outlines are separated
+ */
+double penetrationDepth(const spatialElement &a, const spatialElement &b)
+{
+    double depth = INFINITY;
+    const spatialElement *e[2] = {&a, &b};
+
+    for (int p = 0; p < 2; p++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            int j = (i + 1) % 4;
+            double nx = e[p]->y[i] - e[p]->y[j];
+            double ny = e[p]->x[j] - e[p]->x[i];
+            double l = hypot(nx, ny);
+            if (l < 1e-9)
+                continue;
+            nx /= l;
+            ny /= l;
+
+            double aMin = INFINITY, aMax = -INFINITY, bMin = INFINITY, bMax = -INFINITY;
+            for (int k = 0; k < 4; k++)
+            {
+                double pa = a.x[k] * nx + a.y[k] * ny;
+                double pb = b.x[k] * nx + b.y[k] * ny;
+                aMin = min(aMin, pa);
+                aMax = max(aMax, pa);
+                bMin = min(bMin, pb);
+                bMax = max(bMax, pb);
+            }
+
+            depth = min(depth, min(aMax, bMax) - max(aMin, bMin));
+            if (depth <= 0)
+                return 0;
+        }
+    }
+    return (depth == INFINITY) ? 0 : depth;
+}
+
+/**
+ * @brief function computes the distance of an element to the contact point of a road link
+ *
+ * @param e         element
+ * @param r         road of the element
+ * @param atEnd     true if the road is linked at its end
+ * @return double   distance along the road
+ */
+double distanceToContact(const spatialElement &e, const road &r, bool atEnd)
+{
+    return atEnd ? r.length - e.s2 : e.s1;
+}
+
+/**
+ * @brief function checks if two roads are linked and the elements are close to the contact point
+ *
+ * @param a     first element
+ * @param ra    road of the first element
+ * @param b     second element
+ * @param rb    road of the second element
+ * @return true if the overlap is part of the transition between the roads
+ */
+bool nearLink(const spatialElement &a, const road &ra, const spatialElement &b, const road &rb)
+{
+    const link *la[2] = {&ra.predecessor, &ra.successor};
+    const link *lb[2] = {&rb.predecessor, &rb.successor};
+
+    for (int i = 0; i < 2; i++)
+    {
+        // a is linked to b, the contact point gives the end of b
+        if (la[i]->elementType == roadType && la[i]->id == rb.id &&
+            distanceToContact(a, ra, i == 1) < overlapLinkDistance &&
+            distanceToContact(b, rb, la[i]->contactPoint == endType) < overlapLinkDistance)
+            return true;
+
+        if (lb[i]->elementType == roadType && lb[i]->id == ra.id &&
+            distanceToContact(b, rb, i == 1) < overlapLinkDistance &&
+            distanceToContact(a, ra, lb[i]->contactPoint == endType) < overlapLinkDistance)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief function finds overlapping lane outlines of different roads and self-intersections of roads. The cells of the spatial index
+ * serve as spatial hash, a pair is tested in the cell which contains the lower corner of the intersection of its bounding boxes.
+ * Roads of the same junction or junction group, linked roads close to their contact point and neighboring samples of a road are not reported
+ *
+ * @param data      roadNetwork data
+ * @param index     spatial index of the network
+ * @param overlaps  resulting overlaps, one per pair of roads
+ * @return int      error code
+ */
+int findOverlaps(const roadNetwork &data, const spatialIndex &index, vector<roadOverlap> &overlaps)
+{
+    overlaps.clear();
+
+    unordered_map<int, int> roadIndex;
+    for (size_t r = 0; r < data.roads.size(); r++)
+        roadIndex.emplace(data.roads[r].id, (int)r);
+
+    // junction area of every road, the junctions of a group form one area
+    unordered_map<int, int> groupOf;
+    for (const junctionGroup &g : data.juncGroups)
+    {
+        groupOf[g.id] = g.id;
+        for (int id : g.juncIds)
+            groupOf[id] = g.id;
+    }
+
+    vector<long long> area(data.roads.size(), -1);
+    for (size_t r = 0; r < data.roads.size(); r++)
+    {
+        const road &rd = data.roads[r];
+        if (rd.isConnectingRoad || rd.junction < 0)
+            continue;
+        unordered_map<int, int>::const_iterator g = groupOf.find(rd.junction);
+        area[r] = (g != groupOf.end()) ? ((long long)g->second << 32) | 0xffffffffLL : rd.junction;
+    }
+
+    map<pair<int, int>, roadOverlap> found;
+    for (int j = 0; j < index.ny; j++)
+        for (int i = 0; i < index.nx; i++)
+        {
+            int c = j * index.nx + i;
+            for (int k1 = index.cellStart[c]; k1 < index.cellStart[c + 1]; k1++)
+            {
+                const spatialElement &a = index.elements[index.items[k1]];
+                if (a.n != 4)
+                    continue;
+
+                for (int k2 = k1 + 1; k2 < index.cellStart[c + 1]; k2++)
+                {
+                    const spatialElement &b = index.elements[index.items[k2]];
+                    if (b.n != 4)
+                        continue;
+
+                    if (a.xMax < b.xMin || b.xMax < a.xMin || a.yMax < b.yMin || b.yMax < a.yMin)
+                        continue;
+
+                    // the pair is only tested in one cell
+                    int ci, cj, tmp;
+                    double cx = max(a.xMin, b.xMin), cy = max(a.yMin, b.yMin);
+                    cellRange(index, cx, cy, cx, cy, ci, cj, tmp, tmp);
+                    if (ci != i || cj != j)
+                        continue;
+
+                    // neighboring samples and lanes of the same road touch each other
+                    if (a.road == b.road && max(a.s1, b.s1) - min(a.s2, b.s2) <= spatialIndexStep + 1e-9)
+                        continue;
+
+                    int ra = roadIndex[a.road];
+                    int rb = roadIndex[b.road];
+                    if (a.road != b.road && area[ra] >= 0 && area[ra] == area[rb])
+                        continue;
+
+                    if (penetrationDepth(a, b) <= overlapTolerance)
+                        continue;
+
+                    if (a.road != b.road && nearLink(a, data.roads[ra], b, data.roads[rb]))
+                        continue;
+
+                    const spatialElement &e1 = (a.road <= b.road) ? a : b;
+                    const spatialElement &e2 = (a.road <= b.road) ? b : a;
+                    roadOverlap &o = found[make_pair(e1.road, e2.road)];
+                    if (o.count == 0)
+                    {
+                        o.road1 = e1.road;
+                        o.road2 = e2.road;
+                        o.lane1 = e1.lane;
+                        o.lane2 = e2.lane;
+                        o.s1 = e1.s1;
+                        o.s2 = e2.s1;
+                        o.x = 0.5 * (max(a.xMin, b.xMin) + min(a.xMax, b.xMax));
+                        o.y = 0.5 * (max(a.yMin, b.yMin) + min(a.yMax, b.yMax));
+                    }
+                    o.count++;
+                }
+            }
+        }
+
+    for (const auto &o : found)
+        overlaps.push_back(o.second);
+    return 0;
+}
+
+/**
+ * @brief function analyzes the connectivity of the driving lanes and the geometry of the lanes of a network and writes a json report:
+ *
+ * components:              connected components of the driving lanes, largest first. Lanes are connected by the edges of the graph
+ *                          (ignoring the driving direction) and to the other driving lanes of their section.
+ *                          The lanes ([road, section, lane]) are listed for all but the largest component
+ * danglingLanes:           driving lanes without successor or predecessor. The reason is "open" at a road end without road link,
+ *                          "link" at a road end with road link and "section" between two lane sections of a road
+ * unreachableConnections:  junction connections whose connecting road can not be entered or left on a driving lane
+ * overlaps:                overlapping roads and self-intersecting roads (road1 == road2) outside of junctions, see findOverlaps
+ * problems:                number of additional components, dangling lanes which are not open, unreachable connections and overlaps
+ *
+ * @param data      roadNetwork data
+ * @param graph     lane graph of the network
+ * @param index     spatial index of the network
+ * @param report    resulting json report
+ * @return int      number of problems
+ */
+int analyzeNetwork(const roadNetwork &data, const laneGraph &graph, const spatialIndex &index, string &report)
+{
+    int nNodes = (int)graph.nodes.size();
+
+    // the nodes are created in the order of the roads, sections and lanes
+    vector<char> driving(nNodes, 0);
+    vector<int> roadOfNode(nNodes, -1);
+    int n = 0;
+    for (size_t r = 0; r < data.roads.size(); r++)
+        for (const laneSection &ls : data.roads[r].laneSections)
+            for (const lane &l : ls.lanes)
+            {
+                driving[n] = l.id != 0 && l.type == "driving";
+                roadOfNode[n] = (int)r;
+                n++;
+            }
+
+    // --- components ----------------------------------------------------------
+    unionFind sets(nNodes);
+
+    // the driving lanes of a section are connected laterally
+    n = 0;
+    for (size_t r = 0; r < data.roads.size(); r++)
+        for (const laneSection &ls : data.roads[r].laneSections)
+        {
+            int firstDriving = -1;
+            for (size_t k = 0; k < ls.lanes.size(); k++, n++)
+            {
+                if (!driving[n])
+                    continue;
+                if (firstDriving < 0)
+                    firstDriving = n;
+                sets.unite(firstDriving, n);
+            }
+        }
+
+    vector<int> inDegree(nNodes, 0);
+    vector<int> outDegree(nNodes, 0);
+    for (int a = 0; a < nNodes; a++)
+        for (int k = graph.offsets[a]; k < graph.offsets[a + 1]; k++)
+        {
+            int b = graph.targets[k];
+            if (!driving[a] || !driving[b])
+                continue;
+            sets.unite(a, b);
+            outDegree[a]++;
+            inDegree[b]++;
+        }
+
+    unordered_map<int, vector<int>> components;
+    int nDriving = 0;
+    for (int a = 0; a < nNodes; a++)
+    {
+        if (!driving[a])
+            continue;
+        components[sets.find(a)].push_back(a);
+        nDriving++;
+    }
+
+    vector<vector<int> *> sorted;
+    for (auto &c : components)
+        sorted.push_back(&c.second);
+    sort(sorted.begin(), sorted.end(), [](const vector<int> *a, const vector<int> *b) {
+        return a->size() != b->size() ? a->size() > b->size() : a->front() < b->front();
+    });
+
+    int problems = max(0, (int)sorted.size() - 1);
+
+    ostringstream s;
+    s << "{\n";
+    s << "  \"roads\": " << data.roads.size() << ",\n";
+    s << "  \"drivingLanes\": " << nDriving << ",\n";
+    s << "  \"components\": [";
+    for (size_t c = 0; c < sorted.size(); c++)
+    {
+        s << ((c > 0) ? ",\n" : "\n") << "    {\"size\": " << sorted[c]->size();
+        if (c > 0)
+        {
+            s << ", \"lanes\": [";
+            for (size_t k = 0; k < sorted[c]->size(); k++)
+            {
+                if (k > 0) s << ", ";
+                writeLaneJson(graph.nodes[(*sorted[c])[k]], s);
+            }
+            s << "]";
+        }
+        s << "}";
+    }
+    s << "\n  ],\n";
+
+    // --- dangling lanes ------------------------------------------------------
+    s << "  \"danglingLanes\": [";
+    bool firstEntry = true;
+    for (int a = 0; a < nNodes; a++)
+    {
+        if (!driving[a])
+            continue;
+
+        const laneNode &node = graph.nodes[a];
+        const road &r = data.roads[roadOfNode[a]];
+        for (int missing = 0; missing < 2; missing++)
+        {
+            if ((missing == 0 ? outDegree[a] : inDegree[a]) > 0)
+                continue;
+
+            // right lanes are left at the end of the road and entered at its start, left lanes vice versa
+            bool atEnd = (node.lane < 0) == (missing == 0);
+            bool roadEnd = atEnd ? node.section + 1 == (int)r.laneSections.size() : node.section == 0;
+            const link &l = atEnd ? r.successor : r.predecessor;
+
+            string reason = "section";
+            if (roadEnd)
+                reason = (l.id < 0) ? "open" : "link";
+            if (reason != "open")
+                problems++;
+
+            s << (firstEntry ? "\n" : ",\n") << "    {\"lane\": ";
+            writeLaneJson(node, s);
+            s << ", \"missing\": \"" << (missing == 0 ? "successor" : "predecessor") << "\", \"reason\": \"" << reason << "\"}";
+            firstEntry = false;
+        }
+    }
+    s << "\n  ],\n";
+
+    // --- junction connections ------------------------------------------------
+    unordered_map<int, int> roadIndex;
+    for (size_t r = 0; r < data.roads.size(); r++)
+        roadIndex.emplace(data.roads[r].id, (int)r);
+
+    // driving lanes of every road which are entered from or left to another road
+    vector<char> entered(data.roads.size(), 0);
+    vector<char> exited(data.roads.size(), 0);
+    for (int a = 0; a < nNodes; a++)
+        for (int k = graph.offsets[a]; k < graph.offsets[a + 1]; k++)
+        {
+            int b = graph.targets[k];
+            if (!driving[a] || !driving[b] || roadOfNode[a] == roadOfNode[b])
+                continue;
+            exited[roadOfNode[a]] = 1;
+            entered[roadOfNode[b]] = 1;
+        }
+
+    s << "  \"unreachableConnections\": [";
+    firstEntry = true;
+    for (const junction &j : data.junctions)
+        for (const connection &c : j.connections)
+        {
+            unordered_map<int, int>::const_iterator it = roadIndex.find(c.to);
+            string missing;
+            if (it == roadIndex.end())
+                missing = "road";
+            else if (!entered[it->second])
+                missing = "entry";
+            else if (!exited[it->second])
+                missing = "exit";
+            else
+                continue;
+
+            problems++;
+            s << (firstEntry ? "\n" : ",\n") << "    {\"junction\": " << j.id << ", \"connection\": " << c.id
+              << ", \"incomingRoad\": " << c.from << ", \"connectingRoad\": " << c.to << ", \"missing\": \"" << missing << "\"}";
+            firstEntry = false;
+        }
+    s << "\n  ],\n";
+
+    // --- overlaps ------------------------------------------------------------
+    vector<roadOverlap> overlaps;
+    findOverlaps(data, index, overlaps);
+    problems += (int)overlaps.size();
+
+    s << "  \"overlaps\": [";
+    for (size_t k = 0; k < overlaps.size(); k++)
+    {
+        const roadOverlap &o = overlaps[k];
+        s << ((k > 0) ? ",\n" : "\n") << "    {\"road1\": " << o.road1 << ", \"lane1\": " << o.lane1 << ", \"s1\": " << o.s1
+          << ", \"road2\": " << o.road2 << ", \"lane2\": " << o.lane2 << ", \"s2\": " << o.s2
+          << ", \"x\": " << o.x << ", \"y\": " << o.y << ", \"count\": " << o.count << "}";
+    }
+    s << "\n  ],\n";
+
+    s << "  \"problems\": " << problems << "\n";
+    s << "}\n";
+
+    report = s.str();
+    return problems;
+}
+
+/**
+ * @brief function writes the report of the connectivity analysis
+ *
+ * @param file      output file
+ * @param report    report
+ * @return int      error code
+ */
+int writeNetworkReport(const string &file, const networkReport &report)
+{
+    ofstream out(file.c_str(), ios::out | ios::binary);
+    if (!out.is_open())
+    {
+        cerr << "ERR: report file " << file << " can not be written" << endl;
+        return 1;
+    }
+    out.write(report.json.data(), report.json.size());
+
+    return out.good() ? 0 : 1;
+}
@@ -0,0 +1,369 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file profiling.h
+ *
+ * @brief This file contains the instrumentation of a pipeline run: wall and cpu time of every stage and segment type,
+ * peak memory usage and the size of the generated network
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <ctime>
+
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/**
+ * @brief accumulated times of a pipeline stage
+ *
+ */
+struct stageProfile
+{
+    string name;
+    int calls = 0;
+    double wall = 0; // seconds
+    double cpu = 0;  // seconds of the thread of the run and of the segment workers it started
+};
+
+/**
+ * @brief accumulated times of all segments of one type
+ *
+ */
+struct segmentProfile
+{
+    string type;
+    int count = 0;
+    int copied = 0;  // segments taken from the junction cache
+    double wall = 0; // seconds, summed over the segments, so concurrent segments can exceed the stage time
+    double cpu = 0;  // seconds of the threads which built the segments
+};
+
+/**
+ * @brief metrics of a single pipeline run
+ *
+ */
+struct pipelineProfile
+{
+    std::mutex mtx; // segments are added by the worker threads
+
+    vector<stageProfile> stages; // in order of their first execution
+    vector<segmentProfile> segments;
+    bool cached = false; // output was taken from the cache
+
+    long long roads = 0;
+    long long lanes = 0; // without center lanes
+    long long geometries = 0;
+    long long objects = 0;
+    long long signals = 0;
+    long long junctions = 0;
+    long long outputBytes = 0;
+
+    long long peakMemory = 0; // peak resident set size of the process in bytes
+    double wall = 0;
+    double cpu = 0;       // seconds of the thread of the run and of the segment workers
+    double workerCpu = 0; // seconds of the segment workers, added to the enclosing stage
+
+    string json;
+};
+
+/**
+ * @brief start of a measurement
+ *
+ */
+struct profileMark
+{
+    std::chrono::steady_clock::time_point wall;
+    double threadCpu = 0;
+    double workerCpu = 0;
+};
+
+/**
+ * @brief function returns the cpu time of the calling thread
+ *
+ * @return double   seconds
+ */
+double threadCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exited, &kernel, &user))
+        return 0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) * 1e-7;
+#else
+    timespec t;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t))
+        return 0;
+    return t.tv_sec + t.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * @brief function returns the peak resident set size of the process
+ *
+ * @return long long    bytes
+ */
+long long peakResidentSize()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+    return (long long)pmc.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#ifdef __APPLE__
+    return (long long)usage.ru_maxrss;
+#else
+    return (long long)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+/**
+ * @brief function starts a measurement
+ *
+ * @param profile       profile of the run, the clocks are not read if NULL
+ * @return profileMark  current wall and cpu times
+ */
+profileMark startProfile(pipelineProfile *profile)
+{
+    profileMark m;
+    if (profile == NULL)
+        return m;
+
+    m.wall = std::chrono::steady_clock::now();
+    m.threadCpu = threadCpuTime();
+
+    std::lock_guard<std::mutex> lock(profile->mtx);
+    m.workerCpu = profile->workerCpu;
+    return m;
+}
+
+/**
+ * @brief function returns the cpu time since a mark. The time is taken from the calling thread and the segment workers
+ * which finished in between, so concurrent runs of other contexts are not included
+ *
+ * @param profile   profile of the run, has to be locked by the caller
+ * @param mark      start of the measurement, created on the calling thread
+ * @return double   seconds
+ */
+double cpuSince(const pipelineProfile &profile, const profileMark &mark)
+{
+    return threadCpuTime() - mark.threadCpu + profile.workerCpu - mark.workerCpu;
+}
+
+/**
+ * @brief function adds the time since a mark to a stage. Stages with the same name are accumulated
+ *
+ * @param profile   profile of the run, nothing is recorded if NULL
+ * @param name      name of the stage
+ * @param mark      start of the stage
+ */
+void endStage(pipelineProfile *profile, const string &name, const profileMark &mark)
+{
+    if (profile == NULL)
+        return;
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - mark.wall).count();
+
+    std::lock_guard<std::mutex> lock(profile->mtx);
+    double cpu = cpuSince(*profile, mark);
+    vector<stageProfile>::iterator it = profile->stages.begin();
+    while (it != profile->stages.end() && it->name != name)
+        it++;
+    if (it == profile->stages.end())
+    {
+        profile->stages.push_back(stageProfile());
+        it = profile->stages.end() - 1;
+        it->name = name;
+    }
+    it->calls++;
+    it->wall += wall;
+    it->cpu += cpu;
+}
+
+/**
+ * @brief function adds the cpu time of a segment worker since a mark to the run. It is called by the worker before it
+ * terminates, so the time is contained in the stage which started the worker
+ *
+ * @param profile   profile of the run, nothing is recorded if NULL
+ * @param mark      start of the worker
+ */
+void endWorker(pipelineProfile *profile, const profileMark &mark)
+{
+    if (profile == NULL)
+        return;
+
+    double cpu = threadCpuTime() - mark.threadCpu;
+
+    std::lock_guard<std::mutex> lock(profile->mtx);
+    profile->workerCpu += cpu;
+}
+
+/**
+ * @brief function returns the generator of a segment
+ *
+ * @param em        segment input data
+ * @return string   xjunction, tjunction, roundAbout or connectingRoad
+ */
+string segmentTypeName(const segmentInput &em)
+{
+    if (em.kind == roundaboutSegment)
+        return "roundAbout";
+    if (em.kind == connectingRoadSegment)
+        return "connectingRoad";
+    if (em.type == "MA" || em.type == "3A")
+        return "tjunction";
+    return "xjunction";
+}
+
+/**
+ * @brief function adds the time since a mark to the type of a segment. The cpu time is taken from the calling thread,
+ * so the segment has to be built on the thread which created the mark
+ *
+ * @param profile   profile of the run, nothing is recorded if NULL
+ * @param em        segment input data
+ * @param copied    true if the segment was taken from the junction cache
+ * @param mark      start of the segment
+ */
+void endSegment(pipelineProfile *profile, const segmentInput &em, bool copied, const profileMark &mark)
+{
+    if (profile == NULL)
+        return;
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - mark.wall).count();
+    double cpu = threadCpuTime() - mark.threadCpu;
+    string type = segmentTypeName(em);
+
+    std::lock_guard<std::mutex> lock(profile->mtx);
+    vector<segmentProfile>::iterator it = profile->segments.begin();
+    while (it != profile->segments.end() && it->type != type)
+        it++;
+    if (it == profile->segments.end())
+    {
+        profile->segments.push_back(segmentProfile());
+        it = profile->segments.end() - 1;
+        it->type = type;
+    }
+    it->count++;
+    it->copied += copied;
+    it->wall += wall;
+    it->cpu += cpu;
+}
+
+/**
+ * @brief function counts the elements of the generated network
+ *
+ * @param data      roadNetwork data
+ * @param profile   profile of the run
+ */
+void countNetwork(const roadNetwork &data, pipelineProfile &profile)
+{
+    profile.roads = data.roads.size();
+    profile.junctions = data.junctions.size();
+    profile.lanes = 0;
+    profile.geometries = 0;
+    profile.objects = 0;
+    profile.signals = 0;
+
+    for (const road &r : data.roads)
+    {
+        profile.geometries += r.geometries.size();
+        profile.objects += r.objects.size();
+        profile.signals += r.signs.size();
+        for (const laneSection &ls : r.laneSections)
+            for (const lane &l : ls.lanes)
+                profile.lanes += (l.id != 0);
+    }
+}
+
+/**
+ * @brief function completes the profile of a run and creates the json report
+ *
+ * @param profile   profile of the run
+ * @param mark      start of the run
+ */
+void finishProfile(pipelineProfile &profile, const profileMark &mark)
+{
+    profile.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - mark.wall).count();
+    {
+        std::lock_guard<std::mutex> lock(profile.mtx);
+        profile.cpu = cpuSince(profile, mark);
+    }
+    profile.peakMemory = peakResidentSize();
+
+    ostringstream s;
+    s << setprecision(6) << fixed;
+    s << "{\n";
+    s << "  \"wallSeconds\": " << profile.wall << ",\n";
+    s << "  \"cpuSeconds\": " << profile.cpu << ",\n";
+    s << "  \"peakMemoryBytes\": " << profile.peakMemory << ",\n";
+    s << "  \"cached\": " << (profile.cached ? "true" : "false") << ",\n";
+
+    s << "  \"stages\": [";
+    for (size_t k = 0; k < profile.stages.size(); k++)
+    {
+        const stageProfile &st = profile.stages[k];
+        s << ((k > 0) ? ",\n" : "\n") << "    {\"name\": \"" << st.name << "\", \"calls\": " << st.calls
+          << ", \"wallSeconds\": " << st.wall << ", \"cpuSeconds\": " << st.cpu << "}";
+    }
+    s << "\n  ],\n";
+
+    s << "  \"segments\": [";
+    for (size_t k = 0; k < profile.segments.size(); k++)
+    {
+        const segmentProfile &sg = profile.segments[k];
+        s << ((k > 0) ? ",\n" : "\n") << "    {\"type\": \"" << sg.type << "\", \"count\": " << sg.count << ", \"copied\": " << sg.copied
+          << ", \"wallSeconds\": " << sg.wall << ", \"cpuSeconds\": " << sg.cpu << "}";
+    }
+    s << "\n  ],\n";
+
+    s << "  \"network\": {\"roads\": " << profile.roads << ", \"lanes\": " << profile.lanes << ", \"geometries\": " << profile.geometries
+      << ", \"objects\": " << profile.objects << ", \"signals\": " << profile.signals << ", \"junctions\": " << profile.junctions << "},\n";
+    s << "  \"outputBytes\": " << profile.outputBytes << "\n";
+    s << "}\n";
+
+    profile.json = s.str();
+}
+
+/**
+ * @brief function writes the json report of a profile
+ *
+ * @param file      output file
+ * @param profile   profile of the run
+ * @return int      error code
+ */
+int writeProfile(const string &file, const pipelineProfile &profile)
+{
+    ofstream out(file.c_str(), ios::out | ios::binary);
+    if (!out.is_open())
+    {
+        cerr << "ERR: profile file " << file << " can not be written" << endl;
+        return 1;
+    }
+    out.write(profile.json.data(), profile.json.size());
+
+    return out.good() ? 0 : 1;
+}
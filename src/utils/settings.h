@@ -76,6 +76,11 @@ struct settings
 
     bool silentMode = false; //silent mode disables console outputs
     bool overwriteLog = true;
+    bool outputValidation = true; // validate the generated output against the output.xsd
+    bool streamingWriter = false; // write the output with the streaming writer instead of the xerces DOM
+    bool snapshot = false; // write a binary snapshot of the generated network next to the output
+    std::string cacheDirectory; // directory of the output cache, empty disables the cache
+    int segmentThreads = 1; // worker threads which build the segments, 0 uses all available cores
     int warnings = 0; // counts number of warnings
 
     int versionMajor = 1; // OpenDrive major version
@@ -0,0 +1,928 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file snapshot.h
+ *
+ * @brief This file contains the binary snapshot format of a road network. A snapshot consists of flat tables of fixed size records,
+ * which can be read in place from a memory mapped file
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <cstdio>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*
+ * layout of a snapshot, all values are stored in the byte order of the machine and every table starts at a multiple of 8 bytes:
+ *
+ * snapshotHeader
+ * snapshotTable[nTables]           kind, record size, offset and number of records of every table
+ * tables                           see snapshotTableKind, records refer to other tables by index ranges (first, n)
+ *                                  and to strings by their index in the string table
+ *
+ * The version has to be increased whenever a record changes
+ */
+const char snapshotMagic[8] = {'R', 'G', 'S', 'N', 'A', 'P', 0, 0};
+const uint32_t snapshotVersion = 1;
+const uint32_t snapshotByteOrder = 0x01020304;
+
+enum snapshotTableKind
+{
+    snapshotNetwork = 1,
+    snapshotRoads,
+    snapshotGeometries,
+    snapshotLaneSections,
+    snapshotLanes,
+    snapshotObjects,
+    snapshotSigns,
+    snapshotControllers,
+    snapshotJunctions,
+    snapshotConnections,
+    snapshotJuncGroups,
+    snapshotJuncIds,
+    snapshotStrings,    // offset and length of every string in the string data
+    snapshotStringData
+};
+
+struct snapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t nTables;
+    uint32_t reserved;
+};
+
+struct snapshotTable
+{
+    uint32_t kind;
+    uint32_t recordSize;
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct snapshotNetworkRecord
+{
+    int32_t nSignal;
+    int32_t nSegment;
+    uint32_t file;
+    uint32_t outputFile;
+};
+
+struct snapshotLinkRecord
+{
+    int32_t id;
+    int32_t elementType;
+    int32_t contactPoint;
+};
+
+struct snapshotRoadRecord
+{
+    int32_t id;
+    int32_t inputSegmentId;
+    int32_t inputId;
+    int32_t roundAboutInputSegment;
+    int32_t junction;
+    uint8_t isConnectingRoad;
+    uint8_t isLinkedToNetwork;
+    uint8_t padding[2];
+    double length;
+    snapshotLinkRecord predecessor;
+    snapshotLinkRecord successor;
+    uint32_t inputPos;
+    uint32_t type;
+    uint32_t classification;
+    uint32_t firstGeometry, nGeometries;
+    uint32_t firstLaneSection, nLaneSections;
+    uint32_t firstObject, nObjects;
+    uint32_t firstSign, nSigns;
+};
+
+struct snapshotGeometryRecord
+{
+    int32_t type;
+    int32_t padding;
+    double s, x, y, hdg, length, c, c1, c2;
+};
+
+struct snapshotLaneSectionRecord
+{
+    int32_t id;
+    uint32_t firstLane, nLanes;
+    int32_t padding;
+    double s;
+    double a, b, c, d; // lane offset
+};
+
+struct snapshotLaneRecord
+{
+    int32_t id;
+    uint32_t type;
+    uint8_t turnLeft, turnStraight, turnRight, level;
+    int32_t preId;
+    int32_t sucId;
+    uint32_t roadmarkType, roadmarkWeight, roadmarkColor, surface;
+    int32_t padding;
+    double speed;
+    double widthS, widthA, widthB, widthC, widthD;
+    double roadmarkS, roadmarkWidth;
+    double materialS, friction, roughness;
+};
+
+struct snapshotObjectRecord
+{
+    int32_t id;
+    uint32_t type;
+    uint32_t orientation;
+    uint8_t repeat;
+    uint8_t padding[3];
+    double s, t, z, hdg, length, width, height, len, distance;
+};
+
+struct snapshotSignRecord
+{
+    int32_t id;
+    uint32_t type;
+    uint32_t subtype;
+    int32_t rule;
+    uint32_t orientation;
+    uint32_t country;
+    uint8_t dynamic;
+    uint8_t padding[7];
+    double value, s, t, z, width, height;
+};
+
+struct snapshotControllerRecord
+{
+    int32_t id;
+    uint32_t firstSign, nSigns;
+};
+
+struct snapshotJunctionRecord
+{
+    int32_t id;
+    uint32_t firstConnection, nConnections;
+};
+
+struct snapshotConnectionRecord
+{
+    int32_t id, from, to, contactPoint, fromLane, toLane;
+};
+
+struct snapshotJuncGroupRecord
+{
+    int32_t id;
+    uint32_t name;
+    int32_t type;
+    uint32_t firstJuncId, nJuncIds;
+};
+
+struct snapshotStringRecord
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+/**
+ * @brief tables of a snapshot while it is written. Equal strings are stored once
+ *
+ */
+struct snapshotBuilder
+{
+    snapshotNetworkRecord network;
+    vector<snapshotRoadRecord> roads;
+    vector<snapshotGeometryRecord> geometries;
+    vector<snapshotLaneSectionRecord> laneSections;
+    vector<snapshotLaneRecord> lanes;
+    vector<snapshotObjectRecord> objects;
+    vector<snapshotSignRecord> signs;
+    vector<snapshotControllerRecord> controllers;
+    vector<snapshotJunctionRecord> junctions;
+    vector<snapshotConnectionRecord> connections;
+    vector<snapshotJuncGroupRecord> juncGroups;
+    vector<int32_t> juncIds;
+    vector<snapshotStringRecord> strings;
+    string stringData;
+    unordered_map<string, uint32_t> stringIds;
+
+    uint32_t addString(const string &s)
+    {
+        unordered_map<string, uint32_t>::const_iterator it = stringIds.find(s);
+        if (it != stringIds.end())
+            return it->second;
+
+        snapshotStringRecord r = {(uint32_t)stringData.size(), (uint32_t)s.size()};
+        stringData += s;
+        strings.push_back(r);
+        stringIds.emplace(s, (uint32_t)strings.size() - 1);
+        return (uint32_t)strings.size() - 1;
+    }
+
+    void addSign(const sign &sg)
+    {
+        snapshotSignRecord r;
+        memset(&r, 0, sizeof(r));
+        r.id = sg.id;
+        r.type = addString(sg.type);
+        r.subtype = addString(sg.subtype);
+        r.rule = sg.rule;
+        r.orientation = addString(sg.orientation);
+        r.country = addString(sg.country);
+        r.dynamic = sg.dynamic;
+        r.value = sg.value;
+        r.s = sg.s;
+        r.t = sg.t;
+        r.z = sg.z;
+        r.width = sg.width;
+        r.height = sg.height;
+        signs.push_back(r);
+    }
+};
+
+/**
+ * @brief function converts a road link to a snapshot record
+ *
+ * @param l     link
+ * @return snapshotLinkRecord record
+ */
+snapshotLinkRecord linkRecord(const link &l)
+{
+    snapshotLinkRecord r = {l.id, (int32_t)l.elementType, (int32_t)l.contactPoint};
+    return r;
+}
+
+/**
+ * @brief function writes a road network as binary snapshot. The file is written under a temporary name and renamed afterwards,
+ * so that readers never map a partial snapshot
+ *
+ * @param file      snapshot file
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int writeSnapshot(const string &file, const roadNetwork &data)
+{
+    snapshotBuilder b;
+
+    b.network.nSignal = data.nSignal;
+    b.network.nSegment = data.nSegment;
+    b.network.file = b.addString(data.file);
+    b.network.outputFile = b.addString(data.outputFile);
+
+    for (const road &rd : data.roads)
+    {
+        snapshotRoadRecord r;
+        memset(&r, 0, sizeof(r));
+        r.id = rd.id;
+        r.inputSegmentId = rd.inputSegmentId;
+        r.inputId = rd.inputId;
+        r.roundAboutInputSegment = rd.roundAboutInputSegment;
+        r.junction = rd.junction;
+        r.isConnectingRoad = rd.isConnectingRoad;
+        r.isLinkedToNetwork = rd.isLinkedToNetwork;
+        r.length = rd.length;
+        r.predecessor = linkRecord(rd.predecessor);
+        r.successor = linkRecord(rd.successor);
+        r.inputPos = b.addString(rd.inputPos);
+        r.type = b.addString(rd.type);
+        r.classification = b.addString(rd.classification);
+
+        r.firstGeometry = (uint32_t)b.geometries.size();
+        r.nGeometries = (uint32_t)rd.geometries.size();
+        for (const geometry &g : rd.geometries)
+        {
+            snapshotGeometryRecord gr = {(int32_t)g.type, 0, g.s, g.x, g.y, g.hdg, g.length, g.c, g.c1, g.c2};
+            b.geometries.push_back(gr);
+        }
+
+        r.firstLaneSection = (uint32_t)b.laneSections.size();
+        r.nLaneSections = (uint32_t)rd.laneSections.size();
+        for (const laneSection &ls : rd.laneSections)
+        {
+            snapshotLaneSectionRecord sr = {ls.id, (uint32_t)b.lanes.size(), (uint32_t)ls.lanes.size(), 0, ls.s, ls.o.a, ls.o.b, ls.o.c, ls.o.d};
+            b.laneSections.push_back(sr);
+
+            for (const lane &l : ls.lanes)
+            {
+                snapshotLaneRecord lr;
+                memset(&lr, 0, sizeof(lr));
+                lr.id = l.id;
+                lr.type = b.addString(l.type);
+                lr.turnLeft = l.turnLeft;
+                lr.turnStraight = l.turnStraight;
+                lr.turnRight = l.turnRight;
+                lr.level = l.level;
+                lr.preId = l.preId;
+                lr.sucId = l.sucId;
+                lr.roadmarkType = b.addString(l.rm.type);
+                lr.roadmarkWeight = b.addString(l.rm.weight);
+                lr.roadmarkColor = b.addString(l.rm.color);
+                lr.surface = b.addString(l.m.surface);
+                lr.speed = l.speed;
+                lr.widthS = l.w.s;
+                lr.widthA = l.w.a;
+                lr.widthB = l.w.b;
+                lr.widthC = l.w.c;
+                lr.widthD = l.w.d;
+                lr.roadmarkS = l.rm.s;
+                lr.roadmarkWidth = l.rm.width;
+                lr.materialS = l.m.s;
+                lr.friction = l.m.friction;
+                lr.roughness = l.m.roughness;
+                b.lanes.push_back(lr);
+            }
+        }
+
+        r.firstObject = (uint32_t)b.objects.size();
+        r.nObjects = (uint32_t)rd.objects.size();
+        for (const object &o : rd.objects)
+        {
+            snapshotObjectRecord orc;
+            memset(&orc, 0, sizeof(orc));
+            orc.id = o.id;
+            orc.type = b.addString(o.type);
+            orc.orientation = b.addString(o.orientation);
+            orc.repeat = o.repeat;
+            orc.s = o.s;
+            orc.t = o.t;
+            orc.z = o.z;
+            orc.hdg = o.hdg;
+            orc.length = o.length;
+            orc.width = o.width;
+            orc.height = o.height;
+            orc.len = o.len;
+            orc.distance = o.distance;
+            b.objects.push_back(orc);
+        }
+
+        r.firstSign = (uint32_t)b.signs.size();
+        r.nSigns = (uint32_t)rd.signs.size();
+        for (const sign &sg : rd.signs)
+            b.addSign(sg);
+
+        b.roads.push_back(r);
+    }
+
+    for (const control &c : data.controller)
+    {
+        snapshotControllerRecord cr = {c.id, (uint32_t)b.signs.size(), (uint32_t)c.signs.size()};
+        b.controllers.push_back(cr);
+        for (const sign &sg : c.signs)
+            b.addSign(sg);
+    }
+
+    for (const junction &j : data.junctions)
+    {
+        snapshotJunctionRecord jr = {j.id, (uint32_t)b.connections.size(), (uint32_t)j.connections.size()};
+        b.junctions.push_back(jr);
+        for (const connection &c : j.connections)
+        {
+            snapshotConnectionRecord cr = {c.id, c.from, c.to, (int32_t)c.contactPoint, c.fromLane, c.toLane};
+            b.connections.push_back(cr);
+        }
+    }
+
+    for (const junctionGroup &g : data.juncGroups)
+    {
+        snapshotJuncGroupRecord gr = {g.id, b.addString(g.name), (int32_t)g.type, (uint32_t)b.juncIds.size(), (uint32_t)g.juncIds.size()};
+        b.juncGroups.push_back(gr);
+        b.juncIds.insert(b.juncIds.end(), g.juncIds.begin(), g.juncIds.end());
+    }
+
+    // --- layout --------------------------------------------------------------
+    struct tableData
+    {
+        uint32_t kind;
+        uint32_t recordSize;
+        const void *data;
+        uint64_t count;
+    };
+    tableData tables[] = {
+        {snapshotNetwork, sizeof(snapshotNetworkRecord), &b.network, 1},
+        {snapshotRoads, sizeof(snapshotRoadRecord), b.roads.data(), b.roads.size()},
+        {snapshotGeometries, sizeof(snapshotGeometryRecord), b.geometries.data(), b.geometries.size()},
+        {snapshotLaneSections, sizeof(snapshotLaneSectionRecord), b.laneSections.data(), b.laneSections.size()},
+        {snapshotLanes, sizeof(snapshotLaneRecord), b.lanes.data(), b.lanes.size()},
+        {snapshotObjects, sizeof(snapshotObjectRecord), b.objects.data(), b.objects.size()},
+        {snapshotSigns, sizeof(snapshotSignRecord), b.signs.data(), b.signs.size()},
+        {snapshotControllers, sizeof(snapshotControllerRecord), b.controllers.data(), b.controllers.size()},
+        {snapshotJunctions, sizeof(snapshotJunctionRecord), b.junctions.data(), b.junctions.size()},
+        {snapshotConnections, sizeof(snapshotConnectionRecord), b.connections.data(), b.connections.size()},
+        {snapshotJuncGroups, sizeof(snapshotJuncGroupRecord), b.juncGroups.data(), b.juncGroups.size()},
+        {snapshotJuncIds, sizeof(int32_t), b.juncIds.data(), b.juncIds.size()},
+        {snapshotStrings, sizeof(snapshotStringRecord), b.strings.data(), b.strings.size()},
+        {snapshotStringData, 1, b.stringData.data(), b.stringData.size()}};
+    const uint32_t nTables = sizeof(tables) / sizeof(tables[0]);
+
+    snapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = snapshotVersion;
+    header.byteOrder = snapshotByteOrder;
+    header.nTables = nTables;
+
+    vector<snapshotTable> entries(nTables);
+    uint64_t offset = sizeof(snapshotHeader) + nTables * sizeof(snapshotTable);
+    for (uint32_t k = 0; k < nTables; k++)
+    {
+        offset = (offset + 7) & ~(uint64_t)7;
+        entries[k].kind = tables[k].kind;
+        entries[k].recordSize = tables[k].recordSize;
+        entries[k].offset = offset;
+        entries[k].count = tables[k].count;
+        offset += tables[k].count * tables[k].recordSize;
+    }
+
+    // --- output --------------------------------------------------------------
+    string tmp = file + ".tmp";
+    {
+        ofstream out(tmp.c_str(), ios::out | ios::binary);
+        if (!out.is_open())
+        {
+            cerr << "ERR: snapshot file " << file << " can not be written" << endl;
+            return 1;
+        }
+
+        out.write((const char *)&header, sizeof(header));
+        out.write((const char *)entries.data(), nTables * sizeof(snapshotTable));
+
+        uint64_t pos = sizeof(snapshotHeader) + nTables * sizeof(snapshotTable);
+        const char zeros[8] = {0};
+        for (uint32_t k = 0; k < nTables; k++)
+        {
+            out.write(zeros, entries[k].offset - pos);
+            out.write((const char *)tables[k].data, tables[k].count * tables[k].recordSize);
+            pos = entries[k].offset + tables[k].count * tables[k].recordSize;
+        }
+
+        if (!out.good())
+        {
+            cerr << "ERR: snapshot file " << file << " can not be written" << endl;
+            out.close();
+            remove(tmp.c_str());
+            return 1;
+        }
+    }
+
+#ifdef _WIN32
+    remove(file.c_str()); // rename does not replace existing files on windows
+#endif
+    if (rename(tmp.c_str(), file.c_str()))
+    {
+        cerr << "ERR: snapshot file " << file << " can not be written" << endl;
+        remove(tmp.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief read only view of a snapshot file. The file is mapped into memory, on windows it is read into a buffer.
+ * The tables are validated when the file is opened and can be accessed in place afterwards
+ *
+ */
+class snapshotView
+{
+  public:
+    snapshotView() {}
+    snapshotView(const snapshotView &) = delete;
+    snapshotView &operator=(const snapshotView &) = delete;
+
+    ~snapshotView()
+    {
+        close();
+    }
+
+    /**
+     * @brief opens and validates a snapshot
+     *
+     * @param file  snapshot file
+     * @return int  error code
+     */
+    int open(const string &file)
+    {
+        close();
+
+#ifdef _WIN32
+        FILE *f = fopen(file.c_str(), "rb");
+        if (f == NULL)
+        {
+            cerr << "ERR: snapshot file " << file << " can not be opened" << endl;
+            return 1;
+        }
+        fseek(f, 0, SEEK_END);
+        long n = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        buffer.resize(n > 0 ? n : 0);
+        size_t nRead = (n > 0) ? fread(&buffer[0], 1, buffer.size(), f) : 0;
+        fclose(f);
+        if (nRead != buffer.size())
+        {
+            cerr << "ERR: snapshot file " << file << " can not be read" << endl;
+            return 1;
+        }
+        base = buffer.data();
+        size = buffer.size();
+#else
+        // unistd.h is not included, its link function would hide the link struct
+        FILE *f = fopen(file.c_str(), "rb");
+        if (f == NULL)
+        {
+            cerr << "ERR: snapshot file " << file << " can not be opened" << endl;
+            return 1;
+        }
+        struct stat st;
+        if (fstat(fileno(f), &st) == 0 && st.st_size > 0)
+        {
+            void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+            if (p != MAP_FAILED)
+            {
+                mapped = p;
+                base = (const char *)p;
+                size = st.st_size;
+            }
+        }
+        fclose(f);
+        if (base == NULL)
+        {
+            cerr << "ERR: snapshot file " << file << " can not be mapped" << endl;
+            return 1;
+        }
+#endif
+
+        if (validate())
+        {
+            cerr << "ERR: " << file << " is not a valid snapshot of version " << snapshotVersion << endl;
+            close();
+            return 1;
+        }
+        return 0;
+    }
+
+    void close()
+    {
+#ifndef _WIN32
+        if (mapped != NULL)
+            munmap(mapped, size);
+        mapped = NULL;
+#endif
+        buffer.clear();
+        base = NULL;
+        size = 0;
+        tables.clear();
+    }
+
+    /**
+     * @brief function returns a table of the snapshot
+     *
+     * @param kind  kind of the table
+     * @param count resulting number of records
+     * @return const T* first record, NULL if the table is missing
+     */
+    template <typename T>
+    const T *table(snapshotTableKind kind, size_t &count) const
+    {
+        count = 0;
+        for (const snapshotTable &t : tables)
+        {
+            if (t.kind != (uint32_t)kind || t.recordSize != sizeof(T))
+                continue;
+            count = (size_t)t.count;
+            return (const T *)(base + t.offset);
+        }
+        return NULL;
+    }
+
+    /**
+     * @brief function returns a string of the string table
+     *
+     * @param id        index of the string
+     * @return string   string, empty for an invalid index
+     */
+    string text(uint32_t id) const
+    {
+        if (id >= nStrings)
+            return "";
+        return string(stringData + strings[id].offset, strings[id].length);
+    }
+
+  private:
+    int validate()
+    {
+        if (size < sizeof(snapshotHeader))
+            return 1;
+
+        const snapshotHeader *h = (const snapshotHeader *)base;
+        if (memcmp(h->magic, snapshotMagic, sizeof(h->magic)) || h->version != snapshotVersion || h->byteOrder != snapshotByteOrder)
+            return 1;
+        if (h->nTables > 64 || size < sizeof(snapshotHeader) + h->nTables * sizeof(snapshotTable))
+            return 1;
+
+        const snapshotTable *t = (const snapshotTable *)(base + sizeof(snapshotHeader));
+        tables.assign(t, t + h->nTables);
+        for (const snapshotTable &e : tables)
+        {
+            if (e.offset % 8 != 0 || e.offset > size || e.recordSize == 0 || e.count > (size - e.offset) / e.recordSize)
+                return 1;
+        }
+
+        size_t nData;
+        strings = table<snapshotStringRecord>(snapshotStrings, nStrings);
+        stringData = table<char>(snapshotStringData, nData);
+        if (strings == NULL || stringData == NULL)
+            return 1;
+        for (size_t k = 0; k < nStrings; k++)
+            if (strings[k].offset > nData || strings[k].length > nData - strings[k].offset)
+                return 1;
+
+        return 0;
+    }
+
+    const char *base = NULL;
+    size_t size = 0;
+    void *mapped = NULL;
+    vector<char> buffer;
+    vector<snapshotTable> tables;
+
+    const snapshotStringRecord *strings = NULL;
+    size_t nStrings = 0;
+    const char *stringData = NULL;
+};
+
+/**
+ * @brief function checks that a range of records lies inside of a table
+ *
+ * @param first     first record
+ * @param n         number of records
+ * @param count     size of the table
+ * @return true if the range is valid
+ */
+bool validRange(uint32_t first, uint32_t n, size_t count)
+{
+    return first <= count && n <= count - first;
+}
+
+/**
+ * @brief function converts a snapshot record to a sign
+ *
+ * @param view      snapshot
+ * @param r         record
+ * @return sign     sign
+ */
+sign snapshotSign(const snapshotView &view, const snapshotSignRecord &r)
+{
+    sign sg;
+    sg.id = r.id;
+    sg.type = view.text(r.type);
+    sg.subtype = view.text(r.subtype);
+    sg.rule = r.rule;
+    sg.value = r.value;
+    sg.s = r.s;
+    sg.t = r.t;
+    sg.z = r.z;
+    sg.orientation = view.text(r.orientation);
+    sg.width = r.width;
+    sg.height = r.height;
+    sg.dynamic = r.dynamic != 0;
+    sg.country = view.text(r.country);
+    return sg;
+}
+
+/**
+ * @brief function converts a snapshot record to a road link
+ *
+ * @param r     record
+ * @return link link
+ */
+link snapshotLink(const snapshotLinkRecord &r)
+{
+    link l;
+    l.id = r.id;
+    l.elementType = (linkType)r.elementType;
+    l.contactPoint = (contactPointType)r.contactPoint;
+    return l;
+}
+
+/**
+ * @brief function loads a road network from a snapshot
+ *
+ * @param file      snapshot file
+ * @param data      resulting roadNetwork data
+ * @return int      error code
+ */
+int readSnapshot(const string &file, roadNetwork &data)
+{
+    snapshotView view;
+    if (view.open(file))
+        return 1;
+
+    size_t nNetwork, nRoads, nGeometries, nLaneSections, nLanes, nObjects, nSigns, nControllers, nJunctions, nConnections, nJuncGroups, nJuncIds;
+    const snapshotNetworkRecord *network = view.table<snapshotNetworkRecord>(snapshotNetwork, nNetwork);
+    const snapshotRoadRecord *roads = view.table<snapshotRoadRecord>(snapshotRoads, nRoads);
+    const snapshotGeometryRecord *geometries = view.table<snapshotGeometryRecord>(snapshotGeometries, nGeometries);
+    const snapshotLaneSectionRecord *laneSections = view.table<snapshotLaneSectionRecord>(snapshotLaneSections, nLaneSections);
+    const snapshotLaneRecord *lanes = view.table<snapshotLaneRecord>(snapshotLanes, nLanes);
+    const snapshotObjectRecord *objects = view.table<snapshotObjectRecord>(snapshotObjects, nObjects);
+    const snapshotSignRecord *signs = view.table<snapshotSignRecord>(snapshotSigns, nSigns);
+    const snapshotControllerRecord *controllers = view.table<snapshotControllerRecord>(snapshotControllers, nControllers);
+    const snapshotJunctionRecord *junctions = view.table<snapshotJunctionRecord>(snapshotJunctions, nJunctions);
+    const snapshotConnectionRecord *connections = view.table<snapshotConnectionRecord>(snapshotConnections, nConnections);
+    const snapshotJuncGroupRecord *juncGroups = view.table<snapshotJuncGroupRecord>(snapshotJuncGroups, nJuncGroups);
+    const int32_t *juncIds = view.table<int32_t>(snapshotJuncIds, nJuncIds);
+
+    if (network == NULL || nNetwork != 1)
+    {
+        cerr << "ERR: snapshot " << file << " has no network record" << endl;
+        return 1;
+    }
+
+    data = roadNetwork();
+    data.nSignal = network->nSignal;
+    data.nSegment = network->nSegment;
+    data.file = view.text(network->file);
+    data.outputFile = view.text(network->outputFile);
+
+    data.roads.resize(nRoads);
+    for (size_t k = 0; k < nRoads; k++)
+    {
+        const snapshotRoadRecord &r = roads[k];
+        if (!validRange(r.firstGeometry, r.nGeometries, nGeometries) || !validRange(r.firstLaneSection, r.nLaneSections, nLaneSections) ||
+            !validRange(r.firstObject, r.nObjects, nObjects) || !validRange(r.firstSign, r.nSigns, nSigns))
+        {
+            cerr << "ERR: road " << r.id << " of snapshot " << file << " is corrupted" << endl;
+            return 1;
+        }
+
+        road &rd = data.roads[k];
+        rd.id = r.id;
+        rd.inputSegmentId = r.inputSegmentId;
+        rd.inputId = r.inputId;
+        rd.roundAboutInputSegment = r.roundAboutInputSegment;
+        rd.junction = r.junction;
+        rd.isConnectingRoad = r.isConnectingRoad != 0;
+        rd.isLinkedToNetwork = r.isLinkedToNetwork != 0;
+        rd.length = r.length;
+        rd.predecessor = snapshotLink(r.predecessor);
+        rd.successor = snapshotLink(r.successor);
+        rd.inputPos = view.text(r.inputPos);
+        rd.type = view.text(r.type);
+        rd.classification = view.text(r.classification);
+
+        rd.geometries.resize(r.nGeometries);
+        for (uint32_t i = 0; i < r.nGeometries; i++)
+        {
+            const snapshotGeometryRecord &g = geometries[r.firstGeometry + i];
+            geometry &geo = rd.geometries[i];
+            geo.type = (geometryType)g.type;
+            geo.s = g.s;
+            geo.x = g.x;
+            geo.y = g.y;
+            geo.hdg = g.hdg;
+            geo.length = g.length;
+            geo.c = g.c;
+            geo.c1 = g.c1;
+            geo.c2 = g.c2;
+        }
+
+        rd.laneSections.resize(r.nLaneSections);
+        for (uint32_t i = 0; i < r.nLaneSections; i++)
+        {
+            const snapshotLaneSectionRecord &ls = laneSections[r.firstLaneSection + i];
+            if (!validRange(ls.firstLane, ls.nLanes, nLanes))
+            {
+                cerr << "ERR: road " << r.id << " of snapshot " << file << " is corrupted" << endl;
+                return 1;
+            }
+
+            laneSection &sec = rd.laneSections[i];
+            sec.id = ls.id;
+            sec.s = ls.s;
+            sec.o.a = ls.a;
+            sec.o.b = ls.b;
+            sec.o.c = ls.c;
+            sec.o.d = ls.d;
+
+            sec.lanes.resize(ls.nLanes);
+            for (uint32_t j = 0; j < ls.nLanes; j++)
+            {
+                const snapshotLaneRecord &lr = lanes[ls.firstLane + j];
+                lane &l = sec.lanes[j];
+                l.id = lr.id;
+                l.type = view.text(lr.type);
+                l.turnLeft = lr.turnLeft != 0;
+                l.turnStraight = lr.turnStraight != 0;
+                l.turnRight = lr.turnRight != 0;
+                l.level = lr.level != 0;
+                l.speed = lr.speed;
+                l.w.s = lr.widthS;
+                l.w.a = lr.widthA;
+                l.w.b = lr.widthB;
+                l.w.c = lr.widthC;
+                l.w.d = lr.widthD;
+                l.rm.s = lr.roadmarkS;
+                l.rm.type = view.text(lr.roadmarkType);
+                l.rm.weight = view.text(lr.roadmarkWeight);
+                l.rm.color = view.text(lr.roadmarkColor);
+                l.rm.width = lr.roadmarkWidth;
+                l.m.s = lr.materialS;
+                l.m.surface = view.text(lr.surface);
+                l.m.friction = lr.friction;
+                l.m.roughness = lr.roughness;
+                l.preId = lr.preId;
+                l.sucId = lr.sucId;
+            }
+        }
+
+        rd.objects.resize(r.nObjects);
+        for (uint32_t i = 0; i < r.nObjects; i++)
+        {
+            const snapshotObjectRecord &o = objects[r.firstObject + i];
+            object &obj = rd.objects[i];
+            obj.id = o.id;
+            obj.type = view.text(o.type);
+            obj.s = o.s;
+            obj.t = o.t;
+            obj.z = o.z;
+            obj.hdg = o.hdg;
+            obj.orientation = view.text(o.orientation);
+            obj.length = o.length;
+            obj.width = o.width;
+            obj.height = o.height;
+            obj.repeat = o.repeat != 0;
+            obj.len = o.len;
+            obj.distance = o.distance;
+        }
+
+        rd.signs.resize(r.nSigns);
+        for (uint32_t i = 0; i < r.nSigns; i++)
+            rd.signs[i] = snapshotSign(view, signs[r.firstSign + i]);
+    }
+
+    data.controller.resize(nControllers);
+    for (size_t k = 0; k < nControllers; k++)
+    {
+        if (!validRange(controllers[k].firstSign, controllers[k].nSigns, nSigns))
+        {
+            cerr << "ERR: controller " << controllers[k].id << " of snapshot " << file << " is corrupted" << endl;
+            return 1;
+        }
+        data.controller[k].id = controllers[k].id;
+        for (uint32_t i = 0; i < controllers[k].nSigns; i++)
+            data.controller[k].signs.push_back(snapshotSign(view, signs[controllers[k].firstSign + i]));
+    }
+
+    data.junctions.resize(nJunctions);
+    for (size_t k = 0; k < nJunctions; k++)
+    {
+        if (!validRange(junctions[k].firstConnection, junctions[k].nConnections, nConnections))
+        {
+            cerr << "ERR: junction " << junctions[k].id << " of snapshot " << file << " is corrupted" << endl;
+            return 1;
+        }
+        data.junctions[k].id = junctions[k].id;
+        for (uint32_t i = 0; i < junctions[k].nConnections; i++)
+        {
+            const snapshotConnectionRecord &c = connections[junctions[k].firstConnection + i];
+            connection con;
+            con.id = c.id;
+            con.from = c.from;
+            con.to = c.to;
+            con.contactPoint = (contactPointType)c.contactPoint;
+            con.fromLane = c.fromLane;
+            con.toLane = c.toLane;
+            data.junctions[k].connections.push_back(con);
+        }
+    }
+
+    data.juncGroups.resize(nJuncGroups);
+    for (size_t k = 0; k < nJuncGroups; k++)
+    {
+        const snapshotJuncGroupRecord &g = juncGroups[k];
+        if (!validRange(g.firstJuncId, g.nJuncIds, nJuncIds))
+        {
+            cerr << "ERR: junction group " << g.id << " of snapshot " << file << " is corrupted" << endl;
+            return 1;
+        }
+        data.juncGroups[k].id = g.id;
+        data.juncGroups[k].name = view.text(g.name);
+        data.juncGroups[k].type = (junctionGroupType)g.type;
+        data.juncGroups[k].juncIds.assign(juncIds + g.firstJuncId, juncIds + g.firstJuncId + g.nJuncIds);
+    }
+
+    return 0;
+}
@@ -0,0 +1,663 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file spatialIndex.h
+ *
+ * @brief This file contains a uniform grid over the sampled reference lines and lane outlines of a generated network
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+// step size used to sample the reference lines
+const double spatialIndexStep = 1.0;
+
+/**
+ * @brief part of a road between two samples. Reference lines are stored as segment with lane id 0,
+ * lanes as quadrilateral with the points inner(s1), inner(s2), outer(s2), outer(s1)
+ *
+ */
+struct spatialElement
+{
+    int road = -1;
+    int lane = 0;
+    double s1 = 0;
+    double s2 = 0;
+
+    int n = 2; // number of points, 2 for reference lines and 4 for lanes
+    double x[4];
+    double y[4];
+
+    double xMin, yMin, xMax, yMax; // bounding box
+};
+
+/**
+ * @brief uniform grid over all elements of a network. The elements of cell (i, j) are
+ * items[cellStart[j * nx + i]] to items[cellStart[j * nx + i + 1] - 1]. The index is not changed after it is built,
+ * so it can be queried from multiple threads
+ *
+ */
+struct spatialIndex
+{
+    vector<spatialElement> elements;
+
+    double x0 = 0;
+    double y0 = 0;
+    double cellSize = 1;
+    int nx = 0;
+    int ny = 0;
+    vector<int> cellStart;
+    vector<int> items;
+};
+
+/**
+ * @brief result of a query
+ *
+ */
+struct spatialHit
+{
+    int road = -1;
+    int lane = 0;
+    double s = 0;
+    double t = 0;           // signed lateral offset to the reference line, only set for reference lines
+    double distance = 0;    // distance for nearest queries, fraction of the query segment for intersections
+};
+
+/**
+ * @brief function computes the closest point on a segment
+ *
+ * @param px        x coordinate of the point
+ * @param py        y coordinate of the point
+ * @param x1        x coordinate of the start of the segment
+ * @param y1        y coordinate of the start of the segment
+ * @param x2        x coordinate of the end of the segment
+ * @param y2        y coordinate of the end of the segment
+ * @param u         resulting position of the closest point, 0 at the start and 1 at the end
+ * @return double   distance to the segment
+ */
+double distanceToSegment(double px, double py, double x1, double y1, double x2, double y2, double &u)
+{
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+    double l2 = dx * dx + dy * dy;
+
+    u = (l2 > 0) ? ((px - x1) * dx + (py - y1) * dy) / l2 : 0;
+    u = max(0.0, min(1.0, u));
+
+    return hypot(px - x1 - u * dx, py - y1 - u * dy);
+}
+
+/**
+ * @brief function computes the distance of a point to an element. Points inside of a lane have the distance 0
+ *
+ * @param e         element
+ * @param px        x coordinate of the point
+ * @param py        y coordinate of the point
+ * @param s         resulting s position of the closest point
+ * @return double   distance to the element
+ */
+double distanceToElement(const spatialElement &e, double px, double py, double &s)
+{
+    double u;
+    double d = distanceToSegment(px, py, e.x[0], e.y[0], e.x[1], e.y[1], u);
+    s = e.s1 + u * (e.s2 - e.s1);
+
+    if (e.n == 2)
+        return d;
+
+    bool inside = false;
+    for (int i = 0, j = 3; i < 4; j = i++)
+    {
+        if ((e.y[i] > py) != (e.y[j] > py) &&
+            px < (e.x[j] - e.x[i]) * (py - e.y[i]) / (e.y[j] - e.y[i]) + e.x[i])
+            inside = !inside;
+    }
+    if (inside)
+        return 0;
+
+    for (int i = 1; i < 4; i++)
+    {
+        double ui;
+        int j = (i + 1) % 4;
+        d = min(d, distanceToSegment(px, py, e.x[i], e.y[i], e.x[j], e.y[j], ui));
+    }
+    return d;
+}
+
+/**
+ * @brief function checks if an element overlaps a box (separating axis test)
+ *
+ * @param e     element
+ * @param xMin  minimal x coordinate of the box
+ * @param yMin  minimal y coordinate of the box
+ * @param xMax  maximal x coordinate of the box
+ * @param yMax  maximal y coordinate of the box
+ * @return true if the element and the box overlap
+ */
+bool overlapsBox(const spatialElement &e, double xMin, double yMin, double xMax, double yMax)
+{
+    if (e.xMax < xMin || e.xMin > xMax || e.yMax < yMin || e.yMin > yMax)
+        return false;
+
+    double bx[4] = {xMin, xMax, xMax, xMin};
+    double by[4] = {yMin, yMin, yMax, yMax};
+
+    int nEdges = (e.n == 2) ? 1 : 4;
+    for (int i = 0; i < nEdges; i++)
+    {
+        int j = (i + 1) % e.n;
+        double nx = e.y[i] - e.y[j];
+        double ny = e.x[j] - e.x[i];
+
+        double eMin = INFINITY, eMax = -INFINITY, bMin = INFINITY, bMax = -INFINITY;
+        for (int k = 0; k < e.n; k++)
+        {
+            double p = e.x[k] * nx + e.y[k] * ny;
+            eMin = min(eMin, p);
+            eMax = max(eMax, p);
+        }
+        for (int k = 0; k < 4; k++)
+        {
+            double p = bx[k] * nx + by[k] * ny;
+            bMin = min(bMin, p);
+            bMax = max(bMax, p);
+        }
+        if (eMax < bMin || bMax < eMin)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief function intersects two segments
+ *
+ * @param ax1   x coordinate of the start of the first segment
+ * @param ay1   y coordinate of the start of the first segment
+ * @param ax2   x coordinate of the end of the first segment
+ * @param ay2   y coordinate of the end of the first segment
+ * @param bx1   x coordinate of the start of the second segment
+ * @param by1   y coordinate of the start of the second segment
+ * @param bx2   x coordinate of the end of the second segment
+ * @param by2   y coordinate of the end of the second segment
+ * @param u     resulting position on the first segment
+ * @param v     resulting position on the second segment
+ * @return true if the segments intersect
+ */
+bool intersectSegments(double ax1, double ay1, double ax2, double ay2, double bx1, double by1, double bx2, double by2, double &u, double &v)
+{
+    double dax = ax2 - ax1, day = ay2 - ay1;
+    double dbx = bx2 - bx1, dby = by2 - by1;
+    double det = dax * dby - day * dbx;
+    if (det == 0)
+        return false;
+
+    u = ((bx1 - ax1) * dby - (by1 - ay1) * dbx) / det;
+    v = ((bx1 - ax1) * day - (by1 - ay1) * dax) / det;
+    return u >= 0 && u <= 1 && v >= 0 && v <= 1;
+}
+
+/**
+ * @brief function computes the first intersection of a segment with an element. A segment which starts inside of a lane intersects it at 0
+ *
+ * @param e     element
+ * @param x1    x coordinate of the start of the segment
+ * @param y1    y coordinate of the start of the segment
+ * @param x2    x coordinate of the end of the segment
+ * @param y2    y coordinate of the end of the segment
+ * @param u     resulting position on the segment
+ * @param s     resulting s position of the intersection
+ * @return true if the segment intersects the element
+ */
+bool intersectElement(const spatialElement &e, double x1, double y1, double x2, double y2, double &u, double &s)
+{
+    u = INFINITY;
+
+    if (e.n == 4 && distanceToElement(e, x1, y1, s) == 0)
+    {
+        u = 0;
+        return true;
+    }
+
+    int nEdges = (e.n == 2) ? 1 : 4;
+    for (int i = 0; i < nEdges; i++)
+    {
+        int j = (i + 1) % e.n;
+        double ui, vi;
+        if (!intersectSegments(x1, y1, x2, y2, e.x[i], e.y[i], e.x[j], e.y[j], ui, vi) || ui >= u)
+            continue;
+
+        u = ui;
+        // edges 0 and 2 run along the lane, edges 1 and 3 are at s2 and s1
+        if (i == 0) s = e.s1 + vi * (e.s2 - e.s1);
+        else if (i == 1) s = e.s2;
+        else if (i == 2) s = e.s2 + vi * (e.s1 - e.s2);
+        else s = e.s1;
+    }
+    return u != INFINITY;
+}
+
+/**
+ * @brief function adds the elements of a road to the index
+ *
+ * @param r         road
+ * @param step      step size of the samples
+ * @param elements  list of elements
+ * @return int      error code
+ */
+int addRoadElements(const road &r, double step, vector<spatialElement> &elements)
+{
+    if (r.geometries.empty())
+        return 0;
+
+    for (size_t k = 0; k < r.laneSections.size(); k++)
+    {
+        const laneSection &sec = r.laneSections[k];
+        double sStart = sec.s;
+        double sEnd = (k + 1 < r.laneSections.size()) ? r.laneSections[k + 1].s : r.length;
+        if (sEnd <= sStart)
+            continue;
+
+        // samples of the section, the end of the section is always included
+        int n = (int)ceil((sEnd - sStart) / step) + 1;
+        vector<double> s(n), x, y, phi;
+        for (int i = 0; i < n - 1; i++)
+            s[i] = sStart + i * step;
+        s[n - 1] = sEnd;
+
+        if (curveBatch(r.geometries, s, x, y, phi))
+            return 1;
+
+        // lanes sorted from the center to the outside
+        vector<const lane *> left, right;
+        for (const lane &l : sec.lanes)
+        {
+            if (l.id > 0) left.push_back(&l);
+            if (l.id < 0) right.push_back(&l);
+        }
+        sort(left.begin(), left.end(), [](const lane *a, const lane *b) { return a->id < b->id; });
+        sort(right.begin(), right.end(), [](const lane *a, const lane *b) { return a->id > b->id; });
+
+        // lateral offsets of the lane borders at every sample, the inner border of the first lane is the lane offset
+        size_t nBorders = 1 + left.size() + right.size();
+        vector<double> t(n * nBorders);
+        for (int i = 0; i < n; i++)
+        {
+            double ds = s[i] - sStart;
+            double *ti = &t[i * nBorders];
+            ti[0] = sec.o.a + sec.o.b * ds + sec.o.c * ds * ds + sec.o.d * ds * ds * ds;
+
+            double tLeft = ti[0], tRight = ti[0];
+            for (size_t j = 0; j < left.size(); j++)
+                ti[1 + j] = tLeft += laneWidth(*left[j], max(0.0, ds - left[j]->w.s));
+            for (size_t j = 0; j < right.size(); j++)
+                ti[1 + left.size() + j] = tRight -= laneWidth(*right[j], max(0.0, ds - right[j]->w.s));
+        }
+
+        for (int i = 0; i + 1 < n; i++)
+        {
+            spatialElement e;
+            e.road = r.id;
+            e.s1 = s[i];
+            e.s2 = s[i + 1];
+
+            e.lane = 0;
+            e.n = 2;
+            e.x[0] = x[i];
+            e.y[0] = y[i];
+            e.x[1] = x[i + 1];
+            e.y[1] = y[i + 1];
+            elements.push_back(e);
+
+            e.n = 4;
+            for (size_t j = 0; j < left.size() + right.size(); j++)
+            {
+                e.lane = (j < left.size()) ? left[j]->id : right[j - left.size()]->id;
+
+                // the innermost lanes of both sides start at the lane offset
+                size_t inner = (j == 0 || j == left.size()) ? 0 : j;
+                size_t outer = j + 1;
+
+                int samples[4] = {i, i + 1, i + 1, i};
+                size_t borders[4] = {inner, inner, outer, outer};
+                for (int p = 0; p < 4; p++)
+                {
+                    double tp = t[samples[p] * nBorders + borders[p]];
+                    e.x[p] = x[samples[p]] - sin(phi[samples[p]]) * tp;
+                    e.y[p] = y[samples[p]] + cos(phi[samples[p]]) * tp;
+                }
+                elements.push_back(e);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function computes the cell range of a box
+ *
+ * @param index     spatial index
+ * @param xMin      minimal x coordinate of the box
+ * @param yMin      minimal y coordinate of the box
+ * @param xMax      maximal x coordinate of the box
+ * @param yMax      maximal y coordinate of the box
+ * @param i1        first column
+ * @param j1        first row
+ * @param i2        last column
+ * @param j2        last row
+ */
+void cellRange(const spatialIndex &index, double xMin, double yMin, double xMax, double yMax, int &i1, int &j1, int &i2, int &j2)
+{
+    i1 = max(0, min(index.nx - 1, (int)floor((xMin - index.x0) / index.cellSize)));
+    j1 = max(0, min(index.ny - 1, (int)floor((yMin - index.y0) / index.cellSize)));
+    i2 = max(0, min(index.nx - 1, (int)floor((xMax - index.x0) / index.cellSize)));
+    j2 = max(0, min(index.ny - 1, (int)floor((yMax - index.y0) / index.cellSize)));
+}
+
+/**
+ * @brief function builds the spatial index of a network. The reference lines are sampled with spatialIndexStep
+ *
+ * @param data      roadNetwork data
+ * @param index     resulting spatial index
+ * @return int      error code
+ */
+int buildSpatialIndex(const roadNetwork &data, spatialIndex &index)
+{
+    index = spatialIndex();
+
+    for (const road &r : data.roads)
+    {
+        if (addRoadElements(r, spatialIndexStep, index.elements))
+        {
+            cerr << "ERR: road " << r.id << " can not be sampled for the spatial index" << endl;
+            return 1;
+        }
+    }
+
+    if (index.elements.empty())
+        return 0;
+
+    double xMin = INFINITY, yMin = INFINITY, xMax = -INFINITY, yMax = -INFINITY;
+    for (spatialElement &e : index.elements)
+    {
+        e.xMin = *min_element(e.x, e.x + e.n);
+        e.xMax = *max_element(e.x, e.x + e.n);
+        e.yMin = *min_element(e.y, e.y + e.n);
+        e.yMax = *max_element(e.y, e.y + e.n);
+
+        xMin = min(xMin, e.xMin);
+        yMin = min(yMin, e.yMin);
+        xMax = max(xMax, e.xMax);
+        yMax = max(yMax, e.yMax);
+    }
+
+    // a few samples per cell, the number of cells is limited by the number of elements
+    double maxCells = 4.0 * index.elements.size();
+    index.cellSize = max(4 * spatialIndexStep, sqrt((xMax - xMin) * (yMax - yMin) / maxCells));
+    index.x0 = xMin;
+    index.y0 = yMin;
+    index.nx = (int)((xMax - xMin) / index.cellSize) + 1;
+    index.ny = (int)((yMax - yMin) / index.cellSize) + 1;
+
+    // counting sort of the elements into the cells
+    index.cellStart.assign((size_t)index.nx * index.ny + 1, 0);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            for (size_t c = 1; c < index.cellStart.size(); c++)
+                index.cellStart[c] += index.cellStart[c - 1];
+            index.items.resize(index.cellStart.back());
+        }
+
+        for (size_t k = 0; k < index.elements.size(); k++)
+        {
+            const spatialElement &e = index.elements[k];
+            int i1, j1, i2, j2;
+            cellRange(index, e.xMin, e.yMin, e.xMax, e.yMax, i1, j1, i2, j2);
+
+            for (int j = j1; j <= j2; j++)
+                for (int i = i1; i <= i2; i++)
+                {
+                    int c = j * index.nx + i;
+                    if (pass == 0)
+                        index.cellStart[c + 1]++;
+                    else
+                        index.items[index.cellStart[c]++] = (int)k;
+                }
+        }
+    }
+
+    // the second pass moved every start to the start of the next cell
+    for (size_t c = index.cellStart.size() - 1; c > 0; c--)
+        index.cellStart[c] = index.cellStart[c - 1];
+    index.cellStart[0] = 0;
+
+    return 0;
+}
+
+/**
+ * @brief function finds the closest element to a point. The cells are searched in rings around the point
+ * until no closer element can be found
+ *
+ * @param index             spatial index
+ * @param x                 x coordinate of the point
+ * @param y                 y coordinate of the point
+ * @param referenceLines    true to search the reference lines, false to search the lanes
+ * @param hit               resulting closest element
+ * @return int              0 if an element was found, 1 otherwise
+ */
+int nearestElement(const spatialIndex &index, double x, double y, bool referenceLines, spatialHit &hit)
+{
+    if (index.elements.empty())
+        return 1;
+
+    int ci, cj, tmp;
+    cellRange(index, x, y, x, y, ci, cj, tmp, tmp);
+
+    const spatialElement *best = NULL;
+    double bestDistance = INFINITY;
+    double bestS = 0;
+
+    int maxRing = max(index.nx, index.ny);
+    for (int ring = 0; ring <= maxRing; ring++)
+    {
+        // elements of the following rings are at least ring * cellSize away
+        if (best != NULL && bestDistance <= ring * index.cellSize - index.cellSize)
+            break;
+
+        for (int j = cj - ring; j <= cj + ring; j++)
+        {
+            if (j < 0 || j >= index.ny)
+                continue;
+
+            // inner rows of the ring only consist of the first and the last column
+            int di = (j == cj - ring || j == cj + ring) ? 1 : max(1, 2 * ring);
+            for (int i = ci - ring; i <= ci + ring; i += di)
+            {
+                if (i < 0 || i >= index.nx)
+                    continue;
+
+                int c = j * index.nx + i;
+                for (int k = index.cellStart[c]; k < index.cellStart[c + 1]; k++)
+                {
+                    const spatialElement &e = index.elements[index.items[k]];
+                    if ((e.lane == 0) != referenceLines)
+                        continue;
+
+                    double s;
+                    double d = distanceToElement(e, x, y, s);
+                    if (d < bestDistance)
+                    {
+                        best = &e;
+                        bestDistance = d;
+                        bestS = s;
+                    }
+                }
+            }
+        }
+    }
+
+    if (best == NULL)
+        return 1;
+
+    hit.road = best->road;
+    hit.lane = best->lane;
+    hit.s = bestS;
+    hit.distance = bestDistance;
+    hit.t = 0;
+
+    if (referenceLines)
+    {
+        // signed offset, positive on the left side of the reference line
+        double dx = best->x[1] - best->x[0];
+        double dy = best->y[1] - best->y[0];
+        double cross = dx * (y - best->y[0]) - dy * (x - best->x[0]);
+        hit.t = (cross < 0) ? -bestDistance : bestDistance;
+    }
+    return 0;
+}
+
+/**
+ * @brief function finds all lanes and reference lines which overlap a box. Every road and lane is returned once,
+ * lane 0 stands for the reference line
+ *
+ * @param index     spatial index
+ * @param xMin      minimal x coordinate of the box
+ * @param yMin      minimal y coordinate of the box
+ * @param xMax      maximal x coordinate of the box
+ * @param yMax      maximal y coordinate of the box
+ * @param hits      resulting road and lane ids, sorted by road and lane
+ * @return int      error code
+ */
+int findInBox(const spatialIndex &index, double xMin, double yMin, double xMax, double yMax, vector<pair<int, int>> &hits)
+{
+    hits.clear();
+    if (index.elements.empty() || xMax < xMin || yMax < yMin)
+        return 0;
+
+    int i1, j1, i2, j2;
+    cellRange(index, xMin, yMin, xMax, yMax, i1, j1, i2, j2);
+
+    for (int j = j1; j <= j2; j++)
+        for (int i = i1; i <= i2; i++)
+        {
+            int c = j * index.nx + i;
+            for (int k = index.cellStart[c]; k < index.cellStart[c + 1]; k++)
+            {
+                const spatialElement &e = index.elements[index.items[k]];
+                if (overlapsBox(e, xMin, yMin, xMax, yMax))
+                    hits.push_back(make_pair(e.road, e.lane));
+            }
+        }
+
+    sort(hits.begin(), hits.end());
+    hits.erase(unique(hits.begin(), hits.end()), hits.end());
+    return 0;
+}
+
+/**
+ * @brief function finds the first lane or reference line which is crossed by a segment. The cells are traversed along the segment,
+ * the traversal stops as soon as the remaining cells can not contain a closer intersection
+ *
+ * @param index     spatial index
+ * @param x1        x coordinate of the start of the segment
+ * @param y1        y coordinate of the start of the segment
+ * @param x2        x coordinate of the end of the segment
+ * @param y2        y coordinate of the end of the segment
+ * @param hit       resulting intersection, distance holds the position on the segment from 0 to 1
+ * @return int      0 if the segment intersects an element, 1 otherwise
+ */
+int firstIntersection(const spatialIndex &index, double x1, double y1, double x2, double y2, spatialHit &hit)
+{
+    if (index.elements.empty())
+        return 1;
+
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+
+    // clip the segment to the grid
+    double gx2 = index.x0 + index.nx * index.cellSize;
+    double gy2 = index.y0 + index.ny * index.cellSize;
+    double u0 = 0, u1 = 1;
+    double p[4] = {-dx, dx, -dy, dy};
+    double q[4] = {x1 - index.x0, gx2 - x1, y1 - index.y0, gy2 - y1};
+    for (int k = 0; k < 4; k++)
+    {
+        if (p[k] == 0)
+        {
+            if (q[k] < 0) return 1;
+            continue;
+        }
+        double r = q[k] / p[k];
+        if (p[k] < 0) u0 = max(u0, r);
+        else u1 = min(u1, r);
+    }
+    if (u0 > u1)
+        return 1;
+
+    int i, j, tmp;
+    cellRange(index, x1 + u0 * dx, y1 + u0 * dy, x1 + u0 * dx, y1 + u0 * dy, i, j, tmp, tmp);
+
+    int stepI = (dx > 0) ? 1 : -1;
+    int stepJ = (dy > 0) ? 1 : -1;
+    double deltaU = (dx != 0) ? index.cellSize / fabs(dx) : INFINITY;
+    double deltaV = (dy != 0) ? index.cellSize / fabs(dy) : INFINITY;
+    double nextU = (dx != 0) ? (index.x0 + (i + (dx > 0)) * index.cellSize - x1) / dx : INFINITY;
+    double nextV = (dy != 0) ? (index.y0 + (j + (dy > 0)) * index.cellSize - y1) / dy : INFINITY;
+
+    const spatialElement *best = NULL;
+    double bestU = INFINITY;
+    double bestS = 0;
+    double cellU = u0; // position where the segment enters the current cell
+
+    while (i >= 0 && i < index.nx && j >= 0 && j < index.ny && cellU <= u1 && cellU <= bestU)
+    {
+        int c = j * index.nx + i;
+        for (int k = index.cellStart[c]; k < index.cellStart[c + 1]; k++)
+        {
+            const spatialElement &e = index.elements[index.items[k]];
+            double u, s;
+            if (intersectElement(e, x1, y1, x2, y2, u, s) && u < bestU)
+            {
+                best = &e;
+                bestU = u;
+                bestS = s;
+            }
+        }
+
+        if (nextU < nextV)
+        {
+            cellU = nextU;
+            nextU += deltaU;
+            i += stepI;
+        }
+        else
+        {
+            cellU = nextV;
+            nextV += deltaV;
+            j += stepJ;
+        }
+    }
+
+    if (best == NULL)
+        return 1;
+
+    hit.road = best->road;
+    hit.lane = best->lane;
+    hit.s = bestS;
+    hit.t = 0;
+    hit.distance = bestU;
+    return 0;
+}
@@ -19,17 +19,19 @@
 #include <xercesc/util/XMLString.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/framework/LocalFileInputSource.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/sax/ErrorHandler.hpp>
 #include <xercesc/sax/SAXParseException.hpp>
 #include <xercesc/validators/common/Grammar.hpp>
 #include <algorithm>
 #include "xmlParser.h"
+#include "xodrWriter.h"
 
 using namespace XERCES_CPP_NAMESPACE;
 using namespace std;
 using namespace xercesc;
 
-extern settings setting;
+extern thread_local settings setting;
 
 /**
  * @brief function checks the input file against the corresponding input.xsd
@@ -44,7 +46,7 @@ int validateInput(char *file, xmlTree &xmlInput)
     const char *schema_file = schema.c_str();
     const char *xml_file = file;
 
-    if (xmlInput.loadGrammar(schema_file) == NULL)
+    if (xmlInput.loadGrammar(schema_file))
     {
         cerr << "ERR: couldn't load schema" << endl;
         return 1;
@@ -66,38 +68,35 @@ int validateInput(char *file, xmlTree &xmlInput)
 }
 
 /**
- * @brief function checks the output file against the corresponding output.xsd
+ * @brief function checks the generated output against the corresponding output.xsd. 
+ * The document is validated directly from memory, the output file is not read again
  * 
- * @param data  output data
+ * @param xodr  generated OpenDRIVE document
  * @return int  error code
  */
-int validateOutput(roadNetwork &data)
+int validateOutput(const string &xodr)
 {
-    // setup file
-    string file = data.outputFile;
-    file.append(".xodr");
-    const char *xml_file = file.c_str();
-
-    XMLPlatformUtils::Initialize();
-
     string schema = string_format("%s/xml/output.xsd", PROJ_DIR);
     const char *schema_path = schema.c_str();
 
-    // load output file
-    XercesDOMParser domParser;
-    if (domParser.loadGrammar(schema_path, Grammar::SchemaGrammarType) == NULL)
+    // load schema from grammar cache
+    XMLGrammarPool *pool = getGrammarPool(schema_path);
+    if (pool == NULL)
     {
         cerr << "ERR: couldn't load schema" << endl;
         return 1;
     }
 
-    // check output file
+    // check output
+    XercesDOMParser domParser(0, XMLPlatformUtils::fgMemoryManager, pool);
     domParser.setValidationScheme(XercesDOMParser::Val_Auto);
     domParser.setDoNamespaces(true);
     domParser.setDoSchema(true);
     domParser.setValidationConstraintFatal(true);
+    domParser.useCachedGrammarInParse(true);
 
-    domParser.parse(xml_file);
+    MemBufInputSource source((const XMLByte*)xodr.data(), xodr.size(), "output");
+    domParser.parse(source);
     if (domParser.getErrorCount() == 0){
         if(!setting.silentMode)
             cout << "XML output file validated against the schema successfully" << endl;
@@ -111,6 +110,40 @@ int validateOutput(roadNetwork &data)
     return 0;
 }
 
+/**
+ * @brief function writes the generated document to the output file
+ * 
+ * @param outputFile    output file without extension
+ * @param xodr          generated OpenDRIVE document
+ * @return int          error code
+ */
+int writeOutput(const string &outputFile, const string &xodr)
+{
+    string file = outputFile + ".xodr";
+
+    ofstream out(file.c_str(), ios::out | ios::binary);
+    if (!out.is_open())
+    {
+        cerr << "ERR: output file " << file << " can not be written" << endl;
+        return 1;
+    }
+    out.write(xodr.data(), xodr.size());
+
+    return out.good() ? 0 : 1;
+}
+
+/**
+ * @brief function writes the generated document to the output file
+ * 
+ * @param data  output data containing the output file name
+ * @param xodr  generated OpenDRIVE document
+ * @return int  error code
+ */
+int writeOutput(roadNetwork &data, const string &xodr)
+{
+    return writeOutput(data.outputFile, xodr);
+}
+
 
 /**
  * @brief helper function to append the link node to road node
@@ -147,7 +180,14 @@ void appendLinkToNodeXercesC(nodeElement road, link &successor, link &predecesso
 }
 
 
-int createXMLXercesC(roadNetwork &data)
+/**
+ * @brief function generates the OpenDRIVE document of the road network
+ * 
+ * @param data  road network data
+ * @param xodr  resulting document
+ * @return int  error code
+ */
+int createXMLXercesC(roadNetwork &data, string &xodr)
 {
 
     init("OpenDRIVE");
@@ -474,9 +514,389 @@ int createXMLXercesC(roadNetwork &data)
     }
 
 
-    serialize((data.outputFile + ".xodr").c_str());
+    return serializeToBuffer(xodr);
+}
 
-    return 0;
+/**
+ * @brief helper function to write the link element of a road with the streaming writer
+ * 
+ * @param w             streaming writer
+ * @param successor     the potential successor to the road segment
+ * @param predecessor   the potential predecessor to the road segment
+ */
+void writeLinkStream(xodrWriter &w, link &successor, link &predecessor)
+{
+    if (successor.id == -1 && predecessor.id == -1){
+        return;
+    }
+    w.beginElement("link");
+
+    if( predecessor.id != -1){
+        w.beginElement("predecessor");
+        w.attribute("elementId", predecessor.id);
+        w.attribute("elementType", getLinkType(predecessor.elementType));
+        if(predecessor.contactPoint != noneType)
+            w.attribute("contactPoint", getContactPointType(predecessor.contactPoint));
+        w.endElement();
+    }
+
+    if( successor.id != -1){
+        w.beginElement("successor");
+        w.attribute("elementId", successor.id);
+        w.attribute("elementType", getLinkType(successor.elementType));
+        if(successor.contactPoint != noneType)
+            w.attribute("contactPoint", getContactPointType(successor.contactPoint));
+        w.endElement();
+    }
+
+    w.endElement();
+}
+
+/**
+ * @brief function writes the OpenDRIVE document of the road network with the streaming writer.
+ * The element structure is the same as in createXMLXercesC, but no DOM is built
+ * 
+ * @param data  road network data
+ * @param w     streaming writer
+ * @return int  error code
+ */
+int createXMLStream(roadNetwork &data, xodrWriter &w)
+{
+    w.declaration();
+    w.beginElement("OpenDRIVE");
+
+    w.beginElement("header");
+    w.attribute("revMajor", to_string(setting.versionMajor));
+    w.attribute("revMinor", to_string(setting.versionMinor));
+    w.attribute("north", to_string(setting.north));
+    w.attribute("south", to_string(setting.south));
+    w.attribute("west", to_string(setting.west));
+    w.attribute("east", to_string(setting.east));
+
+    // geoReference tag
+    w.beginElement("geoReference");
+    w.cdata("+proj=utm +zone=32 +ellps=WGS84 +datum=WGS84 +units=m +no_defs");
+    w.endElement();
+
+    w.endElement();
+
+    // --- write roads ---------------------------------------------------------
+    for (std::vector<road>::iterator it = data.roads.begin(); it != data.roads.end(); ++it)
+    {
+        w.beginElement("road");
+        w.attribute("id", it->id);
+        w.attribute("length", it->length);
+
+        //it has to be checked if it is a connecting road, since the junction attribute is missused as the original ID for connecting roads.
+        w.attribute("junction" ,(it->isConnectingRoad) ? -1 : it->junction);
+        writeLinkStream(w, it->successor, it->predecessor);
+
+        w.beginElement("type");
+        w.attribute("s", 0);
+        w.attribute("type", it->type);
+        w.endElement();
+
+        // --- write geometries ------------------------------------------------
+        w.beginElement("planView");
+
+        for (std::vector<geometry>::iterator itt = it->geometries.begin(); itt != it->geometries.end(); ++itt)
+        {
+            w.beginElement("geometry");
+            w.attribute("s", itt->s);
+            w.attribute("x", itt->x);
+            w.attribute("y", itt->y);
+            w.attribute("hdg", itt->hdg);
+            w.attribute("length", itt->length);
+
+            if (itt->type == line)
+            {
+                w.beginElement("line");
+                w.endElement();
+            }
+            if (itt->type == arc)
+            {
+                w.beginElement("arc");
+                w.attribute("curvature", itt->c);
+                w.endElement();
+            }
+            if (itt->type == spiral)
+            {
+                w.beginElement("spiral");
+                w.attribute("curvStart", itt->c1);
+                w.attribute("curvEnd", itt->c2);
+                w.endElement();
+            }
+            w.endElement();
+        }
+        w.endElement();
+
+        // --- write lanes -----------------------------------------------------
+        w.beginElement("lanes");
+
+        for (std::vector<laneSection>::iterator itt = it->laneSections.begin(); itt != it->laneSections.end(); ++itt)
+        {
+            w.beginElement("laneOffset");
+            w.attribute("s", itt->s);
+            w.attribute("a", itt->o.a);
+            w.attribute("b", itt->o.b);
+            w.attribute("c", itt->o.c);
+            w.attribute("d", itt->o.d);
+            w.endElement();
+        }
+
+        for (std::vector<laneSection>::iterator itt = it->laneSections.begin(); itt != it->laneSections.end(); ++itt)
+        {
+            w.beginElement("laneSection");
+            w.attribute("s", itt->s);
+
+            std::sort(itt->lanes.begin(), itt->lanes.end(), compareLanes);
+
+            // lanes are sorted by id, so left, center and right are written in this order
+            bool hasLeft = findMaxLaneId(*itt) > 0;
+            bool hasRight = findMinLaneId(*itt) < 0;
+
+            for (int side = 1; side >= -1; side--)
+            {
+                if ((side == 1 && !hasLeft) || (side == -1 && !hasRight))
+                    continue;
+
+                w.beginElement((side == 1) ? "left" : (side == 0) ? "center" : "right");
+
+                for (std::vector<lane>::iterator ittt = itt->lanes.begin(); ittt != itt->lanes.end(); ++ittt)
+                {
+                    if (sgn(ittt->id) != side)
+                        continue;
+
+                    w.beginElement("lane");
+                    w.attribute("id", ittt->id);
+                    w.attribute("type", ittt->type);
+
+                    if (ittt->id != 0)
+                    {
+                        w.beginElement("link");
+                        if (ittt->preId != 0)
+                        {
+                            w.beginElement("predecessor");
+                            w.attribute("id", ittt->preId);
+                            w.endElement();
+                        }
+                        if (ittt->sucId != 0)
+                        {
+                            w.beginElement("successor");
+                            w.attribute("id", ittt->sucId);
+                            w.endElement();
+                        }
+                        w.endElement();
+
+                        w.beginElement("width");
+                        w.attribute("sOffset", ittt->w.s);
+                        w.attribute("a", ittt->w.a);
+                        w.attribute("b", ittt->w.b);
+                        w.attribute("c", ittt->w.c);
+                        w.attribute("d", ittt->w.d);
+                        w.endElement();
+                    }
+
+                    w.beginElement("roadMark");
+                    w.attribute("sOffset", ittt->rm.s);
+                    w.attribute("type", ittt->rm.type);
+                    w.attribute("weight", ittt->rm.weight);
+                    w.attribute("color", ittt->rm.color);
+                    w.attribute("width", ittt->rm.width);
+                    w.endElement();
+
+                    if (ittt->id != 0)
+                    {
+                        w.beginElement("material");
+                        w.attribute("sOffset", ittt->m.s);
+                        w.attribute("surface", ittt->m.surface);
+                        w.attribute("friction", ittt->m.friction);
+                        w.attribute("roughness", ittt->m.roughness);
+                        w.endElement();
+
+                        w.beginElement("speed");
+                        w.attribute("sOffset", 0);
+                        w.attribute("max", ittt->speed);
+                        w.endElement();
+                    }
+                    w.endElement();
+                }
+                w.endElement();
+            }
+            w.endElement();
+        }
+        w.endElement();
+
+        //write objects
+        w.beginElement("objects");
+
+        std::sort(it->objects.begin(), it->objects.end(), compareObjects);
+        for (std::vector<object>::iterator itt = it->objects.begin(); itt != it->objects.end(); ++itt)
+        {
+            object &o = *itt;
+            w.beginElement("object");
+            w.attribute("type", o.type);
+            w.attribute("name", o.type);
+            w.attribute("dynamic", "no");
+            w.attribute("id", o.id);
+            w.attribute("s", o.s);
+            w.attribute("t", o.t);
+            w.attribute("zOffset", o.z);
+            w.attribute("hdg", o.hdg);
+            w.attribute("pitch", 0);
+            w.attribute("roll", 0);
+            w.attribute("validLength", 0);
+            w.attribute("orientation", o.orientation);
+            w.attribute("length", o.length);
+            w.attribute("width", o.width);
+            w.attribute("height", o.height);
+
+            if (o.repeat)
+            {
+                w.beginElement("repeat");
+                w.attribute("s", o.s);
+                w.attribute("length", o.len);
+                w.attribute("distance", o.distance);
+                w.attribute("tStart", o.t);
+                w.attribute("tEnd", o.t);
+                w.attribute("widthStart", o.width);
+                w.attribute("widthEnd", o.width);
+                w.attribute("heightStart", o.height);
+                w.attribute("heightEnd", o.height);
+                w.attribute("zOffsetStart", o.z);
+                w.attribute("zOffsetEnd", o.z);
+                w.attribute("lengthStart", o.length);
+                w.attribute("lengthEnd", o.length);
+                w.endElement();
+            }
+            w.endElement();
+        }
+        w.endElement();
+
+        // --- write signs ---------------------------------------------------
+
+        // signs format is different in version 1.4
+        if (setting.versionMajor >= 1 && setting.versionMinor >= 5)
+        {
+            w.beginElement("signals");
+
+            std::sort(it->signs.begin(), it->signs.end(), compareSignals);
+            for (std::vector<sign>::iterator itt = it->signs.begin(); itt != it->signs.end(); ++itt)
+            {
+                sign &s = *itt;
+                w.beginElement("signal");
+                w.attribute("id", s.id);
+                w.attribute("name", s.type);
+                w.attribute("type", s.type);
+                w.attribute("subtype", s.subtype);
+                w.attribute("country", s.country);
+                w.attribute("s", s.s);
+                w.attribute("t", s.t);
+                w.attribute("zOffset", s.z);
+                w.attribute("orientation", s.orientation);
+                w.attribute("dynamic", (s.dynamic) ? "yes" : "no");
+                w.attribute("value", s.value);
+                w.attribute("width", s.width);
+                w.attribute("height", s.height);
+                w.endElement();
+            }
+            w.endElement();
+        }
+        w.endElement();
+    }
+
+    // --- write controllers ---------------------------------------------------
+
+    // controllers format is different in version 1.4
+    if (setting.versionMajor >= 1 && setting.versionMinor >= 5)
+    {
+        for (std::vector<control>::iterator it = data.controller.begin(); it != data.controller.end(); ++it)
+        {
+            w.beginElement("controller");
+            w.attribute("id", it->id);
+
+            for (std::vector<sign>::iterator itt = it->signs.begin(); itt != it->signs.end(); ++itt)
+            {
+                w.beginElement("control");
+                w.attribute("signalId", itt->id);
+                w.endElement();
+            }
+            w.endElement();
+        }
+    }
+
+    // --- write junctions -----------------------------------------------------
+    for (std::vector<junction>::iterator it = data.junctions.begin(); it != data.junctions.end(); ++it)
+    {
+        w.beginElement("junction");
+        w.attribute("id", it->id);
+
+        for (std::vector<connection>::iterator itt = it->connections.begin(); itt != it->connections.end(); ++itt)
+        {
+            w.beginElement("connection");
+            w.attribute("id", itt->id);
+            w.attribute("incomingRoad", itt->from);
+            w.attribute("connectingRoad", itt->to);
+            w.attribute("contactPoint", getContactPointType(itt->contactPoint));
+
+            w.beginElement("laneLink");
+            w.attribute("from", itt->fromLane);
+            w.attribute("to", itt->toLane);
+            w.endElement();
+
+            w.endElement();
+        }
+        w.endElement();
+    }
+
+    // --- write junction groups -----------------------------------------------------
+    for (std::vector<junctionGroup>::iterator it = data.juncGroups.begin(); it != data.juncGroups.end(); ++it)
+    {
+        w.beginElement("junctionGroup");
+        w.attribute("id", it->id);
+        w.attribute("name", it->name);
+        w.attribute("type", (it->type == roundaboutType) ? "roundabout" : "unknown");
+
+        for (std::vector<int>::iterator itt = it->juncIds.begin(); itt != it->juncIds.end(); ++itt)
+        {
+            w.beginElement("junctionReference");
+            w.attribute("junction", *itt);
+            w.endElement();
+        }
+        w.endElement();
+    }
+
+    w.endElement();
+
+    return w.flush();
+}
+
+/**
+ * @brief function writes the OpenDRIVE document of the road network with the streaming writer directly to the output file
+ * 
+ * @param data  road network data
+ * @return int  error code
+ */
+int createXMLStreamToFile(roadNetwork &data)
+{
+    string file = data.outputFile + ".xodr";
+
+    FILE *f = fopen(file.c_str(), "wb");
+    if (f == NULL)
+    {
+        cerr << "ERR: output file " << file << " can not be written" << endl;
+        return 1;
+    }
+
+    int errorCode;
+    {
+        xodrWriter w(f);
+        errorCode = createXMLStream(data, w);
+        if (w.failed()) errorCode = 1;
+    }
+
+    if (fclose(f) != 0) errorCode = 1;
+    return errorCode;
 }
 
 /**
@@ -22,18 +22,137 @@
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/util/OutOfMemoryException.hpp>
 #include <xercesc/framework/LocalFileFormatTarget.hpp>
+#include <xercesc/framework/MemBufFormatTarget.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/dom/DOMCDATASection.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/framework/XMLGrammarPool.hpp>
+#include <xercesc/internal/XMLGrammarPoolImpl.hpp>
+#include <xercesc/validators/common/Grammar.hpp>
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <vector>
+#include <algorithm>
 
 using namespace XERCES_CPP_NAMESPACE;
 using namespace std;
 
+// the output document is built per thread, so every pipeline run owns its own document
+thread_local DOMImplementation* impl = NULL;
+thread_local DOMDocument* doc = NULL;
 
-DOMImplementation* impl;
-DOMDocument* doc;
+std::atomic<bool> initialized(false);
+std::mutex xercesInitMutex;
 
-bool initialized = false;
+/**
+ * @brief initializes the xerces platform exactly once per process. Safe to call from concurrent pipeline runs.
+ * 
+ * @return int error code
+ */
+int initializeXerces()
+{
+    if (initialized) return 0;
+
+    std::lock_guard<std::mutex> lock(xercesInitMutex);
+    if (initialized) return 0;
+
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch(const XMLException& toCatch)
+    {
+        char *pMsg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during Xerces-c Initialization.\n"
+             << "  Exception message:"
+             << pMsg;
+        XMLString::release(&pMsg);
+        return 1;
+    }
+    initialized = true;
+    return 0;
+}
+
+// process wide cache of preparsed schemas. Every schema gets its own locked pool, since input.xsd and output.xsd share the empty namespace
+std::map<string, XMLGrammarPool*> grammarPools;
+std::mutex grammarPoolMutex;
+
+/**
+ * @brief creates a validating parser. If a grammar pool is given the cached grammar is used instead of loading the schema again
+ * 
+ * @param pool  grammar pool with the preparsed schema, can be NULL
+ * @return XercesDOMParser* new parser
+ */
+XercesDOMParser* createValidatingParser(XMLGrammarPool *pool)
+{
+    XercesDOMParser *parser = new XercesDOMParser(0, XMLPlatformUtils::fgMemoryManager, pool);
+    parser->setValidationScheme(XercesDOMParser::Val_Auto);
+    parser->setDoNamespaces(true);
+    parser->setDoSchema(true);
+    parser->setValidationConstraintFatal(true);
+    if (pool != NULL)
+        parser->useCachedGrammarInParse(true);
+    return parser;
+}
+
+/**
+ * @brief returns the grammar pool of a schema. The schema is parsed only on the first call,
+ * afterwards the pool is locked and shared read only between all runs and threads
+ * 
+ * @param schemaFile    path of the xsd file
+ * @return XMLGrammarPool* pool containing the schema. NULL if the schema couldn't be loaded
+ */
+XMLGrammarPool* getGrammarPool(const char *schemaFile)
+{
+    if (initializeXerces()) return NULL;
+
+    std::lock_guard<std::mutex> lock(grammarPoolMutex);
+
+    std::map<string, XMLGrammarPool*>::iterator it = grammarPools.find(schemaFile);
+    if (it != grammarPools.end())
+        return it->second;
+
+    XMLGrammarPool *pool = new XMLGrammarPoolImpl(XMLPlatformUtils::fgMemoryManager);
+    XercesDOMParser *parser = createValidatingParser(pool);
+
+    Grammar *grammar = NULL;
+    try
+    {
+        grammar = parser->loadGrammar(schemaFile, Grammar::SchemaGrammarType, true);
+    }
+    catch (...)
+    {
+        grammar = NULL;
+    }
+    delete parser;
+
+    if (grammar == NULL)
+    {
+        delete pool;
+        return NULL;
+    }
+
+    pool->lockPool();
+    grammarPools[schemaFile] = pool;
+    return pool;
+}
+
+/**
+ * @brief releases all cached grammars
+ * 
+ */
+void clearGrammarPools()
+{
+    std::lock_guard<std::mutex> lock(grammarPoolMutex);
+    for (std::map<string, XMLGrammarPool*>::iterator it = grammarPools.begin(); it != grammarPools.end(); ++it)
+    {
+        it->second->unlockPool();
+        delete it->second;
+    }
+    grammarPools.clear();
+}
 
 
 
@@ -107,22 +226,15 @@ private :
 struct xmlTree{
 
     private:
-        XercesDOMParser *parser;
-        DOMDocument *doc;
+        XercesDOMParser *parser = NULL;
+        DOMDocument *doc = NULL;
 
     public:
 
         xmlTree(){
             try{
-                if(!initialized){
-                    XMLPlatformUtils::Initialize();
-                    initialized = true;
-                }
-                parser = new XercesDOMParser;
-                parser->setValidationScheme(XercesDOMParser::Val_Auto);
-                parser->setDoNamespaces(true);
-                parser->setDoSchema(true);
-                parser->setValidationConstraintFatal(true);
+                if (initializeXerces()) return;
+                parser = createValidatingParser(NULL);
                 
             }
             catch(const XMLException &toCatch)
@@ -171,6 +283,29 @@ struct xmlTree{
             return 0;
         }
 
+        /**
+         * @brief parses a document from memory
+         * 
+         * @param buffer    xml document
+         * @param bufferId  name of the document used in error messages
+         * @return int      error code
+         */
+        int parseBuffer(const string &buffer, const char* bufferId)
+        {
+            try
+            {
+                MemBufInputSource source((const XMLByte*)buffer.data(), buffer.size(), bufferId);
+                parser->parse(source);
+                doc = parser->getDocument();
+            }
+            catch (...)
+            {
+                std::cerr << "An error occurred during parsing\n " << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+
         int getErrorCount()
         {
             return parser->getErrorCount();
@@ -204,14 +339,27 @@ struct xmlTree{
         }
 
 
-        xercesc_3_2::Grammar *loadGrammar(const char *const schema_file)
+        /**
+         * @brief sets up the parser to validate against the given schema. The schema is taken from the grammar cache
+         * 
+         * @param schema_file path of the xsd file
+         * @return int error code
+         */
+        int loadGrammar(const char *const schema_file)
         {
-            return parser->loadGrammar(schema_file, Grammar::SchemaGrammarType);
+            XMLGrammarPool *pool = getGrammarPool(schema_file);
+            if (pool == NULL)
+                return 1;
+
+            delete parser;
+            parser = createValidatingParser(pool);
+            return 0;
         }
 
         ~xmlTree()
         {
-            //delete parser;
+            // the parser owns the parsed document
+            delete parser;
         }
 
 };
@@ -321,8 +469,26 @@ DOMElement* getNextSiblingWithTagName(DOMElement* elem, const char* tag)
 } 
 
 
+/**
+ * @brief returns the next element of a subtree in document order (preorder)
+ * 
+ * @param cur current element
+ * @param root root of the subtree
+ * @return const DOMElement* next element, NULL at the end of the subtree
+ */
+const DOMElement* nextElementInTree(const DOMElement* cur, const DOMElement* root)
+{
+    if (cur->getFirstElementChild() != NULL)
+        return cur->getFirstElementChild();
+
+    while (cur != root && cur->getNextElementSibling() == NULL)
+        cur = (const DOMElement*)cur->getParentNode();
+    return (cur == root) ? NULL : cur->getNextElementSibling();
+}
+
     /**
-     * @brief looks for the first node that with matching name in the xml document
+     * @brief looks for the first node that with matching name in the xml document.
+     * The tree is only read, so that multiple threads can search the same document
      * 
      * @param childName name too look for
      * @param res return Element
@@ -331,20 +497,14 @@ DOMElement* getNextSiblingWithTagName(DOMElement* elem, const char* tag)
     DOMElement* getChildWithName(const DOMElement* node, const char *childName)
     {
         if (node == NULL) return NULL;
-        DOMElement* res = NULL;
 
-        //DOMNodeList * nodelist = (DOMNodeList*)malloc( 0); //this fixes the memory corruption bug that can occur but introduces memory leak beacuse the pointer will be changed
-        DOMNodeList* nodelist = node->getElementsByTagName(X(childName)); //This might cause memory corruption due to a bug with xercesC. It seems solved
-        
-        for(int i = 0; i < nodelist->getLength(); i++)
+        XStr name(childName);
+        for (const DOMElement* cur = node->getFirstElementChild(); cur != NULL; cur = nextElementInTree(cur, node))
         {
-            if(!XMLString::compareString(X(childName), nodelist->item(i)->getNodeName()))
-            {
-                res = (DOMElement*) nodelist->item(0);
-                break;
-            }
+            if(!XMLString::compareString(name.unicodeForm(), cur->getTagName()))
+                return (DOMElement*) cur;
         }
-        return res;
+        return NULL;
     }
 
     /**
@@ -387,6 +547,47 @@ string readAttributeFromChildren(DOMElement *node, const char* firstchild, const
 }
 
 
+/**
+ * @brief function appends a normalized form of a tree to a key. Attributes are sorted by name, whitespace, comments, text and schema attributes are ignored
+ *
+ * @param node      root of the tree
+ * @param key       key the tree is appended to
+ * @param ignore    attribute of the root which is ignored
+ */
+void appendNormalizedTree(const DOMElement *node, string &key, const string &ignore = "")
+{
+    key += "<" + readNameFromNode(node);
+
+    vector<pair<string, string>> attributes;
+    DOMNamedNodeMap *attrMap = node->getAttributes();
+    for (XMLSize_t i = 0; i < attrMap->getLength(); i++)
+    {
+        DOMAttr *attr = (DOMAttr*)attrMap->item(i);
+
+        char *c_name = XMLString::transcode(attr->getName());
+        char *c_value = XMLString::transcode(attr->getValue());
+        string name(c_name);
+        string value(c_value);
+        XMLString::release(&c_name);
+        XMLString::release(&c_value);
+
+        // namespace declarations and schema locations do not change the network
+        if (name.compare(0, 5, "xmlns") == 0 || name.compare(0, 4, "xsi:") == 0 || name == ignore)
+            continue;
+        attributes.push_back(make_pair(name, value));
+    }
+    sort(attributes.begin(), attributes.end());
+
+    // values are prefixed with their length, so that no escaping is needed
+    for (const pair<string, string> &a : attributes)
+        key += " " + a.first + "=" + to_string(a.second.size()) + ":" + a.second;
+    key += ">";
+
+    for (const DOMElement *it = node->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        appendNormalizedTree(it, key);
+
+    key += "</>";
+}
 
 //code for creating a xml document
 
@@ -590,20 +791,8 @@ int generateCDATA(const char* data, DOMCDATASection **res)
 int init(const char *rootNode)
 {
     int errorCode = 0;
- try
-    {
-        if(!initialized)
-            XMLPlatformUtils::Initialize();
-    }
-    catch(const XMLException& toCatch)
-    {
-        char *pMsg = XMLString::transcode(toCatch.getMessage());
-        std::cerr << "Error during Xerces-c Initialization.\n"
-             << "  Exception message:"
-             << pMsg;
-        XMLString::release(&pMsg);
+    if (initializeXerces())
         return 1;
-    }
 
     impl =  DOMImplementationRegistry::getDOMImplementation(X("Core"));
 
@@ -634,38 +823,67 @@ int init(const char *rootNode)
         }
     }
 
-    initialized = true;
     return 0;
 }
 
-int serialize(const char* outname)
+/**
+ * @brief writes the current document to a format target and releases the document
+ * 
+ * @param target    format target the document is written to
+ * @return int      error code
+ */
+int serializeToTarget(XMLFormatTarget *target)
 {
     DOMLSSerializer * theSerializer = impl->createLSSerializer();
 
     DOMLSOutput       *theOutputDesc = ((DOMImplementationLS*)impl)->createLSOutput();
-    XMLFormatTarget *myFormTarget  = new LocalFileFormatTarget(XMLString::transcode(outname));
-    theOutputDesc->setByteStream(myFormTarget);
-    theOutputDesc->setEncoding(XMLString::transcode("ISO-8859-1"));
+    theOutputDesc->setByteStream(target);
+    XStr encoding("ISO-8859-1"); // the output only keeps a pointer to the encoding
+    theOutputDesc->setEncoding(encoding.unicodeForm());
 
     theSerializer->getDomConfig()->setParameter(XMLUni::fgDOMXMLDeclaration, true);
 
     theSerializer->getDomConfig()->setParameter(XMLUni::fgDOMWRTFormatPrettyPrint, true);
     theSerializer->write(doc, theOutputDesc);
 
-    myFormTarget->flush();
-
-    delete myFormTarget;
+    target->flush();
 
     theOutputDesc->release();
     theSerializer->release();
 
     doc->release();
+    doc = NULL;
 
     return 0;
 }
 
+int serialize(const char* outname)
+{
+    XMLFormatTarget *myFormTarget  = new LocalFileFormatTarget(outname);
+    int errorCode = serializeToTarget(myFormTarget);
+    delete myFormTarget;
+
+    return errorCode;
+}
+
+/**
+ * @brief writes the current document to a memory buffer and releases the document
+ * 
+ * @param buffer    resulting document
+ * @return int      error code
+ */
+int serializeToBuffer(string &buffer)
+{
+    MemBufFormatTarget myFormTarget;
+    int errorCode = serializeToTarget(&myFormTarget);
+    buffer.assign((const char*)myFormTarget.getRawBuffer(), myFormTarget.getLen());
+
+    return errorCode;
+}
+
 int terminateParser()
 {
+    clearGrammarPools();
     XMLPlatformUtils::Terminate();
     return 0;
 
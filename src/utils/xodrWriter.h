@@ -0,0 +1,264 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file xodrWriter.h
+ *
+ * @brief This file contains a streaming xml writer which writes the output without building a DOM
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief function formats a double with the shortest representation (up to 17 significant digits) that reads back to the same value
+ *
+ * @param value     value to format
+ * @param buf       output buffer, at least 32 chars
+ * @return int      length of the formatted string
+ */
+int formatDouble(double value, char *buf)
+{
+    int len = snprintf(buf, 32, "%.15g", value);
+    if (strtod(buf, NULL) == value) return len;
+
+    len = snprintf(buf, 32, "%.16g", value);
+    if (strtod(buf, NULL) == value) return len;
+
+    return snprintf(buf, 32, "%.17g", value);
+}
+
+/**
+ * @brief streaming xml writer. The output is either collected in a string or written to a file in chunks.
+ * The layout matches the pretty print of the xerces serializer: attributes are sorted by name,
+ * children of the root element are separated by an empty line
+ *
+ */
+class xodrWriter
+{
+public:
+
+    /**
+     * @brief writer with memory sink
+     *
+     * @param buffer    string the document is appended to
+     */
+    xodrWriter(std::string &buffer) : mem(&buffer), file(NULL)
+    {
+    }
+
+    /**
+     * @brief writer with file sink
+     *
+     * @param f     opened output file
+     */
+    xodrWriter(FILE *f) : mem(NULL), file(f)
+    {
+        chunk.reserve(chunkSize);
+    }
+
+    ~xodrWriter()
+    {
+        flush();
+    }
+
+    void declaration()
+    {
+        out().append("<?xml version=\"1.0\" encoding=\"ISO-8859-1\" standalone=\"no\" ?>\n");
+    }
+
+    void beginElement(const char *name)
+    {
+        if (!stack.empty())
+        {
+            closeStartTag();
+            stack.back().hasChildren = true;
+        }
+
+        std::string &o = out();
+        if (stack.size() == 1) o.append("\n");
+        if (!stack.empty())
+        {
+            o.append("\n");
+            o.append(2 * stack.size(), ' ');
+        }
+        o.append("<");
+        o.append(name);
+
+        element e;
+        e.name = name;
+        stack.push_back(e);
+        startOpen = true;
+    }
+
+    void attribute(const char *key, const std::string &value)
+    {
+        attrs.push_back(std::make_pair(key, value));
+    }
+
+    void attribute(const char *key, const char *value)
+    {
+        attrs.push_back(std::make_pair(key, std::string(value)));
+    }
+
+    void attribute(const char *key, int value)
+    {
+        char buf[16];
+        int len = snprintf(buf, sizeof(buf), "%d", value);
+        attrs.push_back(std::make_pair(key, std::string(buf, len)));
+    }
+
+    void attribute(const char *key, double value)
+    {
+        char buf[32];
+        int len = formatDouble(value, buf);
+        attrs.push_back(std::make_pair(key, std::string(buf, len)));
+    }
+
+    void cdata(const char *text)
+    {
+        closeStartTag();
+        stack.back().hasText = true;
+        std::string &o = out();
+        o.append("<![CDATA[");
+        o.append(text);
+        o.append("]]>");
+    }
+
+    void endElement()
+    {
+        element e = stack.back();
+        if (startOpen && !e.hasChildren && !e.hasText)
+        {
+            writeAttributes();
+            out().append("/>");
+            startOpen = false;
+        }
+        else
+        {
+            closeStartTag();
+            std::string &o = out();
+            if (e.hasChildren)
+            {
+                o.append("\n");
+                if (stack.size() == 1) o.append("\n");
+                o.append(2 * (stack.size() - 1), ' ');
+            }
+            o.append("</");
+            o.append(e.name);
+            o.append(">");
+        }
+        stack.pop_back();
+
+        if (stack.empty())
+            out().append("\n");
+
+        if (file != NULL && chunk.size() >= chunkSize)
+            flush();
+    }
+
+    /**
+     * @brief writes the buffered data to the file sink
+     *
+     * @return int error code
+     */
+    int flush()
+    {
+        if (file == NULL || chunk.empty()) return 0;
+
+        size_t n = fwrite(chunk.data(), 1, chunk.size(), file);
+        bool ok = (n == chunk.size());
+        chunk.clear();
+        if (!ok) error = true;
+        return ok ? 0 : 1;
+    }
+
+    bool failed() const
+    {
+        return error;
+    }
+
+private:
+
+    struct element
+    {
+        const char *name;
+        bool hasChildren = false;
+        bool hasText = false;
+    };
+
+    static const size_t chunkSize = 1 << 16;
+
+    std::string *mem;
+    FILE *file;
+    std::string chunk;
+    bool error = false;
+
+    std::vector<element> stack;
+    std::vector<std::pair<const char*, std::string> > attrs;
+    bool startOpen = false;
+
+    std::string &out()
+    {
+        return (mem != NULL) ? *mem : chunk;
+    }
+
+    static bool compareAttributes(const std::pair<const char*, std::string> &a, const std::pair<const char*, std::string> &b)
+    {
+        return strcmp(a.first, b.first) < 0;
+    }
+
+    void writeAttributes()
+    {
+        std::stable_sort(attrs.begin(), attrs.end(), compareAttributes);
+
+        std::string &o = out();
+        for (size_t k = 0; k < attrs.size(); k++)
+        {
+            o.append(" ");
+            o.append(attrs[k].first);
+            o.append("=\"");
+            escape(attrs[k].second, o);
+            o.append("\"");
+        }
+        attrs.clear();
+    }
+
+    void closeStartTag()
+    {
+        if (!startOpen) return;
+        writeAttributes();
+        out().append(">");
+        startOpen = false;
+    }
+
+    static void escape(const std::string &value, std::string &o)
+    {
+        for (size_t k = 0; k < value.size(); k++)
+        {
+            char c = value[k];
+            switch (c)
+            {
+                case '&': o.append("&amp;"); break;
+                case '<': o.append("&lt;"); break;
+                case '>': o.append("&gt;"); break;
+                case '"': o.append("&quot;"); break;
+                default: o.push_back(c);
+            }
+        }
+    }
+};
@@ -0,0 +1,108 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file fresnelAccuracy.cpp
+ *
+ * @brief This file compares the fresnel integrals of curve.h with high precision reference values.
+ * The references were computed with 200 digit arithmetic, using the power series for s <= 10 and the asymptotic series for s = 100
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+#include "utils/settings.h"
+thread_local settings setting;
+#include "utils/interface.h"
+
+// defined in helper.h, which depends on xerces
+int sgn(double d)
+{
+    return (d > 0) - (d < 0);
+}
+
+#include "utils/curve.h"
+
+struct fresnelReference
+{
+    double s;
+    double C;
+    double S;
+};
+
+const fresnelReference references[] = {
+    {0.5, 4.92344225871446392879e-1, 6.47324328599992776115e-2},
+    {1, 7.79893400376822829474e-1, 4.38259147390354766077e-1},
+    {2, 4.88253406075340754500e-1, 3.43415678363698242195e-1},
+    {3, 6.05720789297685629556e-1, 4.96312998967375036098e-1},
+    {10, 4.99898694205515723614e-1, 4.68169978584882240403e-1},
+    {100, 4.99999898678817897559e-1, 4.96816901147837553271e-1}};
+
+const double exactTolerance = 1e-14;
+const double fastTolerance = 1e-9; // documented accuracy of fresnelFast
+
+/**
+ * @brief function compares a fresnel implementation with the reference values, including the odd symmetry
+ *
+ * @param name      name of the implementation
+ * @param f         implementation
+ * @param tolerance allowed absolute error
+ * @return int      number of failed values
+ */
+int checkReferences(const string &name, int (*f)(double, double &, double &), double tolerance)
+{
+    int failed = 0;
+    for (const fresnelReference &r : references)
+    {
+        for (double sign : {1.0, -1.0})
+        {
+            double x, y;
+            f(sign * r.s, x, y);
+            double err = max(fabs(x - sign * r.C), fabs(y - sign * r.S));
+            bool ok = err <= tolerance;
+            printf("%-10s s = %7.1f  C = %.17g  S = %.17g  error = %.3g %s\n", name.c_str(), sign * r.s, x, y, err, ok ? "" : "FAILED");
+            failed += !ok;
+        }
+    }
+    return failed;
+}
+
+int main()
+{
+    int failed = 0;
+    failed += checkReferences("exact", fresnel, exactTolerance);
+    failed += checkReferences("tabulated", fresnelTabulated, fastTolerance);
+
+    // the table is only used for |s| <= 8, so a dense sweep against the exact tier covers all nodes and midpoints
+    double maxError = 0;
+    for (double s = -8.5; s <= 8.5; s += 1.0 / 4096 + 1e-7)
+    {
+        double x1, y1, x2, y2;
+        fresnel(s, x1, y1);
+        fresnelTabulated(s, x2, y2);
+        maxError = max(maxError, max(fabs(x1 - x2), fabs(y1 - y2)));
+    }
+    bool ok = maxError <= fastTolerance;
+    printf("tabulated vs exact on [-8.5, 8.5]: max error = %.3g %s\n", maxError, ok ? "" : "FAILED");
+    failed += !ok;
+
+    if (failed > 0)
+    {
+        cerr << "ERR: " << failed << " fresnel check(s) failed" << endl;
+        return 1;
+    }
+    return 0;
+}
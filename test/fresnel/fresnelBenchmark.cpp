@@ -0,0 +1,93 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file fresnelBenchmark.cpp
+ *
+ * @brief This file measures the run time of the exact and the tabulated fresnel integrals of curve.h
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+#include "utils/settings.h"
+thread_local settings setting;
+#include "utils/interface.h"
+
+// defined in helper.h, which depends on xerces
+int sgn(double d)
+{
+    return (d > 0) - (d < 0);
+}
+
+#include "utils/curve.h"
+
+/**
+ * @brief function measures the mean run time of a fresnel implementation
+ *
+ * @param f         implementation
+ * @param samples   arguments
+ * @param checksum  sum of all results, prevents that the calls are optimized away
+ * @return double   nanoseconds per call
+ */
+double measure(int (*f)(double, double &, double &), const vector<double> &samples, double &checksum)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (double s : samples)
+    {
+        double x, y;
+        f(s, x, y);
+        checksum += x + y;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / samples.size();
+}
+
+int main(int argc, char **argv)
+{
+    int count = (argc > 1) ? atoi(argv[1]) : 2000000;
+    if (count <= 0)
+    {
+        cerr << "ERR: number of samples has to be positive" << endl;
+        return 1;
+    }
+
+    // arguments within the range of the table, in a fixed pseudo random order
+    vector<double> samples(count);
+    unsigned int state = 1;
+    for (double &s : samples)
+    {
+        state = state * 1664525u + 1013904223u;
+        s = 8.0 * (state >> 8) / (1 << 24);
+    }
+
+    double checksum = 0;
+    // warm up, the table is created on the first call
+    measure(fresnel, samples, checksum);
+    measure(fresnelTabulated, samples, checksum);
+
+    double exact = measure(fresnel, samples, checksum);
+    double tabulated = measure(fresnelTabulated, samples, checksum);
+
+    printf("samples:   %d in [0, 8)\n", count);
+    printf("exact:     %.2f ns/call\n", exact);
+    printf("tabulated: %.2f ns/call\n", tabulated);
+    printf("speedup:   %.2f\n", exact / tabulated);
+    printf("checksum:  %.6f\n", checksum);
+    return 0;
+}
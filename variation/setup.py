@@ -13,11 +13,7 @@ setuptools.setup(
     long_description_content_type="text/markdown",
     url="https://gitlab.ika.rwth-aachen.de/dbecker/road-generation",
     packages=setuptools.find_packages(),
-    install_requires=[
-          'sympy',
-          'numexpr',
-          'numpy',
-    ],
+    install_requires=[],
     scripts=['bin/variation'],
     classifiers=[
         "Programming Language :: Python :: 3",